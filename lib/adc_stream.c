@@ -0,0 +1,306 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "adc_stream.h"
+
+typedef enum
+{
+    SLOT_FREE = 0,
+    SLOT_FILLING,
+    SLOT_READY,
+} slot_state_t;
+
+static adc_stream_block_t ring[ADC_STREAM_RING_BLOCKS];
+static volatile uint8_t slot_state[ADC_STREAM_RING_BLOCKS];
+
+// Fila dos blocos prontos, na ordem em que foram completados
+static uint8_t ready_q[ADC_STREAM_RING_BLOCKS];
+static volatile uint8_t ready_head;
+static volatile uint8_t ready_count;
+
+static int dma_ch[2] = {-1, -1};
+static uint8_t dma_slot[2];   // Bloco sendo escrito por cada canal DMA
+static bool active;
+static bool irq_installed;
+static uint prev_input;
+static uint32_t seq;
+static uint32_t block_us;     // Duração de um bloco
+static adc_stream_stats_t stats;
+
+static int find_free_slot(void)
+{
+    for (int i = 0; i < ADC_STREAM_RING_BLOCKS; i++)
+    {
+        if (slot_state[i] == SLOT_FREE)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void dma_irq_handler(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (dma_ch[i] < 0 || !dma_channel_get_irq1_status(dma_ch[i]))
+        {
+            continue;
+        }
+        dma_channel_acknowledge_irq1(dma_ch[i]);
+
+        // O outro canal já foi disparado pelo encadeamento; este só precisa de um novo destino
+        uint8_t done = dma_slot[i];
+        ring[done].seq = seq++;
+        ring[done].t_first_us = time_us_64() - block_us;
+        stats.blocks++;
+
+        int next = find_free_slot();
+        if (next >= 0)
+        {
+            slot_state[done] = SLOT_READY;
+            ready_q[(ready_head + ready_count) % ADC_STREAM_RING_BLOCKS] = done;
+            ready_count++;
+            slot_state[next] = SLOT_FILLING;
+            dma_slot[i] = next;
+        }
+        else
+        {
+            // Consumidor atrasado: descarta o bloco recém-completado e reescreve o mesmo
+            stats.dropped++;
+        }
+        dma_channel_set_write_addr(dma_ch[i], ring[dma_slot[i]].samples, false);
+    }
+}
+
+static void release_dma(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (dma_ch[i] >= 0)
+        {
+            dma_channel_unclaim(dma_ch[i]);
+            dma_ch[i] = -1;
+        }
+    }
+}
+
+bool adc_stream_start(uint32_t input_mask, uint32_t rate_hz)
+{
+    uint32_t n = __builtin_popcount(input_mask & 0x1F);
+    if (active || n == 0 || (input_mask & ~0x1Fu) || rate_hz > ADC_STREAM_TOTAL_MAX_HZ || rate_hz * n < ADC_STREAM_TOTAL_MIN_HZ ||
+        rate_hz * n > ADC_STREAM_TOTAL_MAX_HZ)
+    {
+        return false;
+    }
+
+    dma_ch[0] = dma_claim_unused_channel(false);
+    dma_ch[1] = dma_claim_unused_channel(false);
+    if (dma_ch[0] < 0 || dma_ch[1] < 0)
+    {
+        release_dma();
+        return false;
+    }
+
+    if (!irq_installed)
+    {
+        irq_add_shared_handler(DMA_IRQ_1, dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_1, true);
+        irq_installed = true;
+    }
+
+    memset((void *)slot_state, SLOT_FREE, sizeof(slot_state));
+    ready_head = 0;
+    ready_count = 0;
+    seq = 0;
+    block_us = (uint32_t)((uint64_t)ADC_STREAM_BLOCK_SAMPLES * 1000000 / (rate_hz * n));
+    stats = (adc_stream_stats_t){.input_mask = input_mask, .rate_hz = rate_hz};
+
+    for (uint32_t in = 0; in < 4; in++)
+    {
+        if (input_mask & (1u << in))
+        {
+            adc_gpio_init(26 + in);
+        }
+    }
+
+    // A primeira conversão usa a entrada selecionada; o rodízio segue a partir dela
+    prev_input = adc_get_selected_input();
+    adc_select_input(__builtin_ctz(input_mask));
+    adc_set_round_robin(input_mask);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv((float)clock_get_hz(clk_adc) / (rate_hz * n) - 1.0f);
+
+    // Dois canais encadeados um ao outro: enquanto um enche o seu bloco, o outro está armado
+    for (int i = 0; i < 2; i++)
+    {
+        dma_slot[i] = i;
+        slot_state[i] = SLOT_FILLING;
+        dma_channel_config c = dma_channel_get_default_config(dma_ch[i]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, DREQ_ADC);
+        channel_config_set_chain_to(&c, dma_ch[i ^ 1]);
+        dma_channel_configure(dma_ch[i], &c, ring[i].samples, &adc_hw->fifo, ADC_STREAM_BLOCK_SAMPLES, false);
+        dma_channel_set_irq1_enabled(dma_ch[i], true);
+    }
+
+    active = true;
+    dma_channel_start(dma_ch[0]);
+    adc_run(true);
+    return true;
+}
+
+void adc_stream_stop(void)
+{
+    if (!active)
+    {
+        return;
+    }
+
+    adc_run(false);
+    for (int i = 0; i < 2; i++)
+    {
+        // Desfaz o encadeamento e desliga a interrupção antes de abortar
+        dma_channel_config c = dma_get_channel_config(dma_ch[i]);
+        channel_config_set_chain_to(&c, dma_ch[i]);
+        dma_channel_set_config(dma_ch[i], &c, false);
+        dma_channel_set_irq1_enabled(dma_ch[i], false);
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        dma_channel_abort(dma_ch[i]);
+        dma_channel_acknowledge_irq1(dma_ch[i]);
+    }
+    release_dma();
+
+    adc_fifo_setup(false, false, 0, false, false);
+    adc_fifo_drain();
+    adc_set_round_robin(0);
+    adc_select_input(prev_input);
+    active = false;
+}
+
+bool adc_stream_active(void)
+{
+    return active;
+}
+
+const adc_stream_block_t *adc_stream_peek(void)
+{
+    return ready_count ? &ring[ready_q[ready_head]] : NULL;
+}
+
+void adc_stream_release(bool sent)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    if (ready_count)
+    {
+        slot_state[ready_q[ready_head]] = SLOT_FREE;
+        ready_head = (ready_head + 1) % ADC_STREAM_RING_BLOCKS;
+        ready_count--;
+        if (sent)
+        {
+            stats.sent++;
+        }
+        else
+        {
+            stats.dropped++;
+        }
+    }
+    restore_interrupts(ints);
+}
+
+static uint8_t *put_le(uint8_t *p, uint64_t v, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        *p++ = (uint8_t)(v >> (8 * i));
+    }
+    return p;
+}
+
+static size_t pack12(const uint16_t *s, uint8_t *p)
+{
+    uint8_t *start = p;
+    for (uint32_t i = 0; i < ADC_STREAM_BLOCK_SAMPLES; i += 2)
+    {
+        *p++ = s[i] & 0xFF;
+        *p++ = ((s[i] >> 8) & 0x0F) | ((s[i + 1] & 0x0F) << 4);
+        *p++ = (s[i + 1] >> 4) & 0xFF;
+    }
+    return p - start;
+}
+
+// Retorna 0 se o resultado não couber no tamanho empacotado
+static size_t delta_encode(const uint16_t *s, uint32_t n_inputs, uint8_t *p)
+{
+    const size_t limit = ADC_STREAM_BLOCK_SAMPLES * 3 / 2;
+    int32_t prev[5] = {-1000, -1000, -1000, -1000, -1000}; // Força valor absoluto na primeira de cada entrada
+    size_t len = 0;
+
+    for (uint32_t i = 0; i < ADC_STREAM_BLOCK_SAMPLES; i++)
+    {
+        uint32_t k = i % n_inputs;
+        int32_t d = (int32_t)s[i] - prev[k];
+        prev[k] = s[i];
+        if (d >= -127 && d <= 127)
+        {
+            if (len + 1 > limit)
+            {
+                return 0;
+            }
+            p[len++] = (uint8_t)(int8_t)d;
+        }
+        else
+        {
+            if (len + 3 > limit)
+            {
+                return 0;
+            }
+            p[len++] = 0x80;
+            p[len++] = s[i] & 0xFF;
+            p[len++] = s[i] >> 8;
+        }
+    }
+    return len;
+}
+
+size_t adc_stream_encode(const adc_stream_block_t *b, bool delta, uint64_t t_first_us, bool unix_time, uint8_t *out)
+{
+    uint8_t flags = unix_time ? ADC_STREAM_FLAG_UNIX : 0;
+    uint8_t *body = out + ADC_STREAM_HEADER_LEN;
+    size_t len = 0;
+
+    if (delta)
+    {
+        len = delta_encode(b->samples, __builtin_popcount(stats.input_mask), body);
+        flags |= len ? ADC_STREAM_FLAG_DELTA : 0;
+    }
+    if (len == 0)
+    {
+        len = pack12(b->samples, body);
+    }
+
+    uint8_t *p = out;
+    p = put_le(p, b->seq, 4);
+    p = put_le(p, stats.dropped, 4);
+    p = put_le(p, t_first_us, 8);
+    p = put_le(p, stats.rate_hz, 4);
+    *p++ = (uint8_t)stats.input_mask;
+    *p++ = flags;
+    put_le(p, ADC_STREAM_BLOCK_SAMPLES, 2);
+    return ADC_STREAM_HEADER_LEN + len;
+}
+
+void adc_stream_get_stats(adc_stream_stats_t *out)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    *out = stats;
+    restore_interrupts(ints);
+}
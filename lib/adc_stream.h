@@ -0,0 +1,67 @@
+#ifndef ADC_STREAM_H
+#define ADC_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Captura contínua do ADC em rodízio entre as entradas escolhidas. O ADC roda livre na
+// taxa pedida e a FIFO é esvaziada por dois canais DMA encadeados, cada um enchendo um
+// bloco de um anel. A interrupção de fim de bloco só troca o destino do canal que terminou;
+// se o anel estiver cheio porque o consumidor atrasou, o bloco é reaproveitado e contado
+// como perdido, sem interromper a captura.
+
+// Divisível por 1 a 5 entradas, então cada bloco começa sempre na primeira entrada
+#define ADC_STREAM_BLOCK_SAMPLES 240
+#define ADC_STREAM_RING_BLOCKS 6
+
+// Taxa total de conversões (por entrada vezes número de entradas)
+#define ADC_STREAM_TOTAL_MIN_HZ 1000
+#define ADC_STREAM_TOTAL_MAX_HZ 100000
+
+// Cabeçalho de cada bloco publicado, little-endian:
+//   u32 seq, u32 perdidos, u64 instante da primeira amostra (us), u32 taxa por entrada (Hz),
+//   u8 máscara de entradas, u8 flags, u16 número de amostras
+#define ADC_STREAM_HEADER_LEN 24
+#define ADC_STREAM_FLAG_DELTA 0x01 // Amostras em delta; senão 12 bits empacotados
+#define ADC_STREAM_FLAG_UNIX 0x02  // Instante em us desde 1970; senão us desde o boot
+
+// Maior bloco codificado (o delta nunca passa do tamanho empacotado)
+#define ADC_STREAM_MAX_PAYLOAD (ADC_STREAM_HEADER_LEN + ADC_STREAM_BLOCK_SAMPLES * 3 / 2)
+
+typedef struct
+{
+    uint32_t seq;          // Sequência do bloco; lacunas indicam blocos perdidos
+    uint64_t t_first_us;   // Instante estimado da primeira amostra (time_us_64)
+    uint16_t samples[ADC_STREAM_BLOCK_SAMPLES];
+} adc_stream_block_t;
+
+typedef struct
+{
+    uint32_t input_mask;
+    uint32_t rate_hz;   // Por entrada
+    uint32_t blocks;    // Blocos completados pela DMA
+    uint32_t sent;      // Blocos entregues ao MQTT
+    uint32_t dropped;   // Anel cheio ou falha ao publicar
+} adc_stream_stats_t;
+
+// Inicia a captura nas entradas da máscara (bits 0-4; 4 = sensor de temperatura) com a taxa
+// por entrada indicada. Retorna false se já estiver ativa ou os parâmetros forem inválidos.
+bool adc_stream_start(uint32_t input_mask, uint32_t rate_hz);
+
+// Para a captura e devolve o ADC ao modo de leitura avulsa na entrada anterior
+void adc_stream_stop(void);
+bool adc_stream_active(void);
+
+// Bloco pronto mais antigo, ou NULL. Fica reservado até adc_stream_release().
+const adc_stream_block_t *adc_stream_peek(void);
+void adc_stream_release(bool sent);
+
+// Codifica o bloco com cabeçalho. Com delta, cada amostra vira um byte com a diferença para a
+// amostra anterior da mesma entrada, ou 0x80 seguido do valor de 16 bits quando não cabe;
+// se o resultado ficar maior que o empacotado, usa 12 bits empacotados (3 bytes por 2 amostras).
+size_t adc_stream_encode(const adc_stream_block_t *b, bool delta, uint64_t t_first_us, bool unix_time, uint8_t *out);
+
+void adc_stream_get_stats(adc_stream_stats_t *out);
+
+#endif
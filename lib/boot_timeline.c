@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "boot_timeline.h"
+
+#define BOOT_TIMELINE_MAGIC 0x42544C31 // "BTL1"
+
+static const char *const phase_names[BOOT_PHASE_COUNT] = {
+    "main", "disp", "usb", "cred", "cyw43", "join", "dhcp", "dns", "connack", "suback", "ready"};
+
+// Fica em uma seção não inicializada pelo runtime, então sobrevive a um reset por software
+// (watchdog, reboot pelo bootrom). Após perda de energia o conteúdo é lixo e o magic não confere.
+static boot_timeline_t __uninitialized_ram(boot_tl)[2];
+static boot_timeline_t *const current = &boot_tl[0];
+static boot_timeline_t *const previous = &boot_tl[1];
+static bool has_previous;
+
+void boot_timeline_init(void)
+{
+    uint32_t now = time_us_32();
+    uint32_t count = 0;
+
+    has_previous = current->magic == BOOT_TIMELINE_MAGIC;
+    if (has_previous)
+    {
+        *previous = *current;
+        count = previous->boot_count + 1;
+    }
+
+    memset(current, 0, sizeof(*current));
+    current->magic = BOOT_TIMELINE_MAGIC;
+    current->boot_count = count;
+    current->phase_us[BOOT_PHASE_MAIN] = now;
+}
+
+void boot_timeline_mark(boot_phase_t phase)
+{
+    if (phase < BOOT_PHASE_COUNT && current->phase_us[phase] == 0)
+    {
+        current->phase_us[phase] = time_us_32();
+    }
+}
+
+const boot_timeline_t *boot_timeline_current(void)
+{
+    return current;
+}
+
+const boot_timeline_t *boot_timeline_previous(void)
+{
+    return has_previous ? previous : NULL;
+}
+
+size_t boot_timeline_format(const boot_timeline_t *tl, char *buf, size_t len)
+{
+    size_t pos = 0;
+    uint32_t last = 0;
+
+    if (len == 0)
+    {
+        return 0;
+    }
+    buf[0] = '\0';
+
+    for (int i = 0; i < BOOT_PHASE_COUNT && pos < len; i++)
+    {
+        uint32_t t = tl->phase_us[i];
+        if (t == 0)
+        {
+            continue; // Fase não alcançada
+        }
+        int n = snprintf(&buf[pos], len - pos, "%s%s=%lu(+%lu)", pos ? " " : "", phase_names[i],
+                         (unsigned long)(t / 1000), (unsigned long)((t - last) / 1000));
+        if (n < 0)
+        {
+            break;
+        }
+        pos += (size_t)n;
+        last = t;
+    }
+    return pos < len ? pos : len - 1;
+}
+
+void boot_timeline_print(void)
+{
+    char line[200];
+
+    boot_timeline_format(current, line, sizeof(line));
+    printf("Boot #%lu (ms): %s\n", (unsigned long)current->boot_count, line);
+    if (has_previous)
+    {
+        boot_timeline_format(previous, line, sizeof(line));
+        printf("Boot anterior (ms): %s\n", line);
+    }
+}
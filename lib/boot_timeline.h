@@ -0,0 +1,52 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Fases da inicialização, na ordem em que acontecem no main
+typedef enum
+{
+    BOOT_PHASE_MAIN = 0,    // Entrada no main (runtime do SDK já executado)
+    BOOT_PHASE_DISPLAY,     // initDisplay concluído
+    BOOT_PHASE_USB,         // waitUSB concluído
+    BOOT_PHASE_CREDENTIALS, // Credenciais digitadas
+    BOOT_PHASE_CYW43_INIT,  // cyw43_arch_init concluído
+    BOOT_PHASE_WIFI_JOIN,   // Associado ao AP (ainda sem IP)
+    BOOT_PHASE_DHCP,        // Endereço IP obtido
+    BOOT_PHASE_DNS,         // Endereço do broker resolvido
+    BOOT_PHASE_CONNACK,     // Conexão MQTT aceita
+    BOOT_PHASE_SUBACK,      // Primeiro SUBACK recebido
+    BOOT_PHASE_READY,       // Todos os SUBACKs recebidos, pronto para comandos
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+// Registro de uma inicialização: instante (em us desde o reset) do fim de cada fase.
+// Zero indica fase não alcançada.
+typedef struct
+{
+    uint32_t magic;
+    uint32_t boot_count;
+    uint32_t phase_us[BOOT_PHASE_COUNT];
+} boot_timeline_t;
+
+// Inicializa o registro. Deve ser a primeira chamada do main.
+// Se a RAM não inicializada contém um registro válido (reset por software),
+// ele é preservado como o registro da inicialização anterior.
+void boot_timeline_init(void);
+
+// Marca o fim de uma fase (apenas a primeira marcação de cada fase é mantida)
+void boot_timeline_mark(boot_phase_t phase);
+
+// Registro da inicialização atual e da anterior (NULL se não houver)
+const boot_timeline_t *boot_timeline_current(void);
+const boot_timeline_t *boot_timeline_previous(void);
+
+// Formata o registro como "fase=ms_desde_reset(+ms_da_fase)" separados por espaço.
+// Retorna o número de caracteres escritos (sem o '\0').
+size_t boot_timeline_format(const boot_timeline_t *tl, char *buf, size_t len);
+
+// Imprime o registro atual (e o anterior, se existir) na USB
+void boot_timeline_print(void);
+
+#endif
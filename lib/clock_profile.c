@@ -0,0 +1,45 @@
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/vreg.h"
+#include "clock_profile.h"
+
+static const uint32_t profiles_khz[] = CLOCK_PROFILES_KHZ;
+
+bool clock_profile_valid(uint32_t khz)
+{
+    for (uint32_t i = 0; i < count_of(profiles_khz); i++)
+    {
+        if (profiles_khz[i] == khz)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool clock_profile_set(uint32_t khz)
+{
+    uint vco, div1, div2;
+    if (!clock_profile_valid(khz) || !check_sys_clock_khz(khz, &vco, &div1, &div2))
+    {
+        return false;
+    }
+
+    // Tensão sobe antes do clock e desce depois dele
+    if (khz > CLOCK_PROFILE_VREG_BOOST_KHZ)
+    {
+        vreg_set_voltage(VREG_VOLTAGE_1_15);
+        busy_wait_us(1000);
+    }
+    set_sys_clock_pll(vco, div1, div2);
+    if (khz <= CLOCK_PROFILE_VREG_BOOST_KHZ)
+    {
+        vreg_set_voltage(VREG_VOLTAGE_DEFAULT);
+    }
+    return true;
+}
+
+uint32_t clock_profile_current_khz(void)
+{
+    return clock_get_hz(clk_sys) / 1000;
+}
@@ -0,0 +1,25 @@
+#ifndef CLOCK_PROFILE_H
+#define CLOCK_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Perfis de clk_sys selecionáveis em tempo de execução. A troca só mexe no PLL do sistema
+// e na tensão do regulador; quem usa clk_sys (PWM, PIO, I2C) precisa ser recalculado depois.
+// O timer de 1 MHz, o ADC e a USB usam outros clocks e não são afetados.
+
+#define CLOCK_PROFILES_KHZ {48000, 125000, 200000}
+#define CLOCK_PROFILE_DEFAULT_KHZ 125000
+
+// Acima disso o regulador sobe para 1,15 V antes de aumentar o clock
+#define CLOCK_PROFILE_VREG_BOOST_KHZ 133000
+
+// Retorna true se khz for um dos perfis
+bool clock_profile_valid(uint32_t khz);
+
+// Troca o clk_sys. Retorna false se o perfil não existir ou o PLL não atingir a frequência exata.
+bool clock_profile_set(uint32_t khz);
+
+uint32_t clock_profile_current_khz(void);
+
+#endif
@@ -0,0 +1,120 @@
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "hardware/sync.h"
+#include "lwip/apps/sntp.h"
+#include "clock_sync.h"
+
+// Intervalo mínimo entre amostras SNTP para estimar o desvio de frequência
+#define DRIFT_MIN_INTERVAL_US 10000000
+// Limite do desvio estimado: cristais comuns ficam bem abaixo de 100 ppm
+#define DRIFT_MAX_PPB 200000
+// Um beacon só é aceito se o SNTP estiver parado há mais do que este tempo
+#define SNTP_STALE_US (3ull * CLOCK_SYNC_SNTP_INTERVAL_MS * 1000)
+
+// Tempo sincronizado = base_unix + dt + dt * drift_ppb / 1e9, com dt = local - base_local
+static uint64_t base_local;
+static uint64_t base_unix;
+static clock_sync_status_t status;
+static uint64_t last_sntp_local;
+
+static uint64_t to_unix(uint64_t local_us)
+{
+    int64_t dt = (int64_t)(local_us - base_local);
+    return base_unix + dt + (dt * status.drift_ppb) / 1000000000;
+}
+
+void clock_sync_start(const char *server)
+{
+    cyw43_arch_lwip_begin();
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_setservername(0, server);
+    sntp_init();
+    cyw43_arch_lwip_end();
+}
+
+void clock_sync_set(uint64_t unix_us, clock_src_t source)
+{
+    uint64_t now = time_us_64();
+    uint32_t ints = save_and_disable_interrupts();
+
+    if (status.source != CLOCK_SRC_NONE)
+    {
+        int64_t step = (int64_t)(to_unix(now) - unix_us);
+        status.last_step_us = step;
+
+        // Desvio de frequência medido entre duas amostras SNTP (média móvel 1/4)
+        int64_t elapsed = (int64_t)(now - base_local);
+        if (source == CLOCK_SRC_SNTP && status.source == CLOCK_SRC_SNTP && elapsed > DRIFT_MIN_INTERVAL_US &&
+            step > -1000000 && step < 1000000)
+        {
+            int64_t ppb = status.drift_ppb - (step * 1000000000) / elapsed;
+            ppb = MAX(-DRIFT_MAX_PPB, MIN(DRIFT_MAX_PPB, ppb));
+            status.drift_ppb += (int32_t)((ppb - status.drift_ppb) / 4);
+        }
+    }
+
+    base_local = now;
+    base_unix = unix_us;
+    status.source = source;
+    status.samples++;
+    status.last_sync_us = now;
+    if (source == CLOCK_SRC_SNTP)
+    {
+        last_sntp_local = now;
+    }
+    restore_interrupts(ints);
+}
+
+void clock_sync_beacon(uint64_t unix_us)
+{
+    if (last_sntp_local == 0 || time_us_64() - last_sntp_local > SNTP_STALE_US)
+    {
+        clock_sync_set(unix_us, CLOCK_SRC_BEACON);
+    }
+}
+
+bool clock_sync_valid(void)
+{
+    return status.source != CLOCK_SRC_NONE;
+}
+
+uint64_t clock_sync_local_to_unix(uint64_t local_us)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    uint64_t unix_us = to_unix(local_us);
+    restore_interrupts(ints);
+    return unix_us;
+}
+
+uint64_t clock_sync_unix_to_local(uint64_t unix_us)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    int64_t du = (int64_t)(unix_us - base_unix);
+    uint64_t local_us = base_local + du - (du * status.drift_ppb) / 1000000000;
+    restore_interrupts(ints);
+    return local_us;
+}
+
+uint64_t clock_sync_now_unix(void)
+{
+    return clock_sync_local_to_unix(time_us_64());
+}
+
+void clock_sync_get_status(clock_sync_status_t *out)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    *out = status;
+    restore_interrupts(ints);
+}
+
+void clock_sync_sntp_set(uint32_t sec, uint32_t us)
+{
+    clock_sync_set((uint64_t)sec * 1000000 + us, CLOCK_SRC_SNTP);
+}
+
+void clock_sync_sntp_get(uint32_t *sec, uint32_t *us)
+{
+    uint64_t now = clock_sync_now_unix();
+    *sec = (uint32_t)(now / 1000000);
+    *us = (uint32_t)(now % 1000000);
+}
@@ -0,0 +1,59 @@
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Intervalo entre consultas SNTP (o lwIP impõe no mínimo 15 s)
+#ifndef CLOCK_SYNC_SNTP_INTERVAL_MS
+#define CLOCK_SYNC_SNTP_INTERVAL_MS 60000
+#endif
+
+// Servidor NTP. Se não definido, usa o próprio host do broker MQTT,
+// que nas instalações locais também roda o servidor NTP.
+// #define CLOCK_SYNC_NTP_SERVER "pool.ntp.org"
+
+// Origem da última correção do relógio
+typedef enum
+{
+    CLOCK_SRC_NONE = 0,
+    CLOCK_SRC_SNTP,
+    CLOCK_SRC_BEACON, // Tópico /time publicado pelo broker
+} clock_src_t;
+
+// Estado do relógio disciplinado, para diagnóstico
+typedef struct
+{
+    clock_src_t source;
+    uint32_t samples;       // Número de correções aplicadas
+    int64_t last_step_us;   // Diferença entre o relógio local e a referência na última correção
+    int32_t drift_ppb;      // Desvio de frequência estimado do cristal (partes por bilhão)
+    uint64_t last_sync_us;  // Instante local (us desde o boot) da última correção
+} clock_sync_status_t;
+
+// Inicia o SNTP. Chamar com o Wi-Fi conectado.
+void clock_sync_start(const char *server);
+
+// Aplica uma referência de tempo (us desde 1970) recebida no instante local atual
+void clock_sync_set(uint64_t unix_us, clock_src_t source);
+
+// Referência de tempo publicada no broker. Só é aplicada se não houver SNTP recente.
+void clock_sync_beacon(uint64_t unix_us);
+
+// true após a primeira correção
+bool clock_sync_valid(void);
+
+// Converte entre o relógio local (us desde o boot) e o tempo sincronizado (us desde 1970)
+uint64_t clock_sync_local_to_unix(uint64_t local_us);
+uint64_t clock_sync_unix_to_local(uint64_t unix_us);
+
+// Tempo sincronizado atual (us desde 1970)
+uint64_t clock_sync_now_unix(void);
+
+void clock_sync_get_status(clock_sync_status_t *status);
+
+// Ganchos do SNTP do lwIP (ver lwipopts.h)
+void clock_sync_sntp_set(uint32_t sec, uint32_t us);
+void clock_sync_sntp_get(uint32_t *sec, uint32_t *us);
+
+#endif
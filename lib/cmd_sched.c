@@ -0,0 +1,104 @@
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "cmd_sched.h"
+
+typedef enum
+{
+    SLOT_FREE = 0,
+    SLOT_PENDING,
+    SLOT_FIRED,
+} slot_state_t;
+
+typedef struct
+{
+    volatile slot_state_t state;
+    alarm_id_t alarm;
+    cmd_sched_entry_t cmd;
+} slot_t;
+
+static slot_t slots[CMD_SCHED_QUEUE_LEN];
+static cmd_sched_apply_fn apply_fn;
+
+void cmd_sched_init(cmd_sched_apply_fn apply)
+{
+    apply_fn = apply;
+}
+
+// Interrupção do alarme: aplica o duty com a precisão do timer (1 us)
+static int64_t fire_cb(alarm_id_t id, void *user_data)
+{
+    slot_t *slot = (slot_t *)user_data;
+    apply_fn(slot->cmd.channel, slot->cmd.gpio, slot->cmd.duty);
+    slot->cmd.late_us = (int32_t)(time_us_64() - slot->cmd.target_us);
+    slot->state = SLOT_FIRED;
+    return 0; // Não repete
+}
+
+bool cmd_sched_add(uint64_t target_us, uint8_t channel, uint16_t gpio, uint8_t duty)
+{
+    if (apply_fn == NULL || target_us <= time_us_64())
+    {
+        return false;
+    }
+
+    for (int i = 0; i < CMD_SCHED_QUEUE_LEN; i++)
+    {
+        slot_t *slot = &slots[i];
+        if (slot->state != SLOT_FREE)
+        {
+            continue;
+        }
+        slot->cmd = (cmd_sched_entry_t){
+            .target_us = target_us,
+            .channel = channel,
+            .duty = duty,
+            .gpio = gpio,
+        };
+        slot->state = SLOT_PENDING;
+        slot->alarm = add_alarm_at(from_us_since_boot(target_us), fire_cb, slot, true);
+        if (slot->alarm < 0)
+        {
+            slot->state = SLOT_FREE; // Sem alarmes livres no pool
+            return false;
+        }
+        // alarm == 0: o instante passou durante o agendamento e fire_cb já executou
+        return true;
+    }
+    return false;
+}
+
+void cmd_sched_cancel_channel(uint8_t channel)
+{
+    for (int i = 0; i < CMD_SCHED_QUEUE_LEN; i++)
+    {
+        slot_t *slot = &slots[i];
+        if (slot->state == SLOT_PENDING && slot->cmd.channel == channel && cancel_alarm(slot->alarm))
+        {
+            slot->state = SLOT_FREE;
+        }
+    }
+}
+
+bool cmd_sched_pop_fired(cmd_sched_entry_t *out)
+{
+    for (int i = 0; i < CMD_SCHED_QUEUE_LEN; i++)
+    {
+        if (slots[i].state == SLOT_FIRED)
+        {
+            *out = slots[i].cmd;
+            slots[i].state = SLOT_FREE;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t cmd_sched_pending(void)
+{
+    uint32_t n = 0;
+    for (int i = 0; i < CMD_SCHED_QUEUE_LEN; i++)
+    {
+        n += slots[i].state == SLOT_PENDING;
+    }
+    return n;
+}
@@ -0,0 +1,41 @@
+#ifndef CMD_SCHED_H
+#define CMD_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Número máximo de comandos agendados ao mesmo tempo (cada um usa um alarme do pool padrão)
+#ifndef CMD_SCHED_QUEUE_LEN
+#define CMD_SCHED_QUEUE_LEN 8
+#endif
+
+// Comando de duty agendado. Guarda o duty, não o nível: o nível é calculado na interrupção do
+// alarme, para o TOP e a curva que valem no instante da aplicação.
+typedef struct
+{
+    uint64_t target_us;  // Instante local (us desde o boot) da aplicação
+    int32_t late_us;     // Atraso medido na interrupção
+    uint8_t channel;     // Índice do canal
+    uint8_t duty;        // Duty em porcentagem
+    uint16_t gpio;
+} cmd_sched_entry_t;
+
+// Aplica o duty no canal; chamada na interrupção do alarme
+typedef void (*cmd_sched_apply_fn)(uint8_t channel, uint16_t gpio, uint8_t duty);
+
+void cmd_sched_init(cmd_sched_apply_fn apply);
+
+// Agenda o duty do canal no instante local target_us.
+// Retorna false se a fila estiver cheia ou o instante já tiver passado.
+bool cmd_sched_add(uint64_t target_us, uint8_t channel, uint16_t gpio, uint8_t duty);
+
+// Cancela todos os comandos pendentes de um canal
+void cmd_sched_cancel_channel(uint8_t channel);
+
+// Retira da fila um comando já executado, para atualizar display e matriz no laço principal
+bool cmd_sched_pop_fired(cmd_sched_entry_t *out);
+
+// Quantidade de comandos aguardando execução
+uint32_t cmd_sched_pending(void);
+
+#endif
@@ -0,0 +1,81 @@
+#include "derate.h"
+
+void derate_init(derate_t *d, uint8_t filter_shift)
+{
+    d->temp_q = 0;
+    d->shift = filter_shift;
+    d->primed = false;
+    for (uint32_t ch = 0; ch < DERATE_CHANNELS; ch++)
+    {
+        d->policy[ch] = (derate_policy_t){.start_mc = 60000, .full_mc = 80000, .hyst_mc = 3000, .floor = 300};
+        d->factor[ch] = DERATE_ONE;
+    }
+}
+
+bool derate_set_policy(derate_t *d, uint32_t ch, int32_t start_mc, int32_t full_mc, uint16_t floor, int32_t hyst_mc)
+{
+    if (ch >= DERATE_CHANNELS || full_mc <= start_mc || floor > DERATE_ONE || hyst_mc < 0)
+    {
+        return false;
+    }
+    d->policy[ch] = (derate_policy_t){.start_mc = start_mc, .full_mc = full_mc, .hyst_mc = hyst_mc, .floor = floor};
+    return true;
+}
+
+int32_t derate_adc_to_mc(uint16_t raw)
+{
+    // T = 27 - (V - 0,706) / 0,001721, com V em uV
+    int32_t uv = (int32_t)(((uint32_t)raw * 3300000u) / 4096u);
+    return 27000 - (int32_t)(((int64_t)(uv - 706000) * 1000) / 1721);
+}
+
+// Fator da política para uma temperatura, sem histerese
+static uint16_t policy_factor(const derate_policy_t *p, int32_t t)
+{
+    if (t <= p->start_mc)
+    {
+        return DERATE_ONE;
+    }
+    if (t >= p->full_mc)
+    {
+        return p->floor;
+    }
+    int32_t span = DERATE_ONE - p->floor;
+    return (uint16_t)(DERATE_ONE - ((int64_t)span * (t - p->start_mc)) / (p->full_mc - p->start_mc));
+}
+
+bool derate_step(derate_t *d, int32_t temp_mc)
+{
+    int32_t x = temp_mc * (1 << DERATE_FILTER_Q);
+    if (!d->primed)
+    {
+        d->temp_q = x;
+        d->primed = true;
+    }
+    else
+    {
+        d->temp_q += (x - d->temp_q) >> d->shift;
+    }
+
+    int32_t t = derate_temp_mc(d);
+    bool changed = false;
+    for (uint32_t ch = 0; ch < DERATE_CHANNELS; ch++)
+    {
+        const derate_policy_t *p = &d->policy[ch];
+        uint16_t f = policy_factor(p, t);
+        if (f > d->factor[ch])
+        {
+            // Esfriando: sobe só o que a temperatura deslocada pela histerese permite
+            f = policy_factor(p, t + p->hyst_mc);
+            f = f > d->factor[ch] ? f : d->factor[ch];
+        }
+        changed |= f != d->factor[ch];
+        d->factor[ch] = f;
+    }
+    return changed;
+}
+
+int32_t derate_temp_mc(const derate_t *d)
+{
+    return d->temp_q / (1 << DERATE_FILTER_Q);
+}
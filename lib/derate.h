@@ -0,0 +1,56 @@
+#ifndef DERATE_H
+#define DERATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Núcleo da redução de potência por temperatura, sem dependências do SDK para poder ser
+// compilado no host e alimentado com uma série de temperaturas simulada.
+// A temperatura passa por um filtro exponencial em ponto fixo; cada canal tem um fator
+// (em milésimos) que cai linearmente de 1000 em start_mc até floor em full_mc. O fator é um
+// teto para o duty: abaixo dele o nível comandado passa sem mudança.
+// Ao esfriar, o fator só volta a subir depois que a temperatura cai hyst_mc abaixo do
+// ponto em que ele foi reduzido, para não oscilar com o ruído do sensor.
+
+#define DERATE_CHANNELS 3
+#define DERATE_ONE 1000
+#define DERATE_FILTER_Q 8 // Estimativa em mC com 8 bits fracionários
+
+typedef struct
+{
+    int32_t start_mc; // Início da redução
+    int32_t full_mc;  // Redução máxima a partir daqui
+    int32_t hyst_mc;
+    uint16_t floor;   // Fator mínimo, em milésimos
+} derate_policy_t;
+
+typedef struct
+{
+    int32_t temp_q;   // Estimativa filtrada, Q8 de mC
+    uint8_t shift;    // Constante do filtro: cada amostra pesa 1/2^shift
+    bool primed;
+    derate_policy_t policy[DERATE_CHANNELS];
+    uint16_t factor[DERATE_CHANNELS];
+} derate_t;
+
+// Inicia com fator 1000 em todos os canais e a política padrão (60-80 °C, mínimo 30%, histerese 3 °C)
+void derate_init(derate_t *d, uint8_t filter_shift);
+
+bool derate_set_policy(derate_t *d, uint32_t ch, int32_t start_mc, int32_t full_mc, uint16_t floor, int32_t hyst_mc);
+
+// Converte a leitura do sensor interno (entrada 4, referência de 3,3 V) para mC
+int32_t derate_adc_to_mc(uint16_t raw);
+
+// Acrescenta uma amostra e recalcula os fatores. Retorna true se algum fator mudou.
+bool derate_step(derate_t *d, int32_t temp_mc);
+
+int32_t derate_temp_mc(const derate_t *d);
+
+// Nível limitado ao fator do duty máximo do slice (TOP + 1 = 100%)
+static inline uint16_t derate_apply(uint16_t level, uint16_t factor, uint16_t top)
+{
+    uint32_t cap = ((top + 1u) * factor) / DERATE_ONE;
+    return (uint16_t)(level < cap ? level : cap);
+}
+
+#endif
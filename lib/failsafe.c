@@ -0,0 +1,148 @@
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "failsafe.h"
+#include "pwm_wave.h"
+#include "pwm_dither.h"
+#include "pid_loop.h"
+#include "servo.h"
+#include "thermal_loop.h"
+#include "scene.h"
+
+typedef struct
+{
+    failsafe_channel_t pub;
+    uint gpio;
+    uint32_t last_feed_ms;
+    bool ramping;
+    uint32_t ramp_start_ms;
+    uint16_t from_level;
+    uint16_t to_level;
+} fs_t;
+
+static fs_t chans[FAILSAFE_CHANNELS];
+static repeating_timer_t timer;
+static volatile uint32_t tripped_mask;
+
+static uint32_t now_ms(void)
+{
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static uint16_t current_level(uint gpio)
+{
+    uint32_t cc = pwm_hw->slice[pwm_gpio_to_slice_num(gpio)].cc;
+    return pwm_gpio_to_channel(gpio) == PWM_CHAN_B ? cc >> 16 : cc & 0xFFFF;
+}
+
+static void trip(uint32_t ch, uint32_t now)
+{
+    fs_t *f = &chans[ch];
+    f->pub.tripped = true;
+    tripped_mask |= 1u << ch;
+
+    const servo_t *servo = servo_get(ch);
+    if (servo->enabled)
+    {
+        servo_set_pulse_ns(ch, f->gpio, servo->min_ns);
+        return;
+    }
+
+    // A rampa parte do nível presente no comparador, qualquer que seja o modo do canal
+    pwm_wave_stop(ch);
+    pwm_dither_stop(ch);
+    scene_stop_ramp(ch);
+    pid_loop_disable(ch);
+    uint32_t top = pwm_hw->slice[pwm_gpio_to_slice_num(f->gpio)].top;
+    f->from_level = current_level(f->gpio);
+    f->to_level = (uint16_t)(((top + 1u) * f->pub.safe_permille) / 1000u);
+    f->ramp_start_ms = now;
+    f->ramping = true;
+}
+
+static bool tick_cb(repeating_timer_t *rt)
+{
+    uint32_t now = now_ms();
+    for (uint32_t ch = 0; ch < FAILSAFE_CHANNELS; ch++)
+    {
+        fs_t *f = &chans[ch];
+        if (f->pub.timeout_ms == 0)
+        {
+            continue;
+        }
+        if (!f->pub.tripped && now - f->last_feed_ms >= f->pub.timeout_ms)
+        {
+            trip(ch, now);
+        }
+        if (f->ramping)
+        {
+            uint32_t t = now - f->ramp_start_ms;
+            int32_t level = f->to_level;
+            if (t < f->pub.ramp_ms)
+            {
+                level = f->from_level + ((int32_t)f->to_level - f->from_level) * (int32_t)t / (int32_t)f->pub.ramp_ms;
+            }
+            else
+            {
+                f->ramping = false;
+            }
+            thermal_loop_set_level(ch, f->gpio, (uint16_t)level);
+        }
+    }
+    return true;
+}
+
+void failsafe_start(void)
+{
+    uint32_t now = now_ms();
+    for (uint32_t ch = 0; ch < FAILSAFE_CHANNELS; ch++)
+    {
+        chans[ch].last_feed_ms = now;
+    }
+    add_repeating_timer_ms(-FAILSAFE_TICK_MS, tick_cb, NULL, &timer);
+}
+
+void failsafe_configure(uint32_t ch, uint32_t gpio, uint32_t timeout_ms, uint16_t safe_permille, uint32_t ramp_ms)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    fs_t *f = &chans[ch];
+    f->gpio = gpio;
+    f->pub.timeout_ms = timeout_ms;
+    f->pub.safe_permille = MIN(safe_permille, 1000);
+    f->pub.ramp_ms = ramp_ms;
+    f->pub.tripped = false;
+    f->ramping = false;
+    f->last_feed_ms = now_ms();
+    restore_interrupts(ints);
+}
+
+void failsafe_feed(uint32_t ch)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    chans[ch].last_feed_ms = now_ms();
+    chans[ch].pub.tripped = false;
+    chans[ch].ramping = false;
+    restore_interrupts(ints);
+}
+
+void failsafe_feed_all(void)
+{
+    for (uint32_t ch = 0; ch < FAILSAFE_CHANNELS; ch++)
+    {
+        failsafe_feed(ch);
+    }
+}
+
+failsafe_channel_t failsafe_get(uint32_t ch)
+{
+    return chans[ch].pub;
+}
+
+uint32_t failsafe_poll_tripped(void)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    uint32_t m = tripped_mask;
+    tripped_mask = 0;
+    restore_interrupts(ints);
+    return m;
+}
@@ -0,0 +1,40 @@
+#ifndef FAILSAFE_H
+#define FAILSAFE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Falha segura por perda de comunicação. Cada canal tem um tempo limite sem comandos;
+// ao estourar, um timer repetitivo (interrupção de alarme, fora do contexto do lwIP) para
+// a forma de onda ou o laço PID do canal e leva o duty em rampa até o valor seguro.
+// Canais em modo servo vão direto ao pulso mínimo (acelerador zero em um ESC).
+// Qualquer comando ou batimento recebido rearma o canal e interrompe a rampa.
+
+#define FAILSAFE_CHANNELS 3
+#ifndef FAILSAFE_TICK_MS
+#define FAILSAFE_TICK_MS 10
+#endif
+
+typedef struct
+{
+    uint32_t timeout_ms; // 0 = desligado
+    uint16_t safe_permille;
+    uint32_t ramp_ms;
+    bool tripped;
+} failsafe_channel_t;
+
+void failsafe_start(void);
+
+// Configura o canal; timeout_ms = 0 desliga a supervisão dele
+void failsafe_configure(uint32_t ch, uint32_t gpio, uint32_t timeout_ms, uint16_t safe_permille, uint32_t ramp_ms);
+
+// Comando ou batimento recebido
+void failsafe_feed(uint32_t ch);
+void failsafe_feed_all(void);
+
+failsafe_channel_t failsafe_get(uint32_t ch);
+
+// Máscara dos canais que dispararam desde a última chamada (para a interface)
+uint32_t failsafe_poll_tripped(void);
+
+#endif
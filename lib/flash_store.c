@@ -0,0 +1,105 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "flash_store.h"
+
+#define FLASH_STORE_MAGIC 0x46535431 // "FST1"
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t len;
+    uint32_t crc;
+} flash_store_header_t;
+
+#define FLASH_STORE_MAX_LEN (FLASH_SECTOR_SIZE - sizeof(flash_store_header_t))
+
+// Deslocamento do setor do slot a partir do início da flash
+static uint32_t slot_offset(uint32_t slot)
+{
+    return PICO_FLASH_SIZE_BYTES - (slot + 1) * FLASH_SECTOR_SIZE;
+}
+
+// CRC-32 (polinômio 0xEDB88320) bit a bit, sem tabela para economizar flash
+static uint32_t crc32(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--)
+    {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+bool flash_store_load(uint32_t slot, void *data, size_t len)
+{
+    if (slot >= FLASH_STORE_SLOT_COUNT || len > FLASH_STORE_MAX_LEN)
+    {
+        return false;
+    }
+
+    const uint8_t *base = (const uint8_t *)(XIP_BASE + slot_offset(slot));
+    const flash_store_header_t *hdr = (const flash_store_header_t *)base;
+    if (hdr->magic != FLASH_STORE_MAGIC || hdr->len != len)
+    {
+        return false;
+    }
+    if (crc32(base + sizeof(*hdr), len) != hdr->crc)
+    {
+        return false;
+    }
+    memcpy(data, base + sizeof(*hdr), len);
+    return true;
+}
+
+bool flash_store_save(uint32_t slot, const void *data, size_t len)
+{
+    if (slot >= FLASH_STORE_SLOT_COUNT || len > FLASH_STORE_MAX_LEN)
+    {
+        return false;
+    }
+
+    flash_store_header_t hdr = {
+        .magic = FLASH_STORE_MAGIC,
+        .len = len,
+        .crc = crc32(data, len),
+    };
+    uint32_t offset = slot_offset(slot);
+    const uint8_t *src = data;
+    size_t total = sizeof(hdr) + len;
+    uint8_t page[FLASH_PAGE_SIZE];
+
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_erase(offset, FLASH_SECTOR_SIZE);
+
+    // Grava página por página, montando o cabeçalho e os dados em um buffer de 256 bytes
+    for (size_t pos = 0; pos < total; pos += FLASH_PAGE_SIZE)
+    {
+        memset(page, 0xFF, sizeof(page));
+        for (size_t i = 0; i < FLASH_PAGE_SIZE && pos + i < total; i++)
+        {
+            size_t at = pos + i;
+            page[i] = at < sizeof(hdr) ? ((const uint8_t *)&hdr)[at] : src[at - sizeof(hdr)];
+        }
+        flash_range_program(offset + pos, page, FLASH_PAGE_SIZE);
+    }
+    restore_interrupts(ints);
+
+    return memcmp((const uint8_t *)(XIP_BASE + offset + sizeof(hdr)), data, len) == 0;
+}
+
+void flash_store_erase(uint32_t slot)
+{
+    if (slot >= FLASH_STORE_SLOT_COUNT)
+    {
+        return;
+    }
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_erase(slot_offset(slot), FLASH_SECTOR_SIZE);
+    restore_interrupts(ints);
+}
@@ -0,0 +1,27 @@
+#ifndef FLASH_STORE_H
+#define FLASH_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Cada slot ocupa um setor de 4 KB no fim da flash, contado de trás para frente,
+// longe do binário do programa
+#define FLASH_STORE_SLOT_WIFI 0        // Cache da última conexão Wi-Fi
+#define FLASH_STORE_SLOT_CREDENTIALS 1 // Credenciais gravadas pelo terminal USB
+#define FLASH_STORE_SLOT_SCENES 2      // Cenas dos canais
+#define FLASH_STORE_SLOT_GROUPS 3      // Grupos de endereçamento MQTT
+#define FLASH_STORE_SLOT_COUNT 4
+
+// Lê o registro do slot. Retorna false se o slot estiver vazio, corrompido
+// ou se o tamanho gravado for diferente de len.
+bool flash_store_load(uint32_t slot, void *data, size_t len);
+
+// Apaga o setor do slot e grava o registro. Bloqueia com as interrupções
+// desabilitadas durante o apagamento (dezenas de ms).
+bool flash_store_save(uint32_t slot, const void *data, size_t len);
+
+// Apaga o slot
+void flash_store_erase(uint32_t slot);
+
+#endif
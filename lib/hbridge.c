@@ -0,0 +1,104 @@
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hbridge.h"
+
+static hbridge_t bridges[HBRIDGE_CHANNELS];
+
+bool hbridge_configure(uint32_t ch, uint32_t gpio, uint32_t freq_hz, uint32_t dead_ns)
+{
+    hbridge_t *h = &bridges[ch];
+    uint32_t clk_hz = clock_get_hz(clk_sys);
+    pwm_timing_t t;
+
+    // Na contagem centralizada o período tem 2 * (top + 1) ciclos do contador
+    if (freq_hz == 0 || dead_ns > HBRIDGE_DEAD_MAX_NS || !pwm_calc_solve(clk_hz, freq_hz * 2, &t))
+    {
+        return false;
+    }
+    uint32_t dead_ticks = (uint32_t)(((uint64_t)dead_ns * clk_hz * 16 + (uint64_t)t.div16 * 1000000000u - 1) /
+                                     ((uint64_t)t.div16 * 1000000000u));
+    if (dead_ticks > (t.top + 1u) / 4)
+    {
+        return false;
+    }
+
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    bool primary_b = pwm_gpio_to_channel(gpio) == PWM_CHAN_B;
+    *h = (hbridge_t){
+        .enabled = true,
+        .gpio = gpio,
+        .gpio_comp = gpio ^ 1, // A e B de um slice são GPIOs vizinhos (par, ímpar)
+        .freq_hz = freq_hz,
+        .dead_ns = dead_ns,
+        .dead_ticks = (uint16_t)dead_ticks,
+        .timing = t,
+        .level = 0,
+    };
+
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv_int_frac(&config, t.div16 >> 4, t.div16 & 0xF);
+    pwm_config_set_wrap(&config, t.top);
+    pwm_config_set_phase_correct(&config, true);
+    pwm_config_set_output_polarity(&config, !primary_b, primary_b); // Inverte a complementar
+    pwm_init(slice, &config, false);
+    pwm_hw->slice[slice].cc = hbridge_cc_word(primary_b, 0, h->dead_ticks, t.top);
+    gpio_set_function(h->gpio, GPIO_FUNC_PWM);
+    gpio_set_function(h->gpio_comp, GPIO_FUNC_PWM);
+    pwm_set_enabled(slice, true);
+    return true;
+}
+
+bool hbridge_retime(uint32_t ch)
+{
+    hbridge_t *h = &bridges[ch];
+    return h->enabled && hbridge_configure(ch, h->gpio, h->freq_hz, h->dead_ns);
+}
+
+void hbridge_disable(uint32_t ch)
+{
+    hbridge_t *h = &bridges[ch];
+    if (!h->enabled)
+    {
+        return;
+    }
+    uint slice = pwm_gpio_to_slice_num(h->gpio);
+    pwm_set_phase_correct(slice, false);
+    pwm_set_output_polarity(slice, false, false);
+    pwm_hw->slice[slice].cc = 0;
+    h->enabled = false;
+}
+
+bool hbridge_set_level(uint32_t gpio, uint16_t level)
+{
+    for (uint32_t ch = 0; ch < HBRIDGE_CHANNELS; ch++)
+    {
+        hbridge_t *h = &bridges[ch];
+        if (h->enabled && h->gpio == gpio)
+        {
+            h->level = MIN(level, h->timing.top + 1u);
+            // Uma só escrita de 32 bits: o slice nunca vê uma comparação nova com a outra antiga
+            pwm_hw->slice[pwm_gpio_to_slice_num(gpio)].cc =
+                hbridge_cc_word(pwm_gpio_to_channel(gpio) == PWM_CHAN_B, h->level, h->dead_ticks, h->timing.top);
+            return true;
+        }
+    }
+    return false;
+}
+
+int hbridge_complement_owner(uint32_t gpio)
+{
+    for (uint32_t ch = 0; ch < HBRIDGE_CHANNELS; ch++)
+    {
+        if (bridges[ch].enabled && bridges[ch].gpio_comp == gpio)
+        {
+            return ch;
+        }
+    }
+    return -1;
+}
+
+const hbridge_t *hbridge_get(uint32_t ch)
+{
+    return &bridges[ch];
+}
@@ -0,0 +1,60 @@
+#ifndef HBRIDGE_H
+#define HBRIDGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pwm_calc.h"
+
+// Canal em meia ponte: as duas saídas do slice formam um par complementar com tempo morto.
+// O contador é centralizado (phase-correct) e a saída complementar é invertida no próprio
+// slice; o comparador dela fica dead_ticks acima do principal, então o intervalo com as duas
+// em nível baixo antes de cada borda é exato, em ciclos do contador, nos dois sentidos.
+// As duas comparações são escritas juntas em uma única palavra do registrador CC.
+
+#define HBRIDGE_CHANNELS 3
+#define HBRIDGE_DEAD_MAX_NS 10000
+
+typedef struct
+{
+    bool enabled;
+    uint32_t gpio;       // Saída principal (a do canal)
+    uint32_t gpio_comp;  // Saída complementar (a outra do mesmo slice)
+    uint32_t freq_hz;
+    uint32_t dead_ns;    // Tempo morto pedido
+    uint16_t dead_ticks; // Tempo morto aplicado, em ciclos do contador
+    pwm_timing_t timing;
+    uint16_t level;      // Último nível da saída principal
+} hbridge_t;
+
+// Coloca o slice do GPIO em meia ponte. Retorna false se a frequência ou o tempo morto
+// estiverem fora da faixa (o tempo morto precisa caber em um quarto do período).
+bool hbridge_configure(uint32_t ch, uint32_t gpio, uint32_t freq_hz, uint32_t dead_ns);
+
+// Refaz divisor, TOP e tempo morto com o clk_sys atual; as saídas ficam no nível 0
+// até o próximo hbridge_set_level
+bool hbridge_retime(uint32_t ch);
+
+// Volta o slice ao modo normal (sem inversão, contagem crescente) com as saídas em nível baixo
+void hbridge_disable(uint32_t ch);
+
+// Aplica o nível da saída principal se o GPIO for a principal de uma meia ponte ativa
+bool hbridge_set_level(uint32_t gpio, uint16_t level);
+
+// Canal dono do GPIO como saída complementar, ou -1
+int hbridge_complement_owner(uint32_t gpio);
+
+const hbridge_t *hbridge_get(uint32_t ch);
+
+// Palavra do CC com as duas comparações: a principal em level e a complementar (invertida)
+// dead ticks acima, limitada a top + 1 (complementar sempre baixa)
+static inline uint32_t hbridge_cc_word(uint32_t primary_chan_b, uint16_t level, uint16_t dead, uint16_t top)
+{
+    uint32_t comp = (uint32_t)level + dead;
+    if (comp > top + 1u)
+    {
+        comp = top + 1u;
+    }
+    return primary_chan_b ? ((uint32_t)level << 16) | comp : (comp << 16) | level;
+}
+
+#endif
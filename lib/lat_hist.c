@@ -0,0 +1,30 @@
+#include "lat_hist.h"
+
+void lat_hist_record(lat_hist_t *h, uint32_t us)
+{
+    uint32_t b = us ? 31 - __builtin_clz(us) : 0;
+    h->count[b < LAT_HIST_BUCKETS ? b : LAT_HIST_BUCKETS - 1]++;
+    h->total++;
+    h->max_us = us > h->max_us ? us : h->max_us;
+}
+
+uint32_t lat_hist_percentile(const lat_hist_t *h, uint32_t permille)
+{
+    // Menor número de amostras que precisa estar abaixo do percentil, arredondado para cima
+    uint64_t need = ((uint64_t)h->total * permille + 999) / 1000;
+    uint64_t seen = 0;
+    if (h->total == 0)
+    {
+        return 0;
+    }
+    for (uint32_t b = 0; b < LAT_HIST_BUCKETS; b++)
+    {
+        seen += h->count[b];
+        if (seen >= need && seen > 0)
+        {
+            uint32_t upper = (2u << b) - 1;
+            return upper < h->max_us ? upper : h->max_us;
+        }
+    }
+    return h->max_us;
+}
@@ -0,0 +1,24 @@
+#ifndef LAT_HIST_H
+#define LAT_HIST_H
+
+#include <stdint.h>
+
+// Histograma de latências em faixas logarítmicas de base 2: a faixa i conta valores em
+// [2^i, 2^(i+1)) us (a faixa 0 inclui o zero). Registrar é só um clz e um incremento, então
+// pode ser feito em interrupção. Sem dependência do SDK, para ser usado também no host.
+
+#define LAT_HIST_BUCKETS 24 // Até ~16 s
+
+typedef struct
+{
+    uint32_t count[LAT_HIST_BUCKETS];
+    uint32_t total;
+    uint32_t max_us;
+} lat_hist_t;
+
+void lat_hist_record(lat_hist_t *h, uint32_t us);
+
+// Limite superior da faixa que contém o percentil (em milésimos: 500, 990, 999), limitado ao máximo
+uint32_t lat_hist_percentile(const lat_hist_t *h, uint32_t permille);
+
+#endif
@@ -0,0 +1,63 @@
+#include <math.h>
+#include "led_matrix.h"
+
+// Linhas pares da direita para a esquerda a partir do LED 24, ímpares no sentido contrário
+const uint8_t led_matrix_index[LED_MATRIX_COUNT] = {
+    24, 23, 22, 21, 20,
+    15, 16, 17, 18, 19,
+    14, 13, 12, 11, 10,
+    5, 6, 7, 8, 9,
+    4, 3, 2, 1, 0,
+};
+
+static uint8_t luts[2][256];
+const uint8_t *volatile led_matrix_lut = luts[0];
+
+void led_matrix_set_brightness(uint16_t permille, uint16_t gamma_milli)
+{
+    uint8_t *next = led_matrix_lut == luts[0] ? luts[1] : luts[0];
+    if (permille > 1000)
+    {
+        permille = 1000;
+    }
+    for (uint32_t v = 0; v < 256; v++)
+    {
+        if (gamma_milli == 0 || gamma_milli == 1000)
+        {
+            // Truncado como a multiplicação por float que este caminho substitui
+            next[v] = (uint8_t)((v * permille) / 1000);
+        }
+        else
+        {
+            float y = powf(v / 255.0f, gamma_milli / 1000.0f) * 255.0f;
+            next[v] = (uint8_t)(y * permille / 1000);
+        }
+    }
+    led_matrix_lut = next;
+}
+
+void led_matrix_draw_argb(pixel_t *fb, const uint32_t frame[LED_MATRIX_COUNT])
+{
+    const uint8_t *lut = led_matrix_lut; // Uma só tabela no quadro inteiro
+    for (uint32_t i = 0; i < LED_MATRIX_COUNT; i++)
+    {
+        uint32_t argb = frame[i];
+        pixel_t *p = &fb[led_matrix_index[i]];
+        p->R = lut[(argb >> 16) & 0xFF];
+        p->G = lut[(argb >> 8) & 0xFF];
+        p->B = lut[argb & 0xFF];
+    }
+}
+
+void led_matrix_draw_rgb(pixel_t *fb, const int frame[LED_MATRIX_ROWS][LED_MATRIX_COLS][3])
+{
+    const uint8_t *lut = led_matrix_lut;
+    for (uint32_t i = 0; i < LED_MATRIX_COUNT; i++)
+    {
+        const int *c = frame[i / LED_MATRIX_COLS][i % LED_MATRIX_COLS];
+        pixel_t *p = &fb[led_matrix_index[i]];
+        p->R = lut[c[0] & 0xFF];
+        p->G = lut[c[1] & 0xFF];
+        p->B = lut[c[2] & 0xFF];
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef LED_MATRIX_H
+#define LED_MATRIX_H
+
+#include <stdint.h>
+
+// Framebuffer da matriz 5x5 de WS2812, sem dependências do SDK para poder ser comparado no host.
+// Os pixels ficam em GRB compacto, na ordem da fita (serpentina), prontos para a PIO; a posição
+// de cada pixel vem de uma tabela e o brilho de uma tabela de 256 entradas, sem float nem cópias.
+
+#define LED_MATRIX_ROWS 5
+#define LED_MATRIX_COLS 5
+#define LED_MATRIX_COUNT (LED_MATRIX_ROWS * LED_MATRIX_COLS)
+
+// Brilho padrão: o mesmo 1% que desenhaMatriz aplicava
+#define LED_MATRIX_DEFAULT_BRIGHTNESS 10 // Milésimos
+
+// Definição de pixel GRB
+struct pixel_t
+{
+    uint8_t G, R, B; // Três valores de 8-bits compõem um pixel.
+};
+typedef struct pixel_t pixel_t;
+
+// Posição na fita de cada pixel, em ordem de linha (linha * 5 + coluna)
+extern const uint8_t led_matrix_index[LED_MATRIX_COUNT];
+
+// Brilho (e gamma) aplicado a cada componente: aponta para uma de duas tabelas de 256 entradas.
+// A nova tabela é montada na outra e entra no lugar com uma só escrita do ponteiro, então a
+// interrupção da animação sempre lê uma tabela inteira, a antiga ou a nova.
+extern const uint8_t *volatile led_matrix_lut;
+
+// Recalcula a tabela: brilho em milésimos (0-1000), gamma em milésimos (1000 = linear).
+// Chamada fora da interrupção que desenha os quadros.
+void led_matrix_set_brightness(uint16_t permille, uint16_t gamma_milli);
+
+// Escreve um pixel; cor em 0xAARRGGBB (o alfa é ignorado)
+static inline void led_matrix_put(pixel_t *fb, uint32_t row, uint32_t col, uint32_t argb)
+{
+    pixel_t *p = &fb[led_matrix_index[row * LED_MATRIX_COLS + col]];
+    const uint8_t *lut = led_matrix_lut;
+    p->R = lut[(argb >> 16) & 0xFF];
+    p->G = lut[(argb >> 8) & 0xFF];
+    p->B = lut[argb & 0xFF];
+}
+
+// Quadro inteiro em ARGB, em ordem de linha, direto no framebuffer
+void led_matrix_draw_argb(pixel_t *fb, const uint32_t frame[LED_MATRIX_COUNT]);
+
+// Quadro em componentes [linha][coluna][r, g, b] (formato de desenhaMatriz)
+void led_matrix_draw_rgb(pixel_t *fb, const int frame[LED_MATRIX_ROWS][LED_MATRIX_COLS][3]);
+
+#endif
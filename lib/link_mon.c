@@ -0,0 +1,180 @@
+#include "link_mon.h"
+
+// Peso da amostra nova na média móvel: 1/4
+#define EWMA_SHIFT 2
+// As médias são guardadas com 4 bits de fração: o deslocamento arredonda para baixo, e em
+// unidades inteiras a média parava até 3 unidades abaixo de uma entrada constante
+#define EWMA_FRAC 4
+
+static const link_mon_thresholds_t default_thresholds = {
+    .rtt_fair_ms = 150,
+    .rtt_poor_ms = 500,
+    .rtt_hyst_pct = 20,
+    .rssi_fair_dbm = -67,
+    .rssi_poor_dbm = -75,
+    .rssi_hyst_db = 3,
+};
+
+// Com enlace ruim a captura do ADC é a primeira a ceder, deixando a fila livre para os comandos
+static const link_mon_policy_t default_policy[LINK_LEVELS] = {
+    [LINK_GOOD] = {.interval_mult = 1, .adc_decimate = 1, .adc_in_flight = 2},
+    [LINK_FAIR] = {.interval_mult = 2, .adc_decimate = 2, .adc_in_flight = 1},
+    [LINK_POOR] = {.interval_mult = 4, .adc_decimate = 4, .adc_in_flight = 1},
+};
+
+static const char *const level_names[LINK_LEVELS] = {"bom", "razoavel", "ruim"};
+
+static link_mon_thresholds_t th;
+static link_mon_policy_t policy[LINK_LEVELS];
+static link_mon_stats_t stats;
+static int32_t rtt_q;  // Média do RTT em ms x 16
+static int32_t rssi_q; // Média do RSSI em dBm x 16; 0 antes da primeira leitura
+static link_level_t rtt_level;
+static link_level_t rssi_level;
+static bool changed;
+
+void link_mon_init(void)
+{
+    th = default_thresholds;
+    for (int i = 0; i < LINK_LEVELS; i++)
+    {
+        policy[i] = default_policy[i];
+    }
+    stats = (link_mon_stats_t){0};
+    rtt_q = rssi_q = 0;
+    rtt_level = LINK_GOOD;
+    rssi_level = LINK_GOOD;
+    changed = false;
+}
+
+// Passo da média em ponto fixo e valor inteiro arredondado ao mais próximo (metades para longe do zero)
+static int32_t ewma_step(int32_t *q, int32_t sample)
+{
+    *q += (sample * (1 << EWMA_FRAC) - *q) >> EWMA_SHIFT;
+    int32_t half = 1 << (EWMA_FRAC - 1);
+    return (*q + (*q < 0 ? -half : half)) / (1 << EWMA_FRAC);
+}
+
+// Nível de uma métrica que cresce quando o enlace piora. Sobe pelos limiares, desce pelos
+// limiares menos a histerese.
+static link_level_t classify(link_level_t cur, int32_t bad, int32_t fair, int32_t poor, int32_t hyst_fair, int32_t hyst_poor)
+{
+    link_level_t up = bad >= poor ? LINK_POOR : bad >= fair ? LINK_FAIR : LINK_GOOD;
+    link_level_t down = bad >= poor - hyst_poor ? LINK_POOR : bad >= fair - hyst_fair ? LINK_FAIR : LINK_GOOD;
+    if (up > cur)
+    {
+        return up;
+    }
+    return down < cur ? down : cur;
+}
+
+static void update_level(void)
+{
+    link_level_t level = rtt_level > rssi_level ? rtt_level : rssi_level;
+    if (level != stats.level)
+    {
+        stats.level = level;
+        stats.changes++;
+        changed = true;
+    }
+}
+
+static void rtt_sample(uint32_t ms)
+{
+    stats.rtt_last_ms = ms;
+    stats.rtt_max_ms = ms > stats.rtt_max_ms ? ms : stats.rtt_max_ms;
+    if (stats.samples + stats.timeouts == 0)
+    {
+        rtt_q = (int32_t)ms * (1 << EWMA_FRAC);
+    }
+    stats.rtt_avg_ms = (uint32_t)ewma_step(&rtt_q, (int32_t)ms);
+    rtt_level = classify(rtt_level, stats.rtt_avg_ms, th.rtt_fair_ms, th.rtt_poor_ms, th.rtt_fair_ms * th.rtt_hyst_pct / 100,
+                         th.rtt_poor_ms * th.rtt_hyst_pct / 100);
+    update_level();
+}
+
+void link_mon_rtt(uint32_t ms)
+{
+    rtt_sample(ms);
+    stats.samples++;
+}
+
+void link_mon_timeout(void)
+{
+    rtt_sample(2 * th.rtt_poor_ms);
+    stats.timeouts++;
+}
+
+void link_mon_rssi(int32_t dbm)
+{
+    if (dbm >= 0)
+    {
+        return; // Sem associação o driver devolve 0
+    }
+    if (rssi_q == 0)
+    {
+        rssi_q = dbm * (1 << EWMA_FRAC);
+    }
+    stats.rssi_dbm = ewma_step(&rssi_q, dbm);
+    rssi_level = classify(rssi_level, -stats.rssi_dbm, -th.rssi_fair_dbm, -th.rssi_poor_dbm, th.rssi_hyst_db, th.rssi_hyst_db);
+    update_level();
+}
+
+link_level_t link_mon_level(void)
+{
+    return stats.level;
+}
+
+const char *link_mon_level_name(link_level_t level)
+{
+    return level < LINK_LEVELS ? level_names[level] : "?";
+}
+
+const link_mon_policy_t *link_mon_policy(void)
+{
+    return &policy[stats.level];
+}
+
+bool link_mon_poll_changed(void)
+{
+    bool c = changed;
+    changed = false;
+    return c;
+}
+
+bool link_mon_set_thresholds(const link_mon_thresholds_t *t)
+{
+    if (t->rtt_fair_ms == 0 || t->rtt_poor_ms <= t->rtt_fair_ms || t->rtt_hyst_pct >= 100 || t->rssi_poor_dbm >= t->rssi_fair_dbm ||
+        t->rssi_fair_dbm >= 0 || t->rssi_hyst_db < 0)
+    {
+        return false;
+    }
+    th = *t;
+    return true;
+}
+
+const link_mon_thresholds_t *link_mon_thresholds(void)
+{
+    return &th;
+}
+
+bool link_mon_set_policy(link_level_t level, const link_mon_policy_t *p)
+{
+    if (level >= LINK_LEVELS || p->interval_mult < 1 || p->interval_mult > LINK_MON_MULT_MAX || p->adc_decimate < 1 ||
+        p->adc_decimate > LINK_MON_DECIMATE_MAX || p->adc_in_flight < 1 || p->adc_in_flight > LINK_MON_IN_FLIGHT_MAX)
+    {
+        return false;
+    }
+    policy[level] = *p;
+    return true;
+}
+
+const link_mon_policy_t *link_mon_policy_for(link_level_t level)
+{
+    return &policy[level];
+}
+
+void link_mon_get_stats(link_mon_stats_t *out)
+{
+    *out = stats;
+}
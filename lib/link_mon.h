@@ -0,0 +1,77 @@
+#ifndef LINK_MON_H
+#define LINK_MON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Qualidade do enlace a partir do RTT do MQTT (tempo até o PUBACK de uma publicação QoS 1)
+// e do RSSI do Wi-Fi. Cada métrica passa por uma média móvel exponencial e é classificada em
+// três níveis; o nível do enlace é o pior dos dois. Para piorar basta a média passar do
+// limiar; para melhorar ela precisa voltar abaixo do limiar menos a histerese, então o nível
+// não oscila em torno de um limiar. Cada nível tem uma política para a telemetria de saída,
+// aplicada pelo laço principal. Sem dependência do SDK.
+
+typedef enum
+{
+    LINK_GOOD = 0,
+    LINK_FAIR,
+    LINK_POOR,
+    LINK_LEVELS,
+} link_level_t;
+
+typedef struct
+{
+    uint32_t rtt_fair_ms;
+    uint32_t rtt_poor_ms;
+    uint32_t rtt_hyst_pct;  // Histerese do RTT, em % do limiar
+    int32_t rssi_fair_dbm;
+    int32_t rssi_poor_dbm;
+    int32_t rssi_hyst_db;
+} link_mon_thresholds_t;
+
+typedef struct
+{
+    uint8_t interval_mult;  // Intervalos da telemetria periódica multiplicados por este fator
+    uint8_t adc_decimate;   // Publica 1 de cada N blocos da captura do ADC
+    uint8_t adc_in_flight;  // Publicações da captura aguardando envio
+} link_mon_policy_t;
+
+#define LINK_MON_MULT_MAX 16
+#define LINK_MON_DECIMATE_MAX 16
+#define LINK_MON_IN_FLIGHT_MAX 4
+
+typedef struct
+{
+    link_level_t level;
+    uint32_t rtt_avg_ms;    // Média móvel
+    uint32_t rtt_last_ms;
+    uint32_t rtt_max_ms;
+    int32_t rssi_dbm;       // Média móvel; 0 antes da primeira leitura
+    uint32_t samples;       // RTTs medidos
+    uint32_t timeouts;      // Sondas sem PUBACK no prazo
+    uint32_t changes;       // Trocas de nível
+} link_mon_stats_t;
+
+void link_mon_init(void);
+
+// Amostras. Uma sonda perdida entra como RTT de duas vezes o limiar ruim.
+void link_mon_rtt(uint32_t ms);
+void link_mon_timeout(void);
+void link_mon_rssi(int32_t dbm);
+
+link_level_t link_mon_level(void);
+const char *link_mon_level_name(link_level_t level);
+const link_mon_policy_t *link_mon_policy(void);
+
+// Retorna true uma vez depois de cada troca de nível
+bool link_mon_poll_changed(void);
+
+// Limiares precisam estar em ordem (ruim pior que razoável); retorna false sem mudar nada
+bool link_mon_set_thresholds(const link_mon_thresholds_t *t);
+const link_mon_thresholds_t *link_mon_thresholds(void);
+bool link_mon_set_policy(link_level_t level, const link_mon_policy_t *p);
+const link_mon_policy_t *link_mon_policy_for(link_level_t level);
+
+void link_mon_get_stats(link_mon_stats_t *out);
+
+#endif
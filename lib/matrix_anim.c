@@ -0,0 +1,222 @@
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/sync.h"
+#include "matrix_anim.h"
+
+// Cores em ARGB; o brilho final vem da tabela de led_matrix
+#define OPAQUE(rgb) (0xFF000000u | (rgb))
+#define GREEN OPAQUE(0x00FF00)
+#define BLUE OPAQUE(0x0000FF)
+#define RED OPAQUE(0xFF0000)
+#define YELLOW OPAQUE(0xFFA000)
+#define PX(row, col) [(row) * LED_MATRIX_COLS + (col)]
+
+// Estado da conexão na linha 1 (entre as barras verde e azul)
+static const uint32_t connecting_frames[][LED_MATRIX_COUNT] = {
+    {PX(1, 0) = YELLOW}, {PX(1, 1) = YELLOW}, {PX(1, 2) = YELLOW}, {PX(1, 3) = YELLOW}, {PX(1, 4) = YELLOW},
+    {PX(1, 3) = YELLOW}, {PX(1, 2) = YELLOW}, {PX(1, 1) = YELLOW},
+};
+static const uint32_t connected_frames[][LED_MATRIX_COUNT] = {
+    {PX(1, 0) = GREEN, PX(1, 1) = GREEN, PX(1, 2) = GREEN, PX(1, 3) = GREEN, PX(1, 4) = GREEN},
+    {PX(1, 1) = GREEN, PX(1, 2) = GREEN, PX(1, 3) = GREEN},
+    {PX(1, 2) = GREEN},
+};
+static const uint32_t link_lost_frames[][LED_MATRIX_COUNT] = {
+    {PX(1, 0) = RED, PX(1, 2) = RED, PX(1, 4) = RED},
+    {0},
+};
+
+// Alerta na linha 3 (entre as barras azul e vermelha)
+static const uint32_t failsafe_frames[][LED_MATRIX_COUNT] = {
+    {PX(3, 0) = RED, PX(3, 1) = RED, PX(3, 2) = RED, PX(3, 3) = RED, PX(3, 4) = RED},
+    {0},
+};
+
+const matrix_anim_seq_t matrix_seq_connecting = {connecting_frames, count_of(connecting_frames), 3, true};
+const matrix_anim_seq_t matrix_seq_connected = {connected_frames, count_of(connected_frames), 8, false};
+const matrix_anim_seq_t matrix_seq_link_lost = {link_lost_frames, count_of(link_lost_frames), 10, true};
+const matrix_anim_seq_t matrix_seq_failsafe = {failsafe_frames, count_of(failsafe_frames), 6, false};
+
+// Linha e cor de cada barra, como desenhavam draw_matrix_green/blue/red
+static const uint8_t bar_row[MATRIX_ANIM_BARS] = {0, 2, 4};
+static const uint32_t bar_color[MATRIX_ANIM_BARS] = {0x00FF00, 0x0000FF, 0xFF0000};
+
+typedef struct
+{
+    const matrix_anim_seq_t *seq;
+    uint16_t frame;
+    uint16_t tick;
+} layer_t;
+
+static layer_t layers[MATRIX_LAYER_COUNT];
+static volatile uint16_t bar_target[MATRIX_ANIM_BARS]; // Em 1/256 de LED (0-1280)
+static uint16_t bar_level[MATRIX_ANIM_BARS];
+static uint16_t fade_step;
+
+static pixel_t fb[LED_MATRIX_COUNT];
+static uint32_t words[LED_MATRIX_COUNT * 3]; // Um byte por palavra, alinhado ao bit 31 (saída MSB primeiro)
+static int dma_ch = -1;
+static repeating_timer_t timer;
+static bool running;
+static uint32_t last_tick_us;
+static matrix_anim_stats_t stats;
+
+// Mistura src sobre dst com a opacidade de src
+static inline uint32_t blend(uint32_t dst, uint32_t src)
+{
+    uint32_t a = src >> 24;
+    if (a == 0xFF)
+    {
+        return src;
+    }
+    uint32_t out = 0;
+    for (int shift = 0; shift < 24; shift += 8)
+    {
+        uint32_t s = (src >> shift) & 0xFF;
+        uint32_t d = (dst >> shift) & 0xFF;
+        out |= (((s * (a + 1)) + (d * (256 - (a + 1)))) >> 8) << shift;
+    }
+    return out;
+}
+
+static void compose(void)
+{
+    uint32_t px[LED_MATRIX_COUNT] = {0};
+
+    // Barras: LEDs inteiros acesos e o próximo com a fração como opacidade
+    for (int b = 0; b < MATRIX_ANIM_BARS; b++)
+    {
+        uint16_t target = bar_target[b];
+        uint16_t *lvl = &bar_level[b];
+        *lvl = *lvl < target ? MIN(*lvl + fade_step, target) : MAX((int)*lvl - fade_step, (int)target);
+        for (int col = 0; col < LED_MATRIX_COLS; col++)
+        {
+            int32_t part = (int32_t)*lvl - col * 256;
+            uint32_t a = part >= 256 ? 255 : (part > 0 ? part : 0);
+            px[bar_row[b] * LED_MATRIX_COLS + col] = blend(0, (a << 24) | bar_color[b]);
+        }
+    }
+
+    // Camadas de sequência por cima
+    for (int l = 0; l < MATRIX_LAYER_COUNT; l++)
+    {
+        layer_t *layer = &layers[l];
+        const matrix_anim_seq_t *seq = layer->seq;
+        if (seq == NULL)
+        {
+            continue;
+        }
+        const uint32_t *frame = seq->frames[layer->frame];
+        for (int i = 0; i < LED_MATRIX_COUNT; i++)
+        {
+            if (frame[i] >> 24)
+            {
+                px[i] = blend(px[i], frame[i]);
+            }
+        }
+        if (++layer->tick >= seq->ticks)
+        {
+            layer->tick = 0;
+            if (++layer->frame >= seq->count)
+            {
+                layer->frame = 0;
+                if (!seq->loop)
+                {
+                    layer->seq = NULL;
+                }
+            }
+        }
+    }
+
+    led_matrix_draw_argb(fb, px);
+    for (int i = 0; i < LED_MATRIX_COUNT; i++)
+    {
+        words[i * 3] = (uint32_t)fb[i].G << 24;
+        words[i * 3 + 1] = (uint32_t)fb[i].R << 24;
+        words[i * 3 + 2] = (uint32_t)fb[i].B << 24;
+    }
+}
+
+static bool tick_cb(repeating_timer_t *rt)
+{
+    uint32_t now = time_us_32();
+    uint32_t period_us = 1000000 / stats.fps;
+    if (last_tick_us)
+    {
+        int32_t jitter = (int32_t)(now - last_tick_us) - (int32_t)period_us;
+        jitter = jitter < 0 ? -jitter : jitter;
+        stats.jitter_max_us = MAX(stats.jitter_max_us, jitter);
+    }
+    last_tick_us = now;
+
+    // A transmissão leva ~1 ms; se ainda estiver em andamento o quadro é descartado
+    if (dma_channel_is_busy(dma_ch))
+    {
+        stats.overruns++;
+        return true;
+    }
+    compose();
+    dma_channel_set_read_addr(dma_ch, words, true);
+    stats.frames++;
+    stats.compose_max_us = MAX(stats.compose_max_us, time_us_32() - now);
+    return true;
+}
+
+bool matrix_anim_set_fps(uint32_t fps)
+{
+    if (fps < MATRIX_ANIM_FPS_MIN || fps > MATRIX_ANIM_FPS_MAX)
+    {
+        return false;
+    }
+    if (running)
+    {
+        cancel_repeating_timer(&timer);
+    }
+    stats.fps = fps;
+    fade_step = MAX(1u, (LED_MATRIX_COLS * 256u * 1000u) / (MATRIX_ANIM_FADE_MS * fps));
+    last_tick_us = 0;
+    stats.jitter_max_us = 0;
+    // Atraso negativo: período entre inícios de quadro, sem acumular o tempo de composição
+    running = add_repeating_timer_us(-(int64_t)(1000000 / fps), tick_cb, NULL, &timer);
+    return running;
+}
+
+bool matrix_anim_start(PIO pio, uint sm, uint32_t fps)
+{
+    dma_ch = dma_claim_unused_channel(false);
+    if (dma_ch < 0)
+    {
+        return false;
+    }
+    dma_channel_config c = dma_channel_get_default_config(dma_ch);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(dma_ch, &c, &pio->txf[sm], words, count_of(words), false);
+    return matrix_anim_set_fps(fps);
+}
+
+void matrix_anim_set_bar(uint32_t bar, uint32_t permille)
+{
+    bar_target[bar] = (uint16_t)((MIN(permille, 1000u) * LED_MATRIX_COLS * 256u) / 1000u);
+}
+
+void matrix_anim_play(matrix_layer_t layer, const matrix_anim_seq_t *seq)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    layers[layer] = (layer_t){.seq = seq};
+    restore_interrupts(ints);
+}
+
+void matrix_anim_stop(matrix_layer_t layer)
+{
+    matrix_anim_play(layer, NULL);
+}
+
+void matrix_anim_get_stats(matrix_anim_stats_t *out)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    *out = stats;
+    restore_interrupts(ints);
+}
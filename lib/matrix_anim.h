@@ -0,0 +1,66 @@
+#ifndef MATRIX_ANIM_H
+#define MATRIX_ANIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/pio.h"
+#include "led_matrix.h"
+
+// Animações da matriz de LEDs em taxa de quadros fixa. Um timer de hardware compõe as camadas
+// no framebuffer (barras dos canais com transição suave, sequências de quadros pré-calculadas
+// para estado da conexão e alertas) e dispara uma única transmissão por DMA para a PIO.
+// Como tudo acontece na interrupção do alarme, que tem prioridade sobre o processamento do
+// lwIP, o ritmo dos quadros não depende do tráfego MQTT.
+
+#define MATRIX_ANIM_FPS_MIN 10
+#define MATRIX_ANIM_FPS_MAX 60
+#define MATRIX_ANIM_DEFAULT_FPS 30
+#define MATRIX_ANIM_FADE_MS 250 // Tempo de uma barra para percorrer a escala toda
+
+#define MATRIX_ANIM_BARS 3
+
+// Camadas de sequência, da mais baixa para a mais alta (as barras ficam por baixo de todas)
+typedef enum
+{
+    MATRIX_LAYER_STATUS = 0, // Estado da conexão
+    MATRIX_LAYER_ALERT,      // Falha segura, avisos
+    MATRIX_LAYER_COUNT,
+} matrix_layer_t;
+
+// Sequência de quadros ARGB em ordem de linha; o alfa de cada pixel é a opacidade sobre as camadas de baixo
+typedef struct
+{
+    const uint32_t (*frames)[LED_MATRIX_COUNT];
+    uint8_t count;
+    uint8_t ticks;     // Quadros do motor por quadro da sequência
+    bool loop;         // Senão a camada some ao fim
+} matrix_anim_seq_t;
+
+typedef struct
+{
+    uint32_t fps;
+    uint32_t frames;     // Quadros transmitidos
+    uint32_t overruns;   // Quadros descartados com a transmissão anterior em andamento
+    uint32_t compose_max_us;
+    int32_t jitter_max_us;
+} matrix_anim_stats_t;
+
+// Sequências prontas
+extern const matrix_anim_seq_t matrix_seq_connecting;
+extern const matrix_anim_seq_t matrix_seq_connected;
+extern const matrix_anim_seq_t matrix_seq_link_lost;
+extern const matrix_anim_seq_t matrix_seq_failsafe;
+
+// Assume a máquina PIO já iniciada por npInit e passa a transmitir a cada quadro
+bool matrix_anim_start(PIO pio, uint sm, uint32_t fps);
+bool matrix_anim_set_fps(uint32_t fps);
+
+// Nível da barra de um canal (0-1000); a barra desliza até ele
+void matrix_anim_set_bar(uint32_t bar, uint32_t permille);
+
+void matrix_anim_play(matrix_layer_t layer, const matrix_anim_seq_t *seq);
+void matrix_anim_stop(matrix_layer_t layer);
+
+void matrix_anim_get_stats(matrix_anim_stats_t *out);
+
+#endif
@@ -0,0 +1,105 @@
+#include <string.h>
+#include <ctype.h>
+#include "mqtt_group.h"
+#include "flash_store.h"
+
+typedef struct
+{
+    uint32_t count;
+    char names[MQTT_GROUP_MAX][MQTT_GROUP_NAME_LEN];
+} group_list_t;
+
+static group_list_t list;
+
+static int find(const char *name, size_t len)
+{
+    for (uint32_t i = 0; i < list.count; i++)
+    {
+        if (strncmp(list.names[i], name, len) == 0 && list.names[i][len] == '\0')
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void save(void)
+{
+    flash_store_save(FLASH_STORE_SLOT_GROUPS, &list, sizeof(list));
+}
+
+void mqtt_group_init(void)
+{
+    if (!flash_store_load(FLASH_STORE_SLOT_GROUPS, &list, sizeof(list)) || list.count > MQTT_GROUP_MAX)
+    {
+        memset(&list, 0, sizeof(list));
+    }
+}
+
+bool mqtt_group_valid_name(const char *name)
+{
+    size_t len = strlen(name);
+    if (len == 0 || len >= MQTT_GROUP_NAME_LEN)
+    {
+        return false;
+    }
+    // Nada de '/', '+' ou '#', que mudariam o sentido do filtro de assinatura
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!isalnum((unsigned char)name[i]) && name[i] != '-' && name[i] != '_')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool mqtt_group_add(const char *name)
+{
+    if (!mqtt_group_valid_name(name) || list.count >= MQTT_GROUP_MAX)
+    {
+        return false;
+    }
+    if (find(name, strlen(name)) >= 0)
+    {
+        return true;
+    }
+    strcpy(list.names[list.count++], name);
+    save();
+    return true;
+}
+
+bool mqtt_group_remove(const char *name)
+{
+    int i = find(name, strlen(name));
+    if (i < 0)
+    {
+        return false;
+    }
+    list.count--;
+    memmove(list.names[i], list.names[i + 1], (list.count - i) * MQTT_GROUP_NAME_LEN);
+    memset(list.names[list.count], 0, MQTT_GROUP_NAME_LEN);
+    save();
+    return true;
+}
+
+void mqtt_group_clear(void)
+{
+    memset(&list, 0, sizeof(list));
+    flash_store_erase(FLASH_STORE_SLOT_GROUPS);
+}
+
+bool mqtt_group_member(const char *name, size_t len)
+{
+    return len > 0 && len < MQTT_GROUP_NAME_LEN && find(name, len) >= 0;
+}
+
+size_t mqtt_group_count(void)
+{
+    return list.count;
+}
+
+const char *mqtt_group_name(size_t i)
+{
+    return i < list.count ? list.names[i] : NULL;
+}
@@ -0,0 +1,33 @@
+#ifndef MQTT_GROUP_H
+#define MQTT_GROUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Grupos de endereçamento: cada placa pertence a até MQTT_GROUP_MAX grupos e aceita os
+// comandos publicados em "/grp/<nome>/<tópico>", além de "/all/<tópico>" para todas.
+// A lista fica na flash e pode ser mudada em funcionamento; quem recebe confere se o
+// grupo do tópico é seu antes de aplicar.
+
+#define MQTT_GROUP_MAX 8
+#define MQTT_GROUP_NAME_LEN 16 // Com o terminador
+
+#define MQTT_GROUP_PREFIX "/grp"
+#define MQTT_BROADCAST_PREFIX "/all"
+
+// Carrega a lista da flash (vazia se não houver)
+void mqtt_group_init(void);
+
+// Entra ou sai de um grupo e grava a lista. Nomes: letras, dígitos, '-' e '_'.
+bool mqtt_group_add(const char *name);
+bool mqtt_group_remove(const char *name);
+void mqtt_group_clear(void);
+
+bool mqtt_group_valid_name(const char *name);
+bool mqtt_group_member(const char *name, size_t len);
+
+size_t mqtt_group_count(void);
+const char *mqtt_group_name(size_t i);
+
+#endif
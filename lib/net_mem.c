@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <string.h>
+#include "lwip/memp.h"
+#include "lwip/stats.h"
+#include "net_mem.h"
+
+#if !MEM_STATS || !MEMP_STATS
+#error "net_mem precisa de MEM_STATS e MEMP_STATS (lwipopts.h)"
+#endif
+
+// Nomes na mesma ordem do enum memp_t, montados pela mesma lista que o lwIP usa
+static const char *const pool_names[MEMP_MAX] = {
+#define LWIP_MEMPOOL(name, num, size, desc) #name,
+#include "lwip/priv/memp_std.h"
+};
+
+// Entradas do resumo publicado, além do heap
+static const char *const summary_pools[] = {"PBUF_POOL", "PBUF", "TCP_SEG", "TCP_PCB"};
+
+static struct stats_mem *entry(size_t i)
+{
+    return i == 0 ? &lwip_stats.mem : lwip_stats.memp[i - 1];
+}
+
+size_t net_mem_count(void)
+{
+    return 1 + MEMP_MAX;
+}
+
+bool net_mem_get(size_t i, net_mem_pool_t *out)
+{
+    if (i >= net_mem_count() || entry(i) == NULL)
+    {
+        return false;
+    }
+    const struct stats_mem *s = entry(i);
+    *out = (net_mem_pool_t){
+        .name = i == 0 ? "HEAP" : pool_names[i - 1],
+        .avail = s->avail,
+        .used = s->used,
+        .max = s->max,
+        .err = s->err,
+    };
+    return true;
+}
+
+const char *net_mem_profile(void)
+{
+    switch (LWIP_PROFILE)
+    {
+    case LWIP_PROFILE_LOW_RAM:
+        return "low_ram";
+    case LWIP_PROFILE_THROUGHPUT:
+        return "throughput";
+    case LWIP_PROFILE_TLS:
+        return "tls";
+    default:
+        return "default";
+    }
+}
+
+static bool is_tight(const net_mem_pool_t *p)
+{
+    return p->err > 0 || (uint64_t)p->max * 1000 > (uint64_t)p->avail * NET_MEM_TIGHT_PERMILLE;
+}
+
+uint32_t net_mem_tight(void)
+{
+    uint32_t n = 0;
+    net_mem_pool_t p;
+    for (size_t i = 0; i < net_mem_count(); i++)
+    {
+        if (net_mem_get(i, &p) && p.avail && is_tight(&p))
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+static size_t append(char *buf, size_t size, size_t len, const net_mem_pool_t *p)
+{
+    if (len >= size)
+    {
+        return len;
+    }
+    return len + snprintf(&buf[len], size - len, " %s=%lu/%lu/%lu/%lu", p->name, (unsigned long)p->used,
+                          (unsigned long)p->max, (unsigned long)p->avail, (unsigned long)p->err);
+}
+
+size_t net_mem_format(char *buf, size_t size)
+{
+    net_mem_pool_t p;
+    size_t len = snprintf(buf, size, "profile=%s tight=%lu", net_mem_profile(), (unsigned long)net_mem_tight());
+    if (net_mem_get(0, &p))
+    {
+        len = append(buf, size, len, &p);
+    }
+    for (size_t i = 1; i < net_mem_count(); i++)
+    {
+        for (size_t k = 0; k < sizeof(summary_pools) / sizeof(summary_pools[0]); k++)
+        {
+            if (strcmp(pool_names[i - 1], summary_pools[k]) == 0 && net_mem_get(i, &p))
+            {
+                len = append(buf, size, len, &p);
+            }
+        }
+    }
+    return len < size ? len : size - 1;
+}
+
+void net_mem_reset_peaks(void)
+{
+    for (size_t i = 0; i < net_mem_count(); i++)
+    {
+        struct stats_mem *s = entry(i);
+        if (s)
+        {
+            s->max = s->used;
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef NET_MEM_H
+#define NET_MEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Uso de memória do lwIP: o heap (mem_malloc, de onde saem os pbufs PBUF_RAM do envio TCP) e
+// cada pool fixo (memp, inclusive o PBUF_POOL da recepção), com uso atual, pico e falhas de
+// alocação. Os números são as próprias estatísticas do lwIP (MEM_STATS e MEMP_STATS, ligadas
+// em lwipopts.h), então ler é só copiar contadores. Chamar com o lwIP travado.
+
+// Pico acima desta fração da capacidade (em milésimos) conta como pool sem folga
+#define NET_MEM_TIGHT_PERMILLE 900
+
+typedef struct
+{
+    const char *name;
+    uint32_t avail; // Capacidade (bytes no heap, elementos nos pools)
+    uint32_t used;
+    uint32_t max;   // Pico desde o boot ou desde net_mem_reset_peaks()
+    uint32_t err;   // Alocações recusadas
+} net_mem_pool_t;
+
+// Entrada 0 é o heap; as demais são os pools na ordem do lwIP
+size_t net_mem_count(void);
+bool net_mem_get(size_t i, net_mem_pool_t *out);
+
+// Perfil de lwipopts.h compilado ("default", "low_ram", "throughput", "tls")
+const char *net_mem_profile(void);
+
+// Quantas entradas passaram da margem ou já recusaram alocação
+uint32_t net_mem_tight(void);
+
+// Resumo em texto: perfil, folga e "nome=uso/pico/capacidade/falhas" das entradas
+// que pesam no dimensionamento (heap, PBUF_POOL, PBUF, TCP_SEG, TCP_PCB)
+size_t net_mem_format(char *buf, size_t size);
+
+// Recomeça os picos a partir do uso atual
+void net_mem_reset_peaks(void);
+
+#endif
@@ -0,0 +1,70 @@
+#include <string.h>
+#include "oled_chart.h"
+
+// Linhas de uma faixa: a primeira fica livre para separar da faixa de cima
+static void lane_rows(const oled_chart_t *c, ssd1306_t *ssd, uint32_t lane, uint8_t *top, uint8_t *bottom)
+{
+    uint8_t h = ssd->height / c->lanes;
+    *top = lane * h + 1;
+    *bottom = lane * h + h - 1;
+}
+
+// Coluna vazia: só o pontilhado dos separadores
+static void clear_column(const oled_chart_t *c, ssd1306_t *ssd, uint8_t x)
+{
+    memset(&ssd->ram_buffer[x * ssd->pages + 1], 0, ssd->pages);
+    if ((x & 3) == 0)
+    {
+        for (uint32_t lane = 1; lane < c->lanes; lane++)
+        {
+            ssd1306_pixel(ssd, x, lane * (ssd->height / c->lanes), true);
+        }
+    }
+}
+
+void oled_chart_begin(oled_chart_t *c, ssd1306_t *ssd, uint32_t lanes)
+{
+    memset(c, 0, sizeof(*c));
+    c->lanes = lanes < 1 ? 1 : (lanes > OLED_CHART_MAX_LANES ? OLED_CHART_MAX_LANES : lanes);
+    for (uint8_t x = 0; x < ssd->width; x++)
+    {
+        clear_column(c, ssd, x);
+    }
+    ssd1306_send_data(ssd);
+}
+
+void oled_chart_push(oled_chart_t *c, ssd1306_t *ssd, const uint16_t *values)
+{
+    uint8_t x = c->head;
+    uint8_t next = (x + 1) % ssd->width;
+
+    clear_column(c, ssd, x);
+    for (uint32_t lane = 0; lane < c->lanes; lane++)
+    {
+        uint8_t top, bottom;
+        lane_rows(c, ssd, lane, &top, &bottom);
+        uint32_t v = values[lane] > OLED_CHART_FULL_SCALE ? OLED_CHART_FULL_SCALE : values[lane];
+        uint8_t y = bottom - (uint8_t)((v * (bottom - top)) / OLED_CHART_FULL_SCALE);
+
+        // Segmento vertical desde a amostra anterior, para o traço não ficar pontilhado nas subidas
+        uint8_t from = c->primed ? c->prev_y[lane] : y;
+        uint8_t y0 = from < y ? from : y;
+        uint8_t y1 = from < y ? y : from;
+        ssd1306_vline(ssd, x, y0, y1, true);
+        c->prev_y[lane] = y;
+    }
+    c->primed = true;
+    clear_column(c, ssd, next);
+
+    if (next > x)
+    {
+        ssd1306_send_columns(ssd, x, next);
+    }
+    else
+    {
+        ssd1306_send_columns(ssd, x, x);
+        ssd1306_send_columns(ssd, next, next);
+    }
+    c->head = next;
+    c->samples++;
+}
@@ -0,0 +1,31 @@
+#ifndef OLED_CHART_H
+#define OLED_CHART_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+// Gráfico de histórico no display, uma coluna por amostra. As colunas são escritas em rodízio
+// na RAM do SSD1306 (varredura, como um osciloscópio): cada amostra envia pelo I2C só a coluna
+// nova e a seguinte apagada, que serve de cursor, em vez do quadro inteiro de 1 KB.
+// Cada canal ocupa uma faixa horizontal do display, com o traço ligando amostras consecutivas.
+
+#define OLED_CHART_MAX_LANES 3
+#define OLED_CHART_FULL_SCALE 1000 // Amostras em milésimos da faixa
+
+typedef struct
+{
+    uint8_t lanes;
+    uint8_t head;                          // Próxima coluna a escrever
+    bool primed;                           // Já existe amostra anterior para ligar o traço
+    uint8_t prev_y[OLED_CHART_MAX_LANES];
+    uint32_t samples;
+} oled_chart_t;
+
+// Limpa o display e desenha os separadores das faixas (um quadro inteiro, só no início)
+void oled_chart_begin(oled_chart_t *c, ssd1306_t *ssd, uint32_t lanes);
+
+// Acrescenta uma amostra por faixa (0-1000) e envia as duas colunas alteradas
+void oled_chart_push(oled_chart_t *c, ssd1306_t *ssd, const uint16_t *values);
+
+#endif
@@ -0,0 +1,77 @@
+#include "pid_ctrl.h"
+
+void pid_ctrl_init(pid_ctrl_t *pid, int32_t kp, int32_t ki, int32_t kd, int32_t out_min, int32_t out_max, uint32_t rate_hz)
+{
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->out_min = out_min;
+    pid->out_max = out_max;
+    pid->rate_hz = rate_hz ? rate_hz : 1;
+    pid_ctrl_reset(pid);
+}
+
+void pid_ctrl_reset(pid_ctrl_t *pid)
+{
+    pid->integ = 0;
+    pid->prev_y = 0;
+    pid->primed = 0;
+}
+
+void pid_ctrl_set_rate(pid_ctrl_t *pid, uint32_t rate_hz)
+{
+    rate_hz = rate_hz ? rate_hz : 1;
+    pid->integ = pid->integ / (int64_t)pid->rate_hz * (int64_t)rate_hz;
+    pid->rate_hz = rate_hz;
+}
+
+int32_t pid_ctrl_step(pid_ctrl_t *pid, int32_t setpoint, int32_t measurement)
+{
+    int64_t min_q = (int64_t)pid->out_min << PID_Q;
+    int64_t max_q = (int64_t)pid->out_max << PID_Q;
+    int32_t err = setpoint - measurement;
+
+    int64_t p = (int64_t)pid->kp * err;
+    int64_t d = 0;
+    if (pid->primed)
+    {
+        d = -(int64_t)pid->kd * (measurement - pid->prev_y) * (int64_t)pid->rate_hz;
+    }
+    pid->prev_y = measurement;
+    pid->primed = 1;
+
+    // O integrador é guardado multiplicado pela frequência: cada passo soma ki*err inteiro e a
+    // divisão só acontece na saída, então erros pequenos a 10 kHz também acumulam.
+    // Integração condicional: não acumula se a saída já está no limite e o erro empurra além dele.
+    int64_t rate = pid->rate_hz;
+    int64_t integ = pid->integ + (int64_t)pid->ki * err;
+    int64_t u = p + integ / rate + d;
+    if ((u > max_q && err > 0) || (u < min_q && err < 0))
+    {
+        u = p + pid->integ / rate + d;
+    }
+    else
+    {
+        pid->integ = integ;
+    }
+
+    // O integrador sozinho nunca passa dos limites da saída
+    if (pid->integ > max_q * rate)
+    {
+        pid->integ = max_q * rate;
+    }
+    else if (pid->integ < min_q * rate)
+    {
+        pid->integ = min_q * rate;
+    }
+
+    if (u > max_q)
+    {
+        u = max_q;
+    }
+    else if (u < min_q)
+    {
+        u = min_q;
+    }
+    return (int32_t)(u >> PID_Q);
+}
@@ -0,0 +1,36 @@
+#ifndef PID_CTRL_H
+#define PID_CTRL_H
+
+#include <stdint.h>
+
+// Núcleo do PID em ponto fixo, sem dependências do SDK para poder ser compilado no host.
+// Medição, setpoint e saída usam a mesma escala de 12 bits (0-4095, a escala do ADC),
+// então um Kp de 1,0 leva um erro de 100% do ADC a 100% de duty.
+
+#define PID_FULL_SCALE 4095
+#define PID_Q 16 // Ganhos em Q16.16
+#define PID_GAIN(x) ((int32_t)((x) * (1 << PID_Q)))
+
+typedef struct
+{
+    int32_t kp, ki, kd;       // Q16.16; ki em 1/s, kd em s
+    int32_t out_min, out_max; // Limites da saída na escala de 12 bits
+    uint32_t rate_hz;         // Frequência do laço
+    int64_t integ;            // Integrador, em Q16 da saída vezes rate_hz (sem truncar a cada passo)
+    int32_t prev_y;
+    uint8_t primed;           // Já existe uma medição anterior para a derivada
+} pid_ctrl_t;
+
+void pid_ctrl_init(pid_ctrl_t *pid, int32_t kp, int32_t ki, int32_t kd, int32_t out_min, int32_t out_max, uint32_t rate_hz);
+
+// Zera o integrador e a derivada (ao habilitar o laço ou trocar o setpoint bruscamente)
+void pid_ctrl_reset(pid_ctrl_t *pid);
+
+// Troca a frequência do laço mantendo a contribuição atual do integrador
+void pid_ctrl_set_rate(pid_ctrl_t *pid, uint32_t rate_hz);
+
+// Um passo do laço. A derivada é sobre a medição (sem salto quando o setpoint muda) e o
+// integrador só acumula enquanto a saída não está saturada no sentido do erro (anti-windup).
+int32_t pid_ctrl_step(pid_ctrl_t *pid, int32_t setpoint, int32_t measurement);
+
+#endif
@@ -0,0 +1,245 @@
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "pid_loop.h"
+
+typedef struct
+{
+    pid_loop_channel_t pub;
+    uint gpio;
+    uint16_t top;
+    int32_t out_min, out_max; // Limites pedidos, antes da redução térmica
+    uint16_t derate_cut;      // Redução térmica do máximo, em milésimos (0 = sem limite)
+} loop_t;
+
+static loop_t loops[PID_LOOP_CHANNELS];
+static repeating_timer_t timer;
+static bool timer_running;
+static uint32_t rate_hz = PID_LOOP_DEFAULT_RATE_HZ;
+static uint32_t last_tick_us;
+static pid_loop_stats_t stats;
+
+static void reset_stats_locked(void)
+{
+    stats = (pid_loop_stats_t){
+        .rate_hz = rate_hz,
+        .jitter_min_us = INT32_MAX,
+        .jitter_max_us = INT32_MIN,
+    };
+    last_tick_us = 0;
+}
+
+// Limites do controlador: os pedidos, com o máximo baixado pela redução térmica. Limitar a saída
+// no próprio PID mantém o anti-windup valendo para o teto térmico. Chamar com as interrupções
+// desligadas.
+static void apply_limits(loop_t *l)
+{
+    int32_t cap = (int32_t)(((PID_FULL_SCALE + 1u) * (1000u - l->derate_cut)) / 1000u);
+    l->pub.pid.out_max = MIN(l->out_max, cap);
+    l->pub.pid.out_min = MIN(l->out_min, l->pub.pid.out_max);
+}
+
+// Primeiro uso do canal: controlador proporcional puro na faixa toda
+static void init_channel(loop_t *l)
+{
+    l->out_min = 0;
+    l->out_max = PID_FULL_SCALE;
+    pid_ctrl_init(&l->pub.pid, PID_GAIN(1), 0, 0, 0, PID_FULL_SCALE, rate_hz);
+    apply_limits(l);
+}
+
+// Interrupção do timer: um passo do PID em cada canal ativo
+static bool tick_cb(repeating_timer_t *rt)
+{
+    uint32_t now = time_us_32();
+    uint32_t period_us = 1000000 / rate_hz;
+
+    if (last_tick_us)
+    {
+        int32_t jitter = (int32_t)(now - last_tick_us) - (int32_t)period_us;
+        stats.jitter_min_us = MIN(stats.jitter_min_us, jitter);
+        stats.jitter_max_us = MAX(stats.jitter_max_us, jitter);
+        if (jitter >= (int32_t)period_us)
+        {
+            stats.overruns++;
+        }
+    }
+    last_tick_us = now;
+
+    // Preserva a entrada selecionada por quem mais usa o ADC (sensor de temperatura)
+    uint prev_input = adc_get_selected_input();
+    for (int ch = 0; ch < PID_LOOP_CHANNELS; ch++)
+    {
+        loop_t *l = &loops[ch];
+        if (!l->pub.enabled)
+        {
+            continue;
+        }
+        adc_select_input(l->pub.adc_input);
+        l->pub.measurement = adc_read();
+        l->pub.output = pid_ctrl_step(&l->pub.pid, l->pub.setpoint, l->pub.measurement);
+        uint32_t level = ((uint32_t)l->pub.output * (l->top + 1u)) / (PID_FULL_SCALE + 1u);
+        pwm_set_gpio_level(l->gpio, (uint16_t)level);
+    }
+    adc_select_input(prev_input);
+
+    uint32_t exec = time_us_32() - now;
+    stats.exec_max_us = MAX(stats.exec_max_us, exec);
+    if (exec >= period_us)
+    {
+        stats.overruns++;
+    }
+    stats.ticks++;
+    return true;
+}
+
+static void update_timer(void)
+{
+    bool any = false;
+    for (int ch = 0; ch < PID_LOOP_CHANNELS; ch++)
+    {
+        any |= loops[ch].pub.enabled;
+    }
+
+    if (timer_running)
+    {
+        cancel_repeating_timer(&timer);
+        timer_running = false;
+    }
+    if (any)
+    {
+        reset_stats_locked();
+        // Atraso negativo: período medido entre inícios de execução, sem acumular a duração do passo
+        timer_running = add_repeating_timer_us(-(int64_t)(1000000 / rate_hz), tick_cb, NULL, &timer);
+    }
+}
+
+bool pid_loop_set_rate(uint32_t hz)
+{
+    if (hz < PID_LOOP_RATE_MIN_HZ || hz > PID_LOOP_RATE_MAX_HZ)
+    {
+        return false;
+    }
+    uint32_t ints = save_and_disable_interrupts();
+    rate_hz = hz;
+    for (int ch = 0; ch < PID_LOOP_CHANNELS; ch++)
+    {
+        if (loops[ch].pub.pid.rate_hz)
+        {
+            pid_ctrl_set_rate(&loops[ch].pub.pid, hz);
+        }
+    }
+    restore_interrupts(ints);
+    update_timer();
+    return true;
+}
+
+bool pid_loop_enable(uint32_t ch, uint32_t gpio, uint32_t adc_input, uint16_t top)
+{
+    loop_t *l = &loops[ch];
+    if (adc_input > 3)
+    {
+        return false;
+    }
+    adc_gpio_init(26 + adc_input);
+
+    uint32_t ints = save_and_disable_interrupts();
+    if (l->pub.pid.rate_hz == 0)
+    {
+        init_channel(l);
+    }
+    pid_ctrl_reset(&l->pub.pid);
+    l->gpio = gpio;
+    l->top = top;
+    l->pub.adc_input = adc_input;
+    l->pub.enabled = true;
+    restore_interrupts(ints);
+
+    update_timer();
+    return true;
+}
+
+void pid_loop_disable(uint32_t ch)
+{
+    if (loops[ch].pub.enabled)
+    {
+        loops[ch].pub.enabled = false;
+        update_timer();
+    }
+}
+
+void pid_loop_set_derate(uint32_t ch, uint16_t factor)
+{
+    loop_t *l = &loops[ch];
+    uint32_t ints = save_and_disable_interrupts();
+    l->derate_cut = 1000 - MIN(factor, 1000);
+    if (l->pub.pid.rate_hz)
+    {
+        apply_limits(l);
+    }
+    restore_interrupts(ints);
+}
+
+bool pid_loop_enabled(uint32_t ch)
+{
+    return loops[ch].pub.enabled;
+}
+
+void pid_loop_set_top(uint32_t ch, uint16_t top)
+{
+    loops[ch].top = top;
+}
+
+void pid_loop_set_setpoint(uint32_t ch, int32_t setpoint)
+{
+    loops[ch].pub.setpoint = MAX(0, MIN(PID_FULL_SCALE, setpoint));
+}
+
+void pid_loop_set_gains(uint32_t ch, int32_t kp, int32_t ki, int32_t kd)
+{
+    loop_t *l = &loops[ch];
+    uint32_t ints = save_and_disable_interrupts();
+    if (l->pub.pid.rate_hz == 0)
+    {
+        init_channel(l);
+    }
+    pid_ctrl_init(&l->pub.pid, kp, ki, kd, 0, PID_FULL_SCALE, rate_hz);
+    apply_limits(l);
+    restore_interrupts(ints);
+}
+
+void pid_loop_set_limits(uint32_t ch, int32_t out_min, int32_t out_max)
+{
+    loop_t *l = &loops[ch];
+    uint32_t ints = save_and_disable_interrupts();
+    if (l->pub.pid.rate_hz == 0)
+    {
+        init_channel(l);
+    }
+    l->out_min = MAX(0, MIN(out_min, PID_FULL_SCALE));
+    l->out_max = MAX(l->out_min, MIN(out_max, PID_FULL_SCALE));
+    apply_limits(l);
+    restore_interrupts(ints);
+}
+
+void pid_loop_get_channel(uint32_t ch, pid_loop_channel_t *out)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    *out = loops[ch].pub;
+    restore_interrupts(ints);
+}
+
+void pid_loop_get_stats(pid_loop_stats_t *out)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    *out = stats;
+    restore_interrupts(ints);
+}
+
+void pid_loop_reset_stats(void)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    reset_stats_locked();
+    restore_interrupts(ints);
+}
@@ -0,0 +1,66 @@
+#ifndef PID_LOOP_H
+#define PID_LOOP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pid_ctrl.h"
+
+// Laço fechado por canal: um timer repetitivo lê a realimentação no ADC, executa o PID
+// e escreve o nível do comparador diretamente, tudo na interrupção do alarme.
+
+#define PID_LOOP_CHANNELS 3
+#define PID_LOOP_RATE_MIN_HZ 1000
+#define PID_LOOP_RATE_MAX_HZ 10000
+#ifndef PID_LOOP_DEFAULT_RATE_HZ
+#define PID_LOOP_DEFAULT_RATE_HZ 1000
+#endif
+
+// Estatísticas de temporização do laço desde o último reset
+typedef struct
+{
+    uint32_t rate_hz;
+    uint32_t ticks;
+    uint32_t overruns;    // Execuções mais longas que o período, ou ticks atrasados mais de um período
+    int32_t jitter_min_us; // Intervalo real menos o período nominal
+    int32_t jitter_max_us;
+    uint32_t exec_max_us;
+} pid_loop_stats_t;
+
+// Estado de um canal para consulta
+typedef struct
+{
+    bool enabled;
+    uint8_t adc_input;
+    int32_t setpoint;
+    int32_t measurement; // Última leitura
+    int32_t output;      // Última saída (escala de 12 bits)
+    pid_ctrl_t pid;
+} pid_loop_channel_t;
+
+// Troca a frequência do laço (1-10 kHz); reinicia o timer se houver canais ativos
+bool pid_loop_set_rate(uint32_t rate_hz);
+
+// Liga o laço no canal: realimentação na entrada do ADC (0-3 = GPIO 26-29) e
+// saída no GPIO, com o TOP atual do slice
+bool pid_loop_enable(uint32_t ch, uint32_t gpio, uint32_t adc_input, uint16_t top);
+void pid_loop_disable(uint32_t ch);
+bool pid_loop_enabled(uint32_t ch);
+
+// Fator térmico (milésimos): baixa o limite máximo da saída do PID para o fator da escala, então
+// o integrador não acumula além do teto térmico
+void pid_loop_set_derate(uint32_t ch, uint16_t factor);
+
+// Novo TOP do slice (após troca de clock); a saída do PID não muda de escala
+void pid_loop_set_top(uint32_t ch, uint16_t top);
+
+void pid_loop_set_setpoint(uint32_t ch, int32_t setpoint);
+void pid_loop_set_gains(uint32_t ch, int32_t kp, int32_t ki, int32_t kd);
+void pid_loop_set_limits(uint32_t ch, int32_t out_min, int32_t out_max);
+
+// Cópia consistente do estado do canal
+void pid_loop_get_channel(uint32_t ch, pid_loop_channel_t *out);
+
+void pid_loop_get_stats(pid_loop_stats_t *out);
+void pid_loop_reset_stats(void);
+
+#endif
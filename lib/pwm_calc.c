@@ -0,0 +1,39 @@
+#include "pwm_calc.h"
+
+#define DIV16_MIN 16
+#define DIV16_MAX 4095
+#define TOP_MAX 65535u
+
+bool pwm_calc_solve(uint32_t clk_hz, uint32_t freq_hz, pwm_timing_t *out)
+{
+    if (freq_hz == 0 || freq_hz > clk_hz / 2)
+    {
+        return false;
+    }
+
+    // Ciclos de clk_sys por período, em 1/16 para casar com o divisor fracionário
+    uint64_t cycles16 = ((uint64_t)clk_hz * 16 + freq_hz / 2) / freq_hz;
+    uint64_t div16 = (cycles16 + (TOP_MAX + 1) - 1) / (TOP_MAX + 1);
+    if (div16 < DIV16_MIN)
+    {
+        div16 = DIV16_MIN;
+    }
+    if (div16 > DIV16_MAX)
+    {
+        return false;
+    }
+
+    uint64_t periods = (cycles16 + div16 / 2) / div16;
+    if (periods < 2 || periods > TOP_MAX + 1)
+    {
+        return false;
+    }
+    out->div16 = (uint16_t)div16;
+    out->top = (uint16_t)(periods - 1);
+    return true;
+}
+
+uint32_t pwm_calc_freq(uint32_t clk_hz, const pwm_timing_t *t)
+{
+    return (uint32_t)(((uint64_t)clk_hz * 16) / ((uint64_t)t->div16 * (t->top + 1u)));
+}
@@ -0,0 +1,34 @@
+#ifndef PWM_CALC_H
+#define PWM_CALC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Configuração de um slice PWM: divisor em 1/16 (formato 8.4 do registrador DIV) e TOP
+typedef struct
+{
+    uint16_t div16; // 16 (div = 1) a 4095 (div = 255 + 15/16)
+    uint16_t top;   // Período = (top + 1) ciclos do contador
+} pwm_timing_t;
+
+// Escolhe o menor divisor que permite atingir freq_hz, maximizando o TOP e
+// portanto a resolução do duty. Retorna false se a frequência estiver fora da faixa.
+bool pwm_calc_solve(uint32_t clk_hz, uint32_t freq_hz, pwm_timing_t *out);
+
+// Frequência resultante de uma configuração, em Hz
+uint32_t pwm_calc_freq(uint32_t clk_hz, const pwm_timing_t *t);
+
+// Período em 1/16 de ciclo de clk_sys, exato (a frequência em Hz é arredondada)
+static inline uint32_t pwm_calc_period16(const pwm_timing_t *t)
+{
+    return (uint32_t)t->div16 * (t->top + 1u);
+}
+
+// Um temporizador de amostras não pode ser mais rápido que o PWM: com duas escritas no mesmo
+// período, o CC com buffer duplo só aplicaria a segunda e uma amostra se perderia
+static inline bool pwm_calc_pacer_fits(const pwm_timing_t *pacer, const pwm_timing_t *pwm)
+{
+    return pwm_calc_period16(pacer) >= pwm_calc_period16(pwm);
+}
+
+#endif
@@ -0,0 +1,195 @@
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/dma.h"
+#include "pwm_dither.h"
+#include "pwm_wave.h"
+#include "sigma_delta.h"
+
+typedef struct
+{
+    bool active;
+    uint slice;
+    uint chan;
+    int data_dma;
+    int ctrl_dma;
+    uint32_t len;
+    uint8_t cur;              // Sequência apontada por buf_addr
+    const uint32_t *buf_addr; // Lido pelo canal de controle para rearmar o canal de dados
+    uint32_t *buf[2];         // Duas sequências de len palavras CC, num só bloco alocado
+    uint16_t *levels;         // len níveis, no mesmo bloco
+} dither_t;
+
+static dither_t dithers[PWM_DITHER_CHANNELS];
+
+static void release(dither_t *d)
+{
+    if (d->data_dma >= 0)
+    {
+        dma_channel_unclaim(d->data_dma);
+    }
+    if (d->ctrl_dma >= 0)
+    {
+        dma_channel_unclaim(d->ctrl_dma);
+    }
+    d->data_dma = d->ctrl_dma = -1;
+    free(d->buf[0]);
+    d->buf[0] = d->buf[1] = NULL;
+    d->levels = NULL;
+    d->active = false;
+}
+
+// Gera a sequência na metade livre e publica o novo endereço para o canal de controle
+static void fill(dither_t *d, uint32_t duty_q16)
+{
+    uint8_t next = d->cur ^ 1;
+    uint16_t top = pwm_hw->slice[d->slice].top;
+    uint32_t cc = pwm_hw->slice[d->slice].cc;
+    sigma_delta_fill(top, duty_q16, d->levels, d->len);
+    for (uint32_t i = 0; i < d->len; i++)
+    {
+        d->buf[next][i] = pwm_wave_cc_word(cc, d->chan, d->levels[i]);
+    }
+    d->buf_addr = d->buf[next];
+    d->cur = next;
+}
+
+pwm_dither_err_t pwm_dither_start(uint32_t ch, uint32_t gpio, uint32_t len)
+{
+    dither_t *d = &dithers[ch];
+    pwm_dither_stop(ch);
+    if (len < PWM_DITHER_MIN_LEN || len > PWM_DITHER_MAX_LEN || (len & (len - 1)))
+    {
+        return PWM_DITHER_ERR_LEN;
+    }
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    uint16_t top = pwm_hw->slice[slice].top;
+    if (sigma_delta_bits_x100(top, len) < PWM_DITHER_MIN_BITS * 100)
+    {
+        return PWM_DITHER_ERR_BITS;
+    }
+    // Divisor em 8.4 (parte inteira 0 vale 256): período de (TOP + 1) * div16 / 16 ciclos
+    uint32_t div16 = pwm_hw->slice[slice].div & (PWM_CH0_DIV_INT_BITS | PWM_CH0_DIV_FRAC_BITS);
+    div16 += (div16 >> 4) == 0 ? 256u << 4 : 0;
+    if ((top + 1u) * div16 < PWM_DITHER_MIN_PERIOD_CYCLES * 16u)
+    {
+        return PWM_DITHER_ERR_RATE;
+    }
+
+    uint32_t *block = malloc(len * (2 * sizeof(uint32_t) + sizeof(uint16_t)));
+    if (block == NULL)
+    {
+        return PWM_DITHER_ERR_MEM;
+    }
+    d->buf[0] = block;
+    d->buf[1] = block + len;
+    d->levels = (uint16_t *)(block + 2 * len);
+    d->slice = slice;
+    d->chan = pwm_gpio_to_channel(gpio);
+    d->len = len;
+    d->data_dma = dma_claim_unused_channel(false);
+    d->ctrl_dma = dma_claim_unused_channel(false);
+    if (d->data_dma < 0 || d->ctrl_dma < 0)
+    {
+        release(d);
+        return PWM_DITHER_ERR_DMA;
+    }
+    fill(d, 0);
+
+    // Um nível por fim de período do próprio slice
+    dma_channel_config c = dma_channel_get_default_config(d->data_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pwm_get_dreq(d->slice));
+    channel_config_set_chain_to(&c, d->ctrl_dma);
+    dma_channel_configure(d->data_dma, &c, &pwm_hw->slice[d->slice].cc, d->buf_addr, d->len, false);
+
+    dma_channel_config k = dma_channel_get_default_config(d->ctrl_dma);
+    channel_config_set_transfer_data_size(&k, DMA_SIZE_32);
+    channel_config_set_read_increment(&k, false);
+    channel_config_set_write_increment(&k, false);
+    dma_channel_configure(d->ctrl_dma, &k, &dma_hw->ch[d->data_dma].al3_read_addr_trig, &d->buf_addr, 1, false);
+
+    d->active = true;
+    dma_channel_start(d->data_dma);
+    return PWM_DITHER_OK;
+}
+
+bool pwm_dither_set(uint32_t ch, uint32_t duty_q16)
+{
+    dither_t *d = &dithers[ch];
+    if (!d->active)
+    {
+        return false;
+    }
+    // Se a troca anterior ainda não aconteceu, a metade reescrita pode tocar uma repetição
+    // misturando os dois duties; a média converge na repetição seguinte
+    fill(d, duty_q16);
+    return true;
+}
+
+void pwm_dither_stop(uint32_t ch)
+{
+    dither_t *d = &dithers[ch];
+    if (!d->active)
+    {
+        return;
+    }
+
+    // Desfaz o encadeamento antes de abortar, para o canal de controle não rearmar a sequência
+    dma_channel_config c = dma_get_channel_config(d->data_dma);
+    channel_config_set_chain_to(&c, d->data_dma);
+    dma_channel_set_config(d->data_dma, &c, false);
+    dma_channel_abort(d->ctrl_dma);
+    dma_channel_abort(d->data_dma);
+    release(d);
+}
+
+bool pwm_dither_active(uint32_t ch)
+{
+    return dithers[ch].active;
+}
+
+uint32_t pwm_dither_len(uint32_t ch)
+{
+    return dithers[ch].len;
+}
+
+void pwm_dither_update_sibling(uint32_t gpio, uint16_t level)
+{
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    uint chan = pwm_gpio_to_channel(gpio);
+    for (uint32_t ch = 0; ch < PWM_DITHER_CHANNELS; ch++)
+    {
+        dither_t *d = &dithers[ch];
+        if (d->active && d->slice == slice && d->chan != chan)
+        {
+            for (uint32_t i = 0; i < d->len; i++)
+            {
+                d->buf[0][i] = pwm_wave_cc_word(d->buf[0][i], chan, level);
+                d->buf[1][i] = pwm_wave_cc_word(d->buf[1][i], chan, level);
+            }
+        }
+    }
+}
+
+const char *pwm_dither_err_name(pwm_dither_err_t err)
+{
+    switch (err)
+    {
+    case PWM_DITHER_OK:
+        return "ok";
+    case PWM_DITHER_ERR_LEN:
+        return "tamanho fora da faixa ou nao potencia de 2";
+    case PWM_DITHER_ERR_BITS:
+        return "resolucao abaixo do minimo para o TOP";
+    case PWM_DITHER_ERR_RATE:
+        return "periodo PWM curto demais para a DMA";
+    case PWM_DITHER_ERR_DMA:
+        return "sem canal DMA livre";
+    case PWM_DITHER_ERR_MEM:
+        return "sem memoria para as sequencias";
+    }
+    return "?";
+}
@@ -0,0 +1,54 @@
+#ifndef PWM_DITHER_H
+#define PWM_DITHER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Duty com resolução estendida por dithering: a DMA escreve no CC um nível por período PWM,
+// tirado de uma sequência sigma-delta (sigma_delta.c) que se repete sem intervenção da CPU.
+// Com TOP pequeno (frequências de MHz) a média da sequência ganha log2(len) bits de resolução.
+// Cada canal tem duas sequências: a nova é gerada na que não está tocando e a troca acontece
+// no fim da repetição em curso, quando o canal de controle lê o novo endereço. As sequências
+// são alocadas ao ligar e liberadas ao desligar (6 bytes por período).
+
+#define PWM_DITHER_CHANNELS 3
+#define PWM_DITHER_MIN_LEN 16
+#define PWM_DITHER_MAX_LEN 4096
+
+// Resolução mínima da média, log2((TOP + 1) * len)
+#define PWM_DITHER_MIN_BITS 12
+
+// Ciclos de clk_sys por período PWM: a escrita de cada nível e, no fim da sequência, a recarga
+// pelo canal de controle precisam caber em um período com o barramento disputado pelas outras
+// DMAs (forma de onda, matriz, ADC)
+#define PWM_DITHER_MIN_PERIOD_CYCLES 16
+
+typedef enum
+{
+    PWM_DITHER_OK,
+    PWM_DITHER_ERR_LEN,  // Tamanho fora da faixa ou não potência de 2
+    PWM_DITHER_ERR_BITS, // (TOP + 1) * len abaixo de PWM_DITHER_MIN_BITS
+    PWM_DITHER_ERR_RATE, // Período PWM mais curto que PWM_DITHER_MIN_PERIOD_CYCLES
+    PWM_DITHER_ERR_DMA,  // Sem canais DMA livres
+    PWM_DITHER_ERR_MEM,  // Sem memória para as sequências
+} pwm_dither_err_t;
+
+// Liga o dithering no canal com sequências de len períodos (potência de 2), duty inicial 0.
+// Usa o divisor e o TOP já programados no slice.
+pwm_dither_err_t pwm_dither_start(uint32_t ch, uint32_t gpio, uint32_t len);
+
+// Duty em Q16 (65536 = 100%)
+bool pwm_dither_set(uint32_t ch, uint32_t duty_q16);
+
+// Interrompe; o CC mantém o último nível escrito
+void pwm_dither_stop(uint32_t ch);
+
+bool pwm_dither_active(uint32_t ch);
+uint32_t pwm_dither_len(uint32_t ch);
+
+// Mantém o nível do outro canal do mesmo slice nas sequências em uso
+void pwm_dither_update_sibling(uint32_t gpio, uint16_t level);
+
+const char *pwm_dither_err_name(pwm_dither_err_t err);
+
+#endif
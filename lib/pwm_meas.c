@@ -0,0 +1,132 @@
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "pwm_meas.h"
+
+typedef enum
+{
+    MEAS_IDLE = 0,
+    MEAS_FREQ,
+    MEAS_DUTY,
+    MEAS_DONE,
+} meas_state_t;
+
+static volatile meas_state_t meas_state;
+static uint slice;
+static uint32_t gate_us;
+static volatile uint32_t wraps; // Estouros do contador na porta atual
+static uint64_t t_start;
+static pwm_meas_result_t result;
+static bool irq_installed;
+
+static void wrap_irq_handler(void)
+{
+    if (meas_state != MEAS_IDLE && (pwm_get_irq_status_mask() & (1u << slice)))
+    {
+        pwm_clear_irq(slice);
+        wraps++;
+    }
+}
+
+// Configura o slice no modo pedido, zera o contador e abre a porta
+static void open_gate(enum pwm_clkdiv_mode mode)
+{
+    pwm_config cfg = pwm_get_default_config();
+    pwm_config_set_clkdiv_mode(&cfg, mode);
+    pwm_config_set_clkdiv_int(&cfg, 1);
+    pwm_config_set_wrap(&cfg, 0xFFFF);
+    pwm_init(slice, &cfg, false);
+    pwm_set_counter(slice, 0);
+    pwm_clear_irq(slice);
+    wraps = 0;
+    t_start = time_us_64();
+    pwm_set_enabled(slice, true);
+}
+
+// Fecha a porta e retorna a contagem total (estouros + contador)
+static uint64_t close_gate(uint64_t *elapsed_us)
+{
+    pwm_set_enabled(slice, false);
+    *elapsed_us = time_us_64() - t_start;
+    uint16_t count = pwm_get_counter(slice);
+    // Um wrap que ocorreu junto com o fim da porta ainda pode estar pendente
+    if (pwm_get_irq_status_mask() & (1u << slice))
+    {
+        pwm_clear_irq(slice);
+        wraps++;
+    }
+    return (uint64_t)wraps * 0x10000 + count;
+}
+
+static int64_t gate_cb(alarm_id_t id, void *user_data)
+{
+    uint64_t elapsed;
+    uint64_t count = close_gate(&elapsed);
+
+    if (meas_state == MEAS_FREQ)
+    {
+        result.gate_us = (uint32_t)elapsed;
+        result.edges = count;
+        result.freq_mhz = elapsed ? count * 1000000000ull / elapsed : 0;
+        meas_state = MEAS_DUTY;
+        open_gate(PWM_DIV_B_HIGH);
+        return gate_us; // Mesmo alarme reprogramado para a porta de duty
+    }
+
+    // Ciclos de clk_sys em nível alto sobre os ciclos da porta
+    uint64_t gate_cycles = elapsed * (clock_get_hz(clk_sys) / 1000000);
+    result.duty_ppm = gate_cycles ? (uint32_t)MIN(count * 1000000 / gate_cycles, 1000000) : 0;
+    pwm_set_irq_enabled(slice, false);
+    meas_state = MEAS_DONE;
+    return 0;
+}
+
+bool pwm_meas_start(uint32_t gpio, uint32_t gate_ms)
+{
+    if (meas_state == MEAS_FREQ || meas_state == MEAS_DUTY || pwm_gpio_to_channel(gpio) != PWM_CHAN_B ||
+        gate_ms < PWM_MEAS_GATE_MIN_MS || gate_ms > PWM_MEAS_GATE_MAX_MS)
+    {
+        return false;
+    }
+
+    if (!irq_installed)
+    {
+        irq_add_shared_handler(PWM_IRQ_WRAP, wrap_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(PWM_IRQ_WRAP, true);
+        irq_installed = true;
+    }
+
+    slice = pwm_gpio_to_slice_num(gpio);
+    gate_us = gate_ms * 1000;
+    result = (pwm_meas_result_t){.gpio = gpio};
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+
+    meas_state = MEAS_FREQ;
+    pwm_set_irq_enabled(slice, true);
+    open_gate(PWM_DIV_B_RISING);
+    if (add_alarm_in_us(gate_us, gate_cb, NULL, true) < 0)
+    {
+        pwm_set_enabled(slice, false);
+        pwm_set_irq_enabled(slice, false);
+        meas_state = MEAS_IDLE;
+        return false;
+    }
+    return true;
+}
+
+bool pwm_meas_busy(void)
+{
+    return meas_state == MEAS_FREQ || meas_state == MEAS_DUTY;
+}
+
+bool pwm_meas_poll(pwm_meas_result_t *out)
+{
+    if (meas_state != MEAS_DONE)
+    {
+        return false;
+    }
+    *out = result;
+    meas_state = MEAS_IDLE;
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef PWM_MEAS_H
+#define PWM_MEAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Medição de frequência e duty com um slice PWM usado como contador na entrada B.
+// Primeiro o slice conta bordas de subida durante o tempo de porta; depois conta ciclos
+// de clk_sys com a entrada em nível alto. Estouros do contador de 16 bits são somados na
+// interrupção de wrap e o fim de cada porta é um alarme, então a CPU não fica esperando.
+
+// Entrada padrão: GPIO 9, canal B do slice 4 (precisa ser um GPIO ímpar livre)
+#ifndef PWM_MEAS_DEFAULT_GPIO
+#define PWM_MEAS_DEFAULT_GPIO 9
+#endif
+
+#define PWM_MEAS_GATE_MIN_MS 1
+#define PWM_MEAS_GATE_MAX_MS 10000
+
+typedef struct
+{
+    uint32_t gpio;
+    uint32_t gate_us;       // Duração real da porta de frequência
+    uint64_t edges;         // Bordas de subida na porta
+    uint64_t freq_mhz;      // Frequência em mHz
+    uint32_t duty_ppm;      // Fração do tempo em nível alto, em partes por milhão
+} pwm_meas_result_t;
+
+// Inicia uma medição. Retorna false se já houver uma em andamento ou os parâmetros forem inválidos.
+bool pwm_meas_start(uint32_t gpio, uint32_t gate_ms);
+
+bool pwm_meas_busy(void);
+
+// Retorna true uma vez quando a medição termina, preenchendo o resultado
+bool pwm_meas_poll(pwm_meas_result_t *out);
+
+#endif
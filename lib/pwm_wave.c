@@ -0,0 +1,220 @@
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+#include "pwm_calc.h"
+#include "wave_table.h"
+#include "pwm_wave.h"
+
+typedef struct
+{
+    bool active;
+    bool loop;
+    uint slice;
+    uint chan;
+    int data_dma;
+    int ctrl_dma;
+    uint16_t count;
+    uint16_t stage_count;
+    uint16_t stage[PWM_WAVE_MAX_SAMPLES];
+    uint32_t buf[PWM_WAVE_MAX_SAMPLES];
+    const uint32_t *buf_addr; // Lido pelo canal de controle para rearmar o canal de dados
+} wave_t;
+
+static wave_t waves[PWM_WAVE_CHANNELS];
+static const uint8_t pacer_slices[PWM_WAVE_CHANNELS] = PWM_WAVE_PACER_SLICES;
+
+void pwm_wave_stage_clear(uint32_t ch)
+{
+    waves[ch].stage_count = 0;
+}
+
+bool pwm_wave_stage_append(uint32_t ch, uint16_t sample)
+{
+    wave_t *w = &waves[ch];
+    if (w->stage_count >= PWM_WAVE_MAX_SAMPLES)
+    {
+        return false;
+    }
+    w->stage[w->stage_count++] = MIN(sample, PWM_WAVE_FULL_SCALE);
+    return true;
+}
+
+bool pwm_wave_stage_sine(uint32_t ch, uint32_t n, uint16_t min, uint16_t max)
+{
+    wave_t *w = &waves[ch];
+    if (n > PWM_WAVE_MAX_SAMPLES || max > PWM_WAVE_FULL_SCALE || !wave_table_sine(w->stage, n, min, max))
+    {
+        return false;
+    }
+    w->stage_count = n;
+    return true;
+}
+
+bool pwm_wave_stage_trapezoid(uint32_t ch, uint32_t n, uint16_t min, uint16_t max)
+{
+    wave_t *w = &waves[ch];
+    if (n > PWM_WAVE_MAX_SAMPLES || max > PWM_WAVE_FULL_SCALE || !wave_table_trapezoid(w->stage, n, min, max))
+    {
+        return false;
+    }
+    w->stage_count = n;
+    return true;
+}
+
+uint32_t pwm_wave_stage_count(uint32_t ch)
+{
+    return waves[ch].stage_count;
+}
+
+// Configuração atual do slice, lida dos registradores
+static pwm_timing_t slice_timing(uint slice)
+{
+    return (pwm_timing_t){
+        .div16 = pwm_hw->slice[slice].div & 0xFFF,
+        .top = pwm_hw->slice[slice].top,
+    };
+}
+
+static void release(wave_t *w)
+{
+    if (w->data_dma >= 0)
+    {
+        dma_channel_unclaim(w->data_dma);
+    }
+    if (w->ctrl_dma >= 0)
+    {
+        dma_channel_unclaim(w->ctrl_dma);
+    }
+    w->data_dma = w->ctrl_dma = -1;
+    w->active = false;
+    pwm_set_enabled(pacer_slices[w - waves], false);
+}
+
+bool pwm_wave_start(uint32_t ch, uint32_t gpio, uint32_t rate_hz, bool loop)
+{
+    wave_t *w = &waves[ch];
+    pwm_wave_stop(ch);
+    if (w->stage_count == 0)
+    {
+        return false;
+    }
+
+    w->slice = pwm_gpio_to_slice_num(gpio);
+    w->chan = pwm_gpio_to_channel(gpio);
+    pwm_timing_t pwm_t = slice_timing(w->slice);
+    pwm_timing_t pacer_t;
+    if (rate_hz && (!pwm_calc_solve(clock_get_hz(clk_sys), rate_hz, &pacer_t) ||
+                    !pwm_calc_pacer_fits(&pacer_t, &pwm_t)))
+    {
+        return false; // Amostras mais rápidas que o período PWM nunca apareceriam na saída
+    }
+
+    // Tabela de palavras CC: a metade do outro canal do slice é preservada
+    uint16_t top = pwm_hw->slice[w->slice].top;
+    uint32_t cc = pwm_hw->slice[w->slice].cc;
+    for (uint32_t i = 0; i < w->stage_count; i++)
+    {
+        w->buf[i] = pwm_wave_cc_word(cc, w->chan, pwm_wave_sample_level(w->stage[i], top));
+    }
+    w->count = w->stage_count;
+    w->buf_addr = w->buf;
+    w->loop = loop;
+
+    // Ritmo: fim de período do próprio slice, ou slice auxiliar na taxa pedida
+    uint dreq = pwm_get_dreq(w->slice);
+    if (rate_hz)
+    {
+        uint pacer = pacer_slices[ch];
+        pwm_config cfg = pwm_get_default_config();
+        pwm_config_set_clkdiv_int_frac(&cfg, pacer_t.div16 >> 4, pacer_t.div16 & 0xF);
+        pwm_config_set_wrap(&cfg, pacer_t.top);
+        pwm_init(pacer, &cfg, true);
+        dreq = pwm_get_dreq(pacer);
+    }
+
+    w->data_dma = dma_claim_unused_channel(false);
+    w->ctrl_dma = loop ? dma_claim_unused_channel(false) : -1;
+    if (w->data_dma < 0 || (loop && w->ctrl_dma < 0))
+    {
+        release(w);
+        return false;
+    }
+
+    dma_channel_config c = dma_channel_get_default_config(w->data_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, dreq);
+    channel_config_set_chain_to(&c, loop ? w->ctrl_dma : w->data_dma);
+    dma_channel_configure(w->data_dma, &c, &pwm_hw->slice[w->slice].cc, w->buf, w->count, false);
+
+    if (loop)
+    {
+        // Ao fim da tabela, o canal de controle reescreve o endereço de leitura (com gatilho)
+        dma_channel_config k = dma_channel_get_default_config(w->ctrl_dma);
+        channel_config_set_transfer_data_size(&k, DMA_SIZE_32);
+        channel_config_set_read_increment(&k, false);
+        channel_config_set_write_increment(&k, false);
+        dma_channel_configure(w->ctrl_dma, &k, &dma_hw->ch[w->data_dma].al3_read_addr_trig, &w->buf_addr, 1, false);
+    }
+
+    w->active = true;
+    dma_channel_start(w->data_dma);
+    return true;
+}
+
+void pwm_wave_stop(uint32_t ch)
+{
+    wave_t *w = &waves[ch];
+    if (!w->active)
+    {
+        return;
+    }
+
+    // Desfaz o encadeamento antes de abortar, para o canal de controle não rearmar a tabela
+    if (w->loop)
+    {
+        dma_channel_config c = dma_get_channel_config(w->data_dma);
+        channel_config_set_chain_to(&c, w->data_dma);
+        dma_channel_set_config(w->data_dma, &c, false);
+        dma_channel_abort(w->ctrl_dma);
+    }
+    dma_channel_abort(w->data_dma);
+    release(w);
+}
+
+bool pwm_wave_active(uint32_t ch)
+{
+    return waves[ch].active;
+}
+
+void pwm_wave_service(void)
+{
+    for (uint32_t ch = 0; ch < PWM_WAVE_CHANNELS; ch++)
+    {
+        wave_t *w = &waves[ch];
+        if (w->active && !w->loop && !dma_channel_is_busy(w->data_dma))
+        {
+            release(w);
+        }
+    }
+}
+
+void pwm_wave_update_sibling(uint32_t gpio, uint16_t level)
+{
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    uint chan = pwm_gpio_to_channel(gpio);
+    for (uint32_t ch = 0; ch < PWM_WAVE_CHANNELS; ch++)
+    {
+        wave_t *w = &waves[ch];
+        if (w->active && w->slice == slice && w->chan != chan)
+        {
+            // Cada palavra é escrita de uma vez, então a DMA nunca lê uma palavra pela metade
+            for (uint32_t i = 0; i < w->count; i++)
+            {
+                w->buf[i] = pwm_wave_cc_word(w->buf[i], chan, level);
+            }
+        }
+    }
+}
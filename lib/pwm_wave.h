@@ -0,0 +1,58 @@
+#ifndef PWM_WAVE_H
+#define PWM_WAVE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Reprodução de formas de onda no registrador de comparação (CC) de um canal PWM.
+// Um canal DMA copia a tabela para o CC, ritmado pelo fim de período do próprio slice
+// (rate_hz = 0) ou por um slice auxiliar usado como temporizador. No modo contínuo,
+// um segundo canal DMA rearma o primeiro, sem nenhuma intervenção da CPU.
+
+#define PWM_WAVE_CHANNELS 3
+#define PWM_WAVE_MAX_SAMPLES 256
+
+// Amostras em milésimos do período (0-1000)
+#define PWM_WAVE_FULL_SCALE 1000
+
+// Slices usados como temporizador de amostragem, um por canal. Não podem ter pinos em
+// modo PWM; o 7 fica com os pinos do I2C do display e o 3 com o pino da matriz (PIO).
+#ifndef PWM_WAVE_PACER_SLICES
+#define PWM_WAVE_PACER_SLICES {7, 3, 0}
+#endif
+
+// Tabela em preparação de um canal (limpa, acrescenta ou gera por função)
+void pwm_wave_stage_clear(uint32_t ch);
+bool pwm_wave_stage_append(uint32_t ch, uint16_t sample);
+bool pwm_wave_stage_sine(uint32_t ch, uint32_t n, uint16_t min, uint16_t max);
+bool pwm_wave_stage_trapezoid(uint32_t ch, uint32_t n, uint16_t min, uint16_t max);
+uint32_t pwm_wave_stage_count(uint32_t ch);
+
+// Converte a tabela em palavras do registrador CC para o GPIO e inicia a reprodução.
+// rate_hz = 0 usa uma amostra por período PWM. Taxas acima da frequência do PWM são recusadas.
+bool pwm_wave_start(uint32_t ch, uint32_t gpio, uint32_t rate_hz, bool loop);
+
+// Interrompe a reprodução; o CC mantém a última amostra escrita
+void pwm_wave_stop(uint32_t ch);
+
+bool pwm_wave_active(uint32_t ch);
+
+// Libera os canais DMA das reproduções únicas que terminaram (chamar no laço principal)
+void pwm_wave_service(void);
+
+// Mantém o nível do outro canal do mesmo slice, que a DMA reescreveria com o valor antigo
+void pwm_wave_update_sibling(uint32_t gpio, uint16_t level);
+
+// Palavra do registrador CC com a amostra no canal A (chan = 0) ou B (chan = 1)
+static inline uint32_t pwm_wave_cc_word(uint32_t cc, uint32_t chan, uint16_t level)
+{
+    return chan ? (cc & 0x0000FFFF) | ((uint32_t)level << 16) : (cc & 0xFFFF0000) | level;
+}
+
+// Nível de comparação de uma amostra para o TOP do slice
+static inline uint16_t pwm_wave_sample_level(uint16_t sample, uint16_t top)
+{
+    return (uint16_t)(((uint32_t)top * sample) / PWM_WAVE_FULL_SCALE);
+}
+
+#endif
@@ -0,0 +1,277 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "scene.h"
+#include "pwm_calc.h"
+#include "flash_store.h"
+#include "thermal_loop.h"
+
+// Registro gravado na flash; as imagens são recalculadas na carga, para o clock da hora
+typedef struct
+{
+    scene_t scenes[SCENE_COUNT];
+} scene_store_t;
+
+typedef struct
+{
+    bool active;
+    uint32_t start_ms;
+    uint32_t ramp_ms;
+    uint16_t from_level;
+    uint16_t to_level;
+} ramp_t;
+
+static scene_store_t store;
+static uint8_t invalid_mask; // Cenas que não cabem no clock atual (continuam na flash)
+static uint32_t gpios[SCENE_CHANNELS];
+static ramp_t ramps[SCENE_CHANNELS];
+static repeating_timer_t timer;
+static bool timer_running;
+
+static uint32_t now_ms(void)
+{
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static scene_err_t compile(scene_t *s, uint32_t clk_hz)
+{
+    for (uint32_t ch = 0; ch < SCENE_CHANNELS; ch++)
+    {
+        if (!(s->mask & (1u << ch)))
+        {
+            continue;
+        }
+        pwm_timing_t t;
+        if (!pwm_calc_solve(clk_hz, s->ch[ch].freq_hz, &t))
+        {
+            return SCENE_ERR_FREQ;
+        }
+        s->reg[ch] = (scene_reg_t){
+            .slice = pwm_gpio_to_slice_num(gpios[ch]),
+            .chan = pwm_gpio_to_channel(gpios[ch]),
+            .div16 = t.div16,
+            .top = t.top,
+            .level = (uint16_t)(((t.top + 1u) * s->ch[ch].duty_permille) / 1000u),
+        };
+        // Canais do mesmo slice dividem divisor e TOP
+        for (uint32_t other = 0; other < ch; other++)
+        {
+            if ((s->mask & (1u << other)) && s->reg[other].slice == s->reg[ch].slice &&
+                (s->reg[other].div16 != t.div16 || s->reg[other].top != t.top))
+            {
+                return SCENE_ERR_SLICE;
+            }
+        }
+    }
+    return SCENE_OK;
+}
+
+static bool save(void)
+{
+    return flash_store_save(FLASH_STORE_SLOT_SCENES, &store, sizeof(store));
+}
+
+static bool ramp_cb(repeating_timer_t *rt)
+{
+    uint32_t now = now_ms();
+    bool any = false;
+    for (uint32_t ch = 0; ch < SCENE_CHANNELS; ch++)
+    {
+        ramp_t *r = &ramps[ch];
+        if (!r->active)
+        {
+            continue;
+        }
+        uint32_t t = now - r->start_ms;
+        int32_t level = r->to_level;
+        if (t < r->ramp_ms)
+        {
+            level = r->from_level + ((int32_t)r->to_level - r->from_level) * (int32_t)t / (int32_t)r->ramp_ms;
+            any = true;
+        }
+        else
+        {
+            r->active = false;
+        }
+        thermal_loop_set_level(ch, gpios[ch], (uint16_t)level);
+    }
+    timer_running = any;
+    return any;
+}
+
+void scene_init(const uint32_t gpio[SCENE_CHANNELS])
+{
+    memcpy(gpios, gpio, sizeof(gpios));
+    if (!flash_store_load(FLASH_STORE_SLOT_SCENES, &store, sizeof(store)))
+    {
+        memset(&store, 0, sizeof(store));
+    }
+    scene_recompile();
+}
+
+scene_err_t scene_define(uint32_t n, const char *name, uint32_t mask, const scene_channel_t ch[SCENE_CHANNELS])
+{
+    if (n >= SCENE_COUNT || mask == 0 || mask >= (1u << SCENE_CHANNELS))
+    {
+        return SCENE_ERR_INDEX;
+    }
+    scene_t s = {.mask = (uint8_t)mask};
+    strncpy(s.name, name ? name : "", sizeof(s.name) - 1);
+    memcpy(s.ch, ch, sizeof(s.ch));
+    for (uint32_t i = 0; i < SCENE_CHANNELS; i++)
+    {
+        s.ch[i].duty_permille = MIN(s.ch[i].duty_permille, 1000);
+        s.ch[i].ramp_ms = MIN(s.ch[i].ramp_ms, SCENE_RAMP_MAX_MS);
+    }
+    scene_err_t err = compile(&s, clock_get_hz(clk_sys));
+    if (err != SCENE_OK)
+    {
+        return err;
+    }
+    store.scenes[n] = s;
+    invalid_mask &= ~(1u << n);
+    return save() ? SCENE_OK : SCENE_ERR_FLASH;
+}
+
+scene_err_t scene_delete(uint32_t n)
+{
+    if (n >= SCENE_COUNT || store.scenes[n].mask == 0)
+    {
+        return SCENE_ERR_INDEX;
+    }
+    memset(&store.scenes[n], 0, sizeof(store.scenes[n]));
+    return save() ? SCENE_OK : SCENE_ERR_FLASH;
+}
+
+int scene_find(const char *name)
+{
+    for (int n = 0; n < SCENE_COUNT; n++)
+    {
+        if (store.scenes[n].mask && store.scenes[n].name[0] && strncmp(store.scenes[n].name, name, SCENE_NAME_LEN) == 0)
+        {
+            return n;
+        }
+    }
+    return -1;
+}
+
+const scene_t *scene_get(uint32_t n)
+{
+    return n < SCENE_COUNT && store.scenes[n].mask ? &store.scenes[n] : NULL;
+}
+
+scene_err_t scene_recall(uint32_t n)
+{
+    const scene_t *s = scene_get(n);
+    if (s == NULL)
+    {
+        return SCENE_ERR_INDEX;
+    }
+    if (invalid_mask & (1u << n))
+    {
+        return SCENE_ERR_FREQ;
+    }
+
+    uint32_t ints = save_and_disable_interrupts();
+    uint32_t restart = 0;
+    uint32_t slices = 0;
+    uint16_t start_level[SCENE_CHANNELS];
+    for (uint32_t ch = 0; ch < SCENE_CHANNELS; ch++)
+    {
+        const scene_reg_t *r = &s->reg[ch];
+        if (!(s->mask & (1u << ch)))
+        {
+            continue;
+        }
+        pwm_slice_hw_t *hw = &pwm_hw->slice[r->slice];
+        uint32_t old_top = hw->top;
+        slices |= 1u << r->slice;
+        if (hw->div != r->div16 || old_top != r->top)
+        {
+            restart |= 1u << r->slice;
+        }
+        // Com rampa, parte do duty atual reescalado para o novo TOP
+        uint32_t cc = r->chan == PWM_CHAN_B ? hw->cc >> 16 : hw->cc & 0xFFFF;
+        start_level[ch] = s->ch[ch].ramp_ms ? (uint16_t)MIN(cc * (r->top + 1u) / (old_top + 1u), r->top + 1u) : r->level;
+        ramps[ch] = (ramp_t){
+            .active = s->ch[ch].ramp_ms != 0,
+            .start_ms = now_ms(),
+            .ramp_ms = s->ch[ch].ramp_ms,
+            .from_level = start_level[ch],
+            .to_level = r->level,
+        };
+    }
+
+    // Slices que mudam de período param, recebem a imagem e voltam juntos a partir do zero
+    uint32_t en = pwm_hw->en;
+    pwm_set_mask_enabled(en & ~restart);
+    for (uint32_t ch = 0; ch < SCENE_CHANNELS; ch++)
+    {
+        const scene_reg_t *r = &s->reg[ch];
+        if (!(s->mask & (1u << ch)))
+        {
+            continue;
+        }
+        gpio_set_function(gpios[ch], GPIO_FUNC_PWM);
+        pwm_set_clkdiv_int_frac(r->slice, r->div16 >> 4, r->div16 & 0xF);
+        pwm_set_wrap(r->slice, r->top);
+        pwm_set_chan_level(r->slice, r->chan, start_level[ch]);
+        if (restart & (1u << r->slice))
+        {
+            pwm_set_counter(r->slice, 0);
+        }
+        thermal_loop_set_level(ch, gpios[ch], start_level[ch]); // Registra o nível fixo, já limitado pela temperatura
+    }
+    pwm_set_mask_enabled(en | slices);
+    restore_interrupts(ints);
+
+    bool any = false;
+    for (uint32_t ch = 0; ch < SCENE_CHANNELS; ch++)
+    {
+        any |= ramps[ch].active;
+    }
+    if (any && !timer_running)
+    {
+        timer_running = add_repeating_timer_ms(-SCENE_RAMP_TICK_MS, ramp_cb, NULL, &timer);
+    }
+    return SCENE_OK;
+}
+
+void scene_stop_ramp(uint32_t ch)
+{
+    ramps[ch].active = false;
+}
+
+void scene_recompile(void)
+{
+    uint32_t clk_hz = clock_get_hz(clk_sys);
+    invalid_mask = 0;
+    for (uint32_t n = 0; n < SCENE_COUNT; n++)
+    {
+        // Uma cena que não cabe neste clock fica indisponível, mas continua na flash
+        if (store.scenes[n].mask && compile(&store.scenes[n], clk_hz) != SCENE_OK)
+        {
+            invalid_mask |= 1u << n;
+        }
+    }
+}
+
+const char *scene_err_name(scene_err_t err)
+{
+    switch (err)
+    {
+    case SCENE_OK:
+        return "ok";
+    case SCENE_ERR_INDEX:
+        return "cena inexistente ou vazia";
+    case SCENE_ERR_FREQ:
+        return "frequencia fora da faixa";
+    case SCENE_ERR_SLICE:
+        return "canais do mesmo slice com frequencias ou modos incompativeis";
+    case SCENE_ERR_FLASH:
+        return "falha ao gravar a flash";
+    }
+    return "?";
+}
@@ -0,0 +1,76 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Cenas: configuração completa dos canais (frequência, duty e rampa) guardada na flash e
+// aplicada por uma única mensagem curta. O divisor, o TOP e o nível de cada canal são
+// calculados ao definir a cena, na carga e a cada troca de clock (a "imagem" dos registradores).
+// A chamada de uma cena só copia essa imagem para os slices com as interrupções desligadas:
+// slices que mudam de período são parados, zerados e religados juntos, então os canais
+// começam alinhados; nos demais o comparador troca no próximo wrap, sem glitch.
+
+#define SCENE_CHANNELS 3
+#define SCENE_COUNT 8
+#define SCENE_NAME_LEN 12
+#define SCENE_RAMP_TICK_MS 10
+#define SCENE_RAMP_MAX_MS 60000
+
+typedef struct
+{
+    uint32_t freq_hz;
+    uint16_t duty_permille;
+    uint32_t ramp_ms; // 0 = imediato
+} scene_channel_t;
+
+// Registradores de um canal já calculados
+typedef struct
+{
+    uint8_t slice;
+    uint8_t chan;    // PWM_CHAN_A ou PWM_CHAN_B
+    uint16_t div16;  // Divisor no formato 8.4
+    uint16_t top;
+    uint16_t level;
+} scene_reg_t;
+
+typedef struct
+{
+    char name[SCENE_NAME_LEN]; // Vazio = sem nome
+    uint8_t mask;              // Canais da cena (bit 0 = primeiro); 0 = cena livre
+    scene_channel_t ch[SCENE_CHANNELS];
+    scene_reg_t reg[SCENE_CHANNELS];
+} scene_t;
+
+typedef enum
+{
+    SCENE_OK = 0,
+    SCENE_ERR_INDEX,     // Número fora da faixa ou cena vazia
+    SCENE_ERR_FREQ,      // Frequência fora da faixa no clock atual
+    SCENE_ERR_SLICE,     // Dois canais do mesmo slice com frequências ou modos incompatíveis
+    SCENE_ERR_FLASH,
+} scene_err_t;
+
+// Informa os GPIOs dos canais, carrega as cenas da flash e calcula as imagens
+void scene_init(const uint32_t gpio[SCENE_CHANNELS]);
+
+// Define (e grava na flash) a cena n com os canais da máscara
+scene_err_t scene_define(uint32_t n, const char *name, uint32_t mask, const scene_channel_t ch[SCENE_CHANNELS]);
+scene_err_t scene_delete(uint32_t n);
+
+// Número da cena com o nome, ou -1
+int scene_find(const char *name);
+const scene_t *scene_get(uint32_t n);
+
+// Aplica a imagem da cena; os canais com rampa partem do nível atual, reescalado para o novo TOP
+scene_err_t scene_recall(uint32_t n);
+
+// Interrompe a rampa do canal (outro comando assumiu o canal)
+void scene_stop_ramp(uint32_t ch);
+
+// Recalcula as imagens para o clk_sys atual (depois de uma troca de perfil de clock)
+void scene_recompile(void);
+
+const char *scene_err_name(scene_err_t err);
+
+#endif
@@ -0,0 +1,91 @@
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "servo.h"
+
+static servo_t servos[SERVO_CHANNELS];
+
+bool servo_configure(uint32_t ch, uint32_t gpio, uint32_t freq_hz, uint32_t min_ns, uint32_t max_ns,
+                     uint32_t cal0_ns, uint32_t cal180_ns)
+{
+    servo_t *s = &servos[ch];
+    pwm_timing_t t;
+
+    if (freq_hz < SERVO_FREQ_MIN_HZ || freq_hz > SERVO_FREQ_MAX_HZ || min_ns >= max_ns ||
+        max_ns >= 1000000000u / freq_hz || cal0_ns == cal180_ns)
+    {
+        return false;
+    }
+    if (!pwm_calc_solve(clock_get_hz(clk_sys), freq_hz, &t))
+    {
+        return false;
+    }
+
+    s->enabled = true;
+    s->freq_hz = freq_hz;
+    s->min_ns = min_ns;
+    s->max_ns = max_ns;
+    s->cal0_ns = cal0_ns;
+    s->cal180_ns = cal180_ns;
+    s->timing = t;
+    s->pulse_ns = min_ns + (max_ns - min_ns) / 2;
+
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv_int_frac(&config, t.div16 >> 4, t.div16 & 0xF);
+    pwm_config_set_wrap(&config, t.top);
+    pwm_init(slice, &config, true);
+    pwm_set_gpio_level(gpio, servo_pulse_level(s, clock_get_hz(clk_sys), s->pulse_ns));
+    return true;
+}
+
+bool servo_retime(uint32_t ch, uint32_t gpio)
+{
+    servo_t *s = &servos[ch];
+    if (!s->enabled)
+    {
+        return false;
+    }
+    uint32_t pulse_ns = s->pulse_ns;
+    return servo_configure(ch, gpio, s->freq_hz, s->min_ns, s->max_ns, s->cal0_ns, s->cal180_ns) &&
+           servo_set_pulse_ns(ch, gpio, pulse_ns);
+}
+
+void servo_disable(uint32_t ch)
+{
+    servos[ch].enabled = false;
+}
+
+uint16_t servo_pulse_level(const servo_t *s, uint32_t clk_hz, uint32_t pulse_ns)
+{
+    // Ticks do contador = pulso * clk / divisor, com o divisor em 1/16
+    uint64_t ticks = ((uint64_t)pulse_ns * clk_hz * 16 + (uint64_t)s->timing.div16 * 500000000u) /
+                     ((uint64_t)s->timing.div16 * 1000000000u);
+    return (uint16_t)MIN(ticks, s->timing.top + 1u);
+}
+
+bool servo_set_pulse_ns(uint32_t ch, uint32_t gpio, uint32_t pulse_ns)
+{
+    servo_t *s = &servos[ch];
+    if (!s->enabled || pulse_ns < s->min_ns || pulse_ns > s->max_ns)
+    {
+        return false;
+    }
+    s->pulse_ns = pulse_ns;
+    pwm_set_gpio_level(gpio, servo_pulse_level(s, clock_get_hz(clk_sys), pulse_ns));
+    return true;
+}
+
+uint32_t servo_angle_to_ns(uint32_t ch, int32_t millideg)
+{
+    const servo_t *s = &servos[ch];
+    int64_t span = (int64_t)s->cal180_ns - s->cal0_ns;
+    int64_t ns = s->cal0_ns + span * millideg / 180000;
+    return ns < 0 ? 0 : (uint32_t)ns;
+}
+
+const servo_t *servo_get(uint32_t ch)
+{
+    return &servos[ch];
+}
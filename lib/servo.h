@@ -0,0 +1,48 @@
+#ifndef SERVO_H
+#define SERVO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pwm_calc.h"
+
+// Modo servo/ESC: quadro de 50-400 Hz comandado pela largura do pulso em nanossegundos.
+// O divisor é o menor possível para o quadro, o que deixa o TOP perto de 65535:
+// a 50 Hz e 125 MHz cada passo do comparador vale cerca de 0,3 us.
+
+#define SERVO_CHANNELS 3
+#define SERVO_FREQ_MIN_HZ 50
+#define SERVO_FREQ_MAX_HZ 400
+
+typedef struct
+{
+    bool enabled;
+    uint32_t freq_hz;
+    uint32_t min_ns, max_ns;       // Limites do pulso aceitos
+    uint32_t cal0_ns, cal180_ns;   // Pulso em 0 e em 180 graus
+    pwm_timing_t timing;
+    uint32_t pulse_ns;             // Último pulso aplicado
+} servo_t;
+
+// Configura o slice do GPIO para o quadro do servo. Os limites de calibração podem ser
+// iguais a min/max. O pulso inicial é o ponto médio entre min e max.
+bool servo_configure(uint32_t ch, uint32_t gpio, uint32_t freq_hz, uint32_t min_ns, uint32_t max_ns,
+                     uint32_t cal0_ns, uint32_t cal180_ns);
+
+// Refaz o divisor e o TOP com o clk_sys atual e reaplica o último pulso (após troca de clock)
+bool servo_retime(uint32_t ch, uint32_t gpio);
+
+// Desliga o modo servo do canal (o slice continua com a última configuração)
+void servo_disable(uint32_t ch);
+
+// Aplica um pulso. Retorna false se estiver fora dos limites do canal ou se o modo estiver desligado.
+bool servo_set_pulse_ns(uint32_t ch, uint32_t gpio, uint32_t pulse_ns);
+
+// Converte um ângulo em milésimos de grau para a largura do pulso pela calibração do canal
+uint32_t servo_angle_to_ns(uint32_t ch, int32_t millideg);
+
+// Nível do comparador para um pulso, com a resolução do divisor escolhido
+uint16_t servo_pulse_level(const servo_t *s, uint32_t clk_hz, uint32_t pulse_ns);
+
+const servo_t *servo_get(uint32_t ch);
+
+#endif
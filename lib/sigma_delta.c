@@ -0,0 +1,48 @@
+#include "sigma_delta.h"
+
+uint32_t sigma_delta_fill(uint16_t top, uint32_t duty_q16, uint16_t *levels, uint32_t len)
+{
+    uint32_t max = top + 1u;
+    if (duty_q16 > SIGMA_DELTA_ONE)
+    {
+        duty_q16 = SIGMA_DELTA_ONE;
+    }
+
+    // Nível desejado em Q16: parte inteira fixa e fração acumulada período a período
+    uint64_t target = (uint64_t)duty_q16 * max;
+    uint32_t base = (uint32_t)(target >> 16);
+    uint32_t frac = (uint32_t)(target & 0xFFFF);
+    uint32_t acc = 0x8000; // Meio passo: arredonda em vez de truncar
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        uint32_t level = base;
+        acc += frac;
+        if (acc >= 0x10000)
+        {
+            acc -= 0x10000;
+            level++;
+        }
+        if (level > max)
+        {
+            level = max;
+        }
+        levels[i] = (uint16_t)level;
+        sum += level;
+    }
+    return sum;
+}
+
+uint32_t sigma_delta_bits_x100(uint16_t top, uint32_t len)
+{
+    // log2((top + 1) * len) com duas casas, por busca do bit mais alto e interpolação linear
+    uint64_t steps = (uint64_t)(top + 1u) * len;
+    uint32_t bits = 0;
+    while ((steps >> (bits + 1)) != 0)
+    {
+        bits++;
+    }
+    uint64_t low = 1ull << bits;
+    return bits * 100 + (uint32_t)(((steps - low) * 100) / low);
+}
@@ -0,0 +1,21 @@
+#ifndef SIGMA_DELTA_H
+#define SIGMA_DELTA_H
+
+#include <stdint.h>
+
+// Sequência sigma-delta de níveis do comparador, sem dependências do SDK para poder ser
+// analisada no host. Um modulador de primeira ordem distribui os períodos com nível + 1
+// o mais espaçados possível, então a média sobre a sequência é o duty pedido com erro
+// menor que 1/len de um passo do comparador, e a ondulação fica na frequência mais alta.
+
+// Duty em Q16: 65536 = 100%
+#define SIGMA_DELTA_ONE 65536u
+
+// Preenche len níveis para o TOP do slice (nível top + 1 = sempre alto).
+// Retorna a soma dos níveis, para conferir a média.
+uint32_t sigma_delta_fill(uint16_t top, uint32_t duty_q16, uint16_t *levels, uint32_t len);
+
+// Resolução efetiva em bits x 100 de uma sequência de len períodos no TOP indicado
+uint32_t sigma_delta_bits_x100(uint16_t top, uint32_t len);
+
+#endif
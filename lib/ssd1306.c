@@ -1,5 +1,7 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
+#include "ssd1306_templates.h"
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c)
 {
@@ -70,6 +72,28 @@ void ssd1306_send_data(ssd1306_t *ssd)
       false);
 }
 
+// Envia só as colunas x0 a x1 (todas as páginas). No modo de endereçamento vertical as colunas
+// são contíguas no buffer, então o byte anterior vira o byte de controle durante a escrita.
+void ssd1306_send_columns(ssd1306_t *ssd, uint8_t x0, uint8_t x1)
+{
+  ssd1306_command(ssd, SET_COL_ADDR);
+  ssd1306_command(ssd, x0);
+  ssd1306_command(ssd, x1);
+  ssd1306_command(ssd, SET_PAGE_ADDR);
+  ssd1306_command(ssd, 0);
+  ssd1306_command(ssd, ssd->pages - 1);
+  uint8_t *start = &ssd->ram_buffer[x0 * ssd->pages];
+  uint8_t saved = *start;
+  *start = 0x40;
+  i2c_write_blocking(
+      ssd->i2c_port,
+      ssd->address,
+      start,
+      (x1 - x0 + 1) * ssd->pages + 1,
+      false);
+  *start = saved;
+}
+
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value)
 {
   uint16_t index = (y >> 3) + (x << 3) + 1;
@@ -218,7 +242,7 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
 void initDisplay(ssd1306_t *ssd)
 {
   // I2C Initialisation. Using it at 400Khz.
-  i2c_init(I2C_PORT, 400 * 1000);
+  i2c_init(I2C_PORT, I2C_BAUD_HZ);
   gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);                   // Set the GPIO pin function to I2C
   gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);                   // Set the GPIO pin function to I2C
   gpio_pull_up(I2C_SDA);                                       // Pull up the data line
@@ -228,56 +252,57 @@ void initDisplay(ssd1306_t *ssd)
   ssd1306_send_data(ssd);                                      // Envia os dados para o display
 }
 
+// Copia as partes fixas de uma tela, geradas por tools/gen_screens.c
+void ssd1306_load_template(ssd1306_t *ssd, const uint8_t *tpl)
+{
+  memcpy(ssd->ram_buffer + 1, tpl, SSD1306_TEMPLATE_SIZE);
+}
+
+// Retângulo preenchido escrito por máscara, uma página (8 linhas) por vez em cada coluna
+void ssd1306_fill_bar(ssd1306_t *ssd, uint8_t left, uint8_t width, uint8_t top, uint8_t height)
+{
+  uint8_t bottom = top + height - 1;
+  for (uint8_t y = top; height && y <= bottom;)
+  {
+    uint8_t last = (y | 7) < bottom ? (y | 7) : bottom;
+    uint8_t mask = (uint8_t)((0xFF << (y & 7)) & (0xFF >> (7 - (last & 7))));
+    for (uint8_t x = left; x < left + width; ++x)
+    {
+      ssd->ram_buffer[(y >> 3) + (x << 3) + 1] |= mask;
+    }
+    y = last + 1;
+  }
+}
+
 // Função que desenha a abertura do programa no display
 void draw_opening_screen(ssd1306_t *ssd)
 {
-  ssd1306_fill(ssd, 0);
-  ssd1306_rect(ssd, 0, 0, ssd->width, ssd->height, 1, 0);
-  ssd1306_line(ssd, 1, 14, 126, 14, 1);
-  ssd1306_draw_string(ssd, "Conf. PWM", 26, 3);
-  ssd1306_draw_string(ssd, "Ajuste div", 13, 18);
-  ssd1306_draw_string(ssd, "e wrap", 60, 28);
-  ssd1306_draw_string(ssd, "Formato", 11, 38);
-  ssd1306_draw_string(ssd, "(div,wrap)", 22, 48);
+  ssd1306_load_template(ssd, ssd1306_tpl_opening);
   ssd1306_send_data(ssd);
 }
 
 // Função que mostra o duty cycle do PWM configurado no display
 void draw_pwm_config(ssd1306_t *ssd, uint32_t fpwm, uint8_t duty_cycle, uint8_t motor)
 {
-  char value_fpwm[14];
-  char value_duty_cycle[5];
-  char value_motor[10];
-  sprintf(value_motor, "Motor %hhu", motor);
-  sprintf(value_fpwm, "Fpwm: %u", fpwm);
-  sprintf(value_duty_cycle, "%hhu%%", duty_cycle);
-  ssd1306_fill(ssd, 0);
-  ssd1306_rect(ssd, 0, 0, ssd->width, ssd->height, 1, 0);
-  ssd1306_line(ssd, 1, 14, 126, 14, 1);
-  ssd1306_line(ssd, 1, 32, 126, 32, 1);
-  ssd1306_draw_string(ssd, value_motor, 27, 3);
-  ssd1306_draw_string(ssd, value_fpwm, 5, 19);
-  ssd1306_draw_string(ssd, "Duty Cycle:", 12, 35);
-  ssd1306_line(ssd, 12, 45, 114, 45, 1);
-  ssd1306_line(ssd, 12, 51, 114, 51, 1);
-  ssd1306_line(ssd, 11, 46, 11, 50, 1);
-  ssd1306_line(ssd, 115, 46, 115, 50, 1);
-  ssd1306_rect(ssd, 47, 13, duty_cycle, 3, 1, 1);
-  ssd1306_draw_string(ssd, value_duty_cycle, 45, 54);
+  char value[12];
+  ssd1306_load_template(ssd, ssd1306_tpl_pwm_config); // Moldura, "Motor", "Fpwm:", "Duty Cycle:" e contorno da barra
+  snprintf(value, sizeof(value), "%hhu", motor);
+  ssd1306_draw_string(ssd, value, 75, 3);
+  snprintf(value, sizeof(value), "%lu", (unsigned long)fpwm);
+  ssd1306_draw_string(ssd, value, 53, 19);
+  ssd1306_fill_bar(ssd, 13, duty_cycle, 47, 3);
+  snprintf(value, sizeof(value), "%hhu%%", duty_cycle);
+  ssd1306_draw_string(ssd, value, 45, 54);
   ssd1306_send_data(ssd);
 }
 
 // Função que mostra o PWM configurado com sucesso no display
 void draw_sucess_screen(ssd1306_t *ssd, uint8_t pwm)
 {
-  char value_pwm[10];
-  sprintf(value_pwm, "Pwm %hhu", pwm);
-  ssd1306_fill(ssd, 0);
-  ssd1306_rect(ssd, 0, 0, ssd->width, ssd->height, 1, 0);
-  ssd1306_line(ssd, 1, 14, 126, 14, 1);
-  ssd1306_draw_string(ssd, value_pwm, 41, 3);
-  ssd1306_draw_string(ssd, "Iniciado com", 13, 28);
-  ssd1306_draw_string(ssd, "Sucesso", 35, 38);
+  char value_pwm[4];
+  ssd1306_load_template(ssd, ssd1306_tpl_success);
+  snprintf(value_pwm, sizeof(value_pwm), "%hhu", pwm);
+  ssd1306_draw_string(ssd, value_pwm, 73, 3);
   ssd1306_send_data(ssd);
 }
 
@@ -285,11 +310,6 @@ void draw_sucess_screen(ssd1306_t *ssd, uint8_t pwm)
 // Função para mostrar a tela de configuração do USB
 void draw_opening_usb(ssd1306_t *ssd)
 {
-  ssd1306_fill(ssd, 0);
-  ssd1306_rect(ssd, 0, 0, ssd->width, ssd->height, 1, 0);
-  ssd1306_line(ssd, 1, 14, 126, 14, 1);
-  ssd1306_draw_string(ssd, "Conf. Usb", 26, 3);
-  ssd1306_draw_string(ssd, "Entre no", 13, 30);
-  ssd1306_draw_string(ssd, "Terminal", 45, 40);
+  ssd1306_load_template(ssd, ssd1306_tpl_usb);
   ssd1306_send_data(ssd);
-}
\ No newline at end of file
+}
@@ -1,3 +1,6 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
@@ -8,6 +11,7 @@
 #define I2C_PORT i2c1
 #define I2C_SDA 14
 #define I2C_SCL 15
+#define I2C_BAUD_HZ (400 * 1000)
 #define endereco 0x3C
 
 typedef enum {
@@ -43,6 +47,7 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_send_columns(ssd1306_t *ssd, uint8_t x0, uint8_t x1);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -52,8 +57,12 @@ void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+void ssd1306_load_template(ssd1306_t *ssd, const uint8_t *tpl);
+void ssd1306_fill_bar(ssd1306_t *ssd, uint8_t left, uint8_t width, uint8_t top, uint8_t height);
 void initDisplay(ssd1306_t *ssd);
 void draw_opening_screen(ssd1306_t *ssd);
 void draw_pwm_config(ssd1306_t *ssd, uint32_t fpwm, uint8_t duty_cycle, uint8_t motor);
 void draw_sucess_screen(ssd1306_t *ssd, uint8_t pwm);
-void draw_opening_usb(ssd1306_t *ssd);
\ No newline at end of file
+void draw_opening_usb(ssd1306_t *ssd);
+
+#endif
@@ -0,0 +1,279 @@
+// Gerado por tools/gen_screens.c a partir de lib/font.h; não editar à mão.
+// Buffers das partes fixas de cada tela, no formato de ssd1306_pixel (8 páginas por coluna).
+
+#ifndef SSD1306_TEMPLATES_H
+#define SSD1306_TEMPLATES_H
+
+#include <stdint.h>
+
+#define SSD1306_TEMPLATE_SIZE 1024
+
+static const uint8_t ssd1306_tpl_opening[SSD1306_TEMPLATE_SIZE] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0xC0, 0x1F, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xC0, 0x1F, 0x00, 0x80, 0x01, 0x40, 0xF0, 0x01, 0x40, 0x02, 0x00, 0x80,
+    0x01, 0x40, 0xF8, 0x01, 0x40, 0x02, 0x00, 0x80, 0x01, 0x40, 0x4C, 0x00, 0x40, 0x02, 0x00, 0x80,
+    0x01, 0x40, 0x44, 0x00, 0x40, 0x00, 0x00, 0x80, 0x01, 0x40, 0x4C, 0x00, 0x40, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0xF8, 0x01, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0xF0, 0x01, 0x00, 0x0E, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x80, 0x01, 0x40, 0x00, 0x01, 0x00, 0x11, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x03, 0x00, 0x11, 0x00, 0x80, 0x01, 0x40, 0x00, 0x02, 0x00, 0x11, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x02, 0x00, 0x1F, 0x1C, 0x80, 0x01, 0x40, 0x00, 0x02, 0x00, 0x0E, 0x3E, 0x80,
+    0xF1, 0x41, 0xF4, 0x03, 0x00, 0x00, 0x63, 0x80, 0xF9, 0x43, 0xF4, 0x01, 0x00, 0x1F, 0x41, 0x80,
+    0x09, 0x42, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x80, 0x09, 0x42, 0xF0, 0x00, 0x00, 0x01, 0x00, 0x80,
+    0x09, 0x42, 0xF0, 0x01, 0x00, 0x01, 0x30, 0x80, 0x19, 0x43, 0x00, 0x01, 0x00, 0x01, 0x78, 0x80,
+    0x11, 0x41, 0x00, 0x01, 0x00, 0x03, 0x48, 0x80, 0x01, 0x40, 0x00, 0x01, 0x00, 0x02, 0x48, 0x80,
+    0xC1, 0x41, 0xF0, 0x01, 0x00, 0x00, 0x48, 0x80, 0xE1, 0x43, 0xF0, 0x01, 0x00, 0x1F, 0x7F, 0x80,
+    0x21, 0x42, 0x00, 0x00, 0x00, 0x1F, 0x7F, 0x80, 0x21, 0x42, 0x20, 0x01, 0x00, 0x06, 0x00, 0x80,
+    0x21, 0x42, 0x70, 0x01, 0x00, 0x1E, 0x00, 0x80, 0xE1, 0x43, 0x50, 0x01, 0x00, 0x07, 0x00, 0x80,
+    0xC1, 0x41, 0x50, 0x01, 0x00, 0x1F, 0x44, 0x80, 0x01, 0x40, 0x50, 0x01, 0x00, 0x1E, 0x7D, 0x80,
+    0xE1, 0x43, 0xD0, 0x01, 0x00, 0x00, 0x7D, 0x80, 0xE1, 0x43, 0x90, 0x00, 0x00, 0x08, 0x40, 0x80,
+    0x21, 0x40, 0x00, 0x00, 0x00, 0x1D, 0x00, 0x80, 0x21, 0x40, 0x00, 0x00, 0x00, 0x15, 0x00, 0x80,
+    0x21, 0x40, 0x10, 0x00, 0x00, 0x15, 0x1C, 0x80, 0xE1, 0x43, 0x10, 0x00, 0x00, 0x15, 0x3C, 0x80,
+    0xC1, 0x43, 0xFC, 0x00, 0x00, 0x1F, 0x60, 0x80, 0x01, 0x40, 0xFC, 0x01, 0x00, 0x1E, 0x60, 0x80,
+    0x01, 0x40, 0x10, 0x01, 0x00, 0x00, 0x60, 0x80, 0x41, 0x42, 0x10, 0x01, 0x00, 0x00, 0x3C, 0x80,
+    0xF1, 0x43, 0x00, 0x00, 0x00, 0x01, 0x1C, 0x80, 0xF9, 0x43, 0xE0, 0x00, 0x00, 0x01, 0x00, 0x80,
+    0x49, 0x42, 0xF0, 0x01, 0xC0, 0x0F, 0x00, 0x80, 0x19, 0x40, 0x50, 0x01, 0xC0, 0x1F, 0x00, 0x80,
+    0x11, 0x40, 0x50, 0x01, 0x00, 0x11, 0x80, 0x80, 0x01, 0x40, 0x50, 0x01, 0x00, 0x11, 0xE0, 0x80,
+    0x01, 0x40, 0x70, 0x01, 0x00, 0x00, 0x60, 0x80, 0x01, 0x40, 0x60, 0x00, 0x00, 0x0E, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x80, 0x03, 0x1F, 0x00, 0x80, 0x01, 0x43, 0x00, 0xC0, 0x07, 0x11, 0x00, 0x80,
+    0x01, 0x43, 0x00, 0x40, 0x05, 0x11, 0x3C, 0x80, 0x01, 0x40, 0x00, 0x40, 0x05, 0x11, 0x7C, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0x05, 0x1F, 0x60, 0x80, 0x01, 0x40, 0x00, 0xC0, 0x05, 0x0E, 0x30, 0x80,
+    0x01, 0x40, 0x00, 0x80, 0x01, 0x00, 0x60, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x3C, 0x80, 0x01, 0x40, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0xE0, 0x01, 0x00, 0x00, 0x7C, 0x80, 0x01, 0x40, 0x20, 0x01, 0x00, 0x00, 0x7C, 0x80,
+    0x01, 0x40, 0x20, 0x01, 0x00, 0x00, 0x04, 0x80, 0x01, 0x40, 0x20, 0x01, 0x00, 0x00, 0x04, 0x80,
+    0xF9, 0x43, 0xFC, 0x01, 0x00, 0x00, 0x04, 0x80, 0xF9, 0x43, 0xFC, 0x01, 0x00, 0x00, 0x0C, 0x80,
+    0x49, 0x40, 0x00, 0xC0, 0x03, 0x00, 0x08, 0x80, 0x49, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80,
+    0x49, 0x40, 0x00, 0x00, 0x06, 0x00, 0x20, 0x80, 0x79, 0x40, 0x10, 0x01, 0x03, 0x00, 0x74, 0x80,
+    0x31, 0x40, 0xF4, 0x01, 0x06, 0x00, 0x54, 0x80, 0x01, 0x40, 0xF4, 0xC1, 0x07, 0x00, 0x54, 0x80,
+    0xF9, 0x41, 0x00, 0xC1, 0x03, 0x00, 0x54, 0x80, 0xF9, 0x43, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x80,
+    0x01, 0x43, 0x00, 0xC0, 0x07, 0x00, 0x78, 0x80, 0x81, 0x41, 0x70, 0xC0, 0x07, 0x00, 0x00, 0x80,
+    0x01, 0x43, 0xF0, 0x40, 0x00, 0x00, 0xFC, 0x80, 0xF9, 0x43, 0x80, 0x41, 0x00, 0x00, 0xFC, 0x80,
+    0xF9, 0x41, 0x80, 0x41, 0x00, 0x00, 0x24, 0x80, 0x01, 0x40, 0x80, 0xC1, 0x00, 0x00, 0x24, 0x80,
+    0xF9, 0x43, 0xF0, 0x80, 0x00, 0x00, 0x24, 0x80, 0xF9, 0x43, 0x70, 0x00, 0x00, 0x00, 0x3C, 0x80,
+    0x71, 0x40, 0x00, 0x00, 0x02, 0x00, 0x18, 0x80, 0xE1, 0x40, 0x00, 0x40, 0x07, 0x00, 0x00, 0x80,
+    0x71, 0x40, 0x00, 0x40, 0x05, 0x00, 0x00, 0x80, 0xF9, 0x43, 0x00, 0x40, 0x05, 0x00, 0x00, 0x80,
+    0xF9, 0x43, 0x00, 0x40, 0x05, 0x00, 0x41, 0x80, 0x01, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x63, 0x80,
+    0x01, 0x40, 0x00, 0x80, 0x07, 0x00, 0x3E, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x1C, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x0F, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0xC0, 0x0F, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0x02, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x02, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0x02, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0xC0, 0x03, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x80, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const uint8_t ssd1306_tpl_usb[SSD1306_TEMPLATE_SIZE] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0xC0, 0x1F, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x1F, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x12, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0x12, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x12, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0x10, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x10, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0xF1, 0x41, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x80, 0xF9, 0x43, 0x00, 0x00, 0x1E, 0x00, 0x00, 0x80,
+    0x09, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x09, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x09, 0x42, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x19, 0x43, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x11, 0x41, 0x00, 0xC0, 0x0F, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0xC0, 0x1F, 0x00, 0x00, 0x80,
+    0xC1, 0x41, 0x00, 0x00, 0x11, 0x00, 0x00, 0x80, 0xE1, 0x43, 0x00, 0x00, 0x11, 0x00, 0x00, 0x80,
+    0x21, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x21, 0x42, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x80,
+    0x21, 0x42, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x80, 0xE1, 0x43, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0xC1, 0x41, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0xE1, 0x43, 0x00, 0x00, 0x03, 0x00, 0x00, 0x80, 0xE1, 0x43, 0x00, 0x00, 0x02, 0x00, 0x00, 0x80,
+    0x21, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x21, 0x40, 0x00, 0x00, 0x0E, 0x01, 0x00, 0x80,
+    0x21, 0x40, 0x00, 0x00, 0x1F, 0x01, 0x00, 0x80, 0xE1, 0x43, 0x00, 0x00, 0x15, 0x01, 0x00, 0x80,
+    0xC1, 0x43, 0x00, 0x00, 0x15, 0x7F, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x15, 0x7F, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x17, 0x01, 0x00, 0x80, 0x41, 0x42, 0x00, 0x00, 0x06, 0x01, 0x00, 0x80,
+    0xF1, 0x43, 0x00, 0x00, 0x00, 0x01, 0x00, 0x80, 0xF9, 0x43, 0x00, 0x00, 0x00, 0x38, 0x00, 0x80,
+    0x49, 0x42, 0x00, 0x00, 0x00, 0x7C, 0x00, 0x80, 0x19, 0x40, 0x00, 0x00, 0x00, 0x54, 0x00, 0x80,
+    0x11, 0x40, 0x00, 0x00, 0x00, 0x54, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x54, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x5C, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x18, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x43, 0x00, 0x00, 0x1F, 0x7C, 0x00, 0x80,
+    0x01, 0x43, 0x00, 0x00, 0x1F, 0x7C, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x04, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x04, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x04, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x1F, 0x0C, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x1E, 0x08, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x0E, 0x7C, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x1F, 0x7C, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x11, 0x18, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x11, 0x78, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x11, 0x1C, 0x00, 0x80,
+    0xF9, 0x43, 0x00, 0x00, 0x1F, 0x7C, 0x00, 0x80, 0xF9, 0x43, 0x00, 0x00, 0x0E, 0x78, 0x00, 0x80,
+    0x01, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xF9, 0x43, 0x00, 0x00, 0x00, 0x44, 0x00, 0x80,
+    0xF9, 0x43, 0x00, 0x00, 0x00, 0x7D, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x7D, 0x00, 0x80,
+    0x41, 0x42, 0x00, 0x00, 0x00, 0x40, 0x00, 0x80, 0xE1, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0xA1, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xA1, 0x42, 0x00, 0x00, 0x00, 0x7C, 0x00, 0x80,
+    0xA1, 0x42, 0x00, 0x00, 0x00, 0x7C, 0x00, 0x80, 0xA1, 0x43, 0x00, 0x00, 0x00, 0x04, 0x00, 0x80,
+    0x21, 0x41, 0x00, 0x00, 0x00, 0x04, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x04, 0x00, 0x80,
+    0xF9, 0x43, 0x00, 0x00, 0x00, 0x7C, 0x00, 0x80, 0xF9, 0x43, 0x00, 0x00, 0x00, 0x78, 0x00, 0x80,
+    0x41, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x41, 0x42, 0x00, 0x00, 0x00, 0x20, 0x00, 0x80,
+    0x41, 0x42, 0x00, 0x00, 0x00, 0x74, 0x00, 0x80, 0xC1, 0x43, 0x00, 0x00, 0x00, 0x54, 0x00, 0x80,
+    0x81, 0x41, 0x00, 0x00, 0x00, 0x54, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x54, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x7C, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x78, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x41, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x40, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const uint8_t ssd1306_tpl_success[SSD1306_TEMPLATE_SIZE] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x10, 0x04, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x10, 0x04, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xF0, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0xF0, 0x07, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x10, 0x04, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x10, 0x04, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x07, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x04, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xD0, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0xD0, 0x07, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x04, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x80, 0x09, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xC0, 0x1B, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x43, 0x12, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x47, 0x12, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x44, 0x12, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0xC4, 0x1E, 0x00, 0x80, 0xF9, 0x43, 0x00, 0x40, 0x84, 0x0C, 0x00, 0x80,
+    0xF9, 0x43, 0x00, 0xC0, 0x06, 0x00, 0x00, 0x80, 0x49, 0x40, 0x00, 0x80, 0x02, 0x0F, 0x00, 0x80,
+    0x49, 0x40, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x80, 0x49, 0x40, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80,
+    0x79, 0x40, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x31, 0x40, 0x00, 0x40, 0x04, 0x10, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xD0, 0x07, 0x1F, 0x00, 0x80, 0xE1, 0x41, 0x00, 0xD0, 0x07, 0x1F, 0x00, 0x80,
+    0xE1, 0x43, 0x00, 0x00, 0x04, 0x00, 0x00, 0x80, 0x01, 0x43, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x80,
+    0x81, 0x41, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x80, 0x01, 0x43, 0x00, 0x00, 0x02, 0x11, 0x00, 0x80,
+    0xE1, 0x43, 0x00, 0x40, 0x07, 0x11, 0x00, 0x80, 0xE1, 0x41, 0x00, 0x40, 0x05, 0x11, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0x05, 0x1B, 0x00, 0x80, 0xE1, 0x43, 0x00, 0x40, 0x05, 0x0A, 0x00, 0x80,
+    0xE1, 0x43, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80, 0xC1, 0x40, 0x00, 0x80, 0x07, 0x0E, 0x00, 0x80,
+    0xC1, 0x43, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x80, 0xE1, 0x40, 0x00, 0x00, 0x03, 0x15, 0x00, 0x80,
+    0xE1, 0x43, 0x00, 0x80, 0x07, 0x15, 0x00, 0x80, 0xC1, 0x43, 0x00, 0x80, 0x04, 0x15, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x80, 0x04, 0x17, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x04, 0x06, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xF0, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0xF0, 0x07, 0x12, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x17, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x03, 0x15, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x07, 0x15, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x04, 0x15, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0x04, 0x1D, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x04, 0x09, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x03, 0x12, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x17, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x15, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x15, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x15, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x1D, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x09, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x03, 0x11, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x07, 0x11, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x04, 0x11, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0x04, 0x1F, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x04, 0x0E, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x06, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x02, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x03, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x04, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x40, 0x04, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x40, 0x04, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x03, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x80, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0xC0, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0xC0, 0x07, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x80, 0x07, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const uint8_t ssd1306_tpl_pwm_config[SSD1306_TEMPLATE_SIZE] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0xF8, 0x03, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0xF8, 0x03, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x48, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x48, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x48, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x08, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x08, 0x00, 0x01, 0xC0, 0x07, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xF9, 0x23, 0x08, 0x80, 0x01, 0x40, 0xE0, 0x07, 0xF9, 0x23, 0x08, 0x80,
+    0x01, 0x40, 0xE0, 0x07, 0x09, 0x22, 0x08, 0x80, 0x01, 0x40, 0x20, 0x01, 0x09, 0x22, 0x08, 0x80,
+    0x01, 0x40, 0x20, 0x01, 0x19, 0x23, 0x08, 0x80, 0x01, 0x40, 0x20, 0x01, 0xF1, 0x21, 0x08, 0x80,
+    0x01, 0x40, 0xE0, 0x01, 0xE1, 0x20, 0x08, 0x80, 0x01, 0x40, 0xC0, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xE1, 0x21, 0x08, 0x80, 0x01, 0x40, 0xE0, 0x01, 0xE1, 0x23, 0x08, 0x80,
+    0x01, 0x40, 0xE0, 0x03, 0x01, 0x22, 0x08, 0x80, 0x01, 0x40, 0x00, 0x03, 0x01, 0x22, 0x08, 0x80,
+    0x01, 0x40, 0x80, 0x01, 0x01, 0x22, 0x08, 0x80, 0x01, 0x40, 0x00, 0x03, 0xE1, 0x23, 0x08, 0x80,
+    0x01, 0x40, 0xE0, 0x03, 0xE1, 0x23, 0x08, 0x80, 0xF9, 0x43, 0xE0, 0x01, 0x01, 0x20, 0x08, 0x80,
+    0xF9, 0x43, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x71, 0x40, 0xE0, 0x03, 0x21, 0x20, 0x08, 0x80,
+    0xE1, 0x40, 0xE0, 0x03, 0x21, 0x20, 0x08, 0x80, 0x71, 0x40, 0xC0, 0x00, 0xF9, 0x21, 0x08, 0x80,
+    0xF9, 0x43, 0xC0, 0x03, 0xF9, 0x23, 0x08, 0x80, 0xF9, 0x43, 0xE0, 0x00, 0x21, 0x22, 0x08, 0x80,
+    0x01, 0x40, 0xE0, 0x03, 0x21, 0x22, 0x08, 0x80, 0xC1, 0x41, 0xC0, 0x03, 0x01, 0x20, 0x08, 0x80,
+    0xE1, 0x43, 0x00, 0x00, 0xE1, 0x24, 0x08, 0x80, 0x21, 0x42, 0x00, 0x00, 0xE1, 0x25, 0x08, 0x80,
+    0x21, 0x42, 0x00, 0x00, 0x01, 0x25, 0x08, 0x80, 0x21, 0x42, 0x00, 0x00, 0x01, 0x25, 0x08, 0x80,
+    0xE1, 0x43, 0x30, 0x03, 0x01, 0x25, 0x08, 0x80, 0xC1, 0x41, 0x30, 0x03, 0xE1, 0x27, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xE1, 0x23, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x21, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x21, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0xF9, 0x41, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0xF9, 0x43, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x21, 0x42, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x21, 0x42, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0xC1, 0x41, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0xE1, 0x43, 0x00, 0x00, 0xF1, 0x21, 0x08, 0x80, 0x21, 0x42, 0x00, 0x00, 0xF9, 0x23, 0x08, 0x80,
+    0x21, 0x42, 0x00, 0x00, 0x09, 0x22, 0x08, 0x80, 0x21, 0x42, 0x00, 0x00, 0x09, 0x22, 0x08, 0x80,
+    0xE1, 0x43, 0x00, 0x00, 0x09, 0x22, 0x08, 0x80, 0xC1, 0x41, 0x00, 0x00, 0x19, 0x23, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x11, 0x21, 0x08, 0x80, 0xE1, 0x43, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0xE1, 0x43, 0x00, 0x00, 0xE1, 0x24, 0x08, 0x80, 0x21, 0x40, 0x00, 0x00, 0xE1, 0x25, 0x08, 0x80,
+    0x21, 0x40, 0x00, 0x00, 0x01, 0x25, 0x08, 0x80, 0x21, 0x40, 0x00, 0x00, 0x01, 0x25, 0x08, 0x80,
+    0x61, 0x40, 0x00, 0x00, 0x01, 0x25, 0x08, 0x80, 0x41, 0x40, 0x00, 0x00, 0xE1, 0x27, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xE1, 0x23, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xC1, 0x21, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0xE1, 0x23, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x21, 0x22, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x21, 0x22, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x21, 0x22, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x61, 0x23, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x41, 0x21, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x09, 0x22, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0xF9, 0x23, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xF9, 0x23, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x22, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xC1, 0x21, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0xE1, 0x23, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xA1, 0x22, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0xA1, 0x22, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xA1, 0x22, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0xE1, 0x22, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0xC1, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x31, 0x23, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x31, 0x23, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x20, 0x08, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0xC0, 0x07, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80,
+    0x01, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+#endif
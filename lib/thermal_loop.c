@@ -0,0 +1,137 @@
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "thermal_loop.h"
+#include "pid_loop.h"
+#include "pwm_wave.h"
+#include "pwm_dither.h"
+#include "hbridge.h"
+
+typedef struct
+{
+    bool fixed;     // Canal em duty fixo, sob controle deste módulo
+    uint gpio;
+    uint16_t top;
+    uint16_t level; // Nível comandado, antes do limite
+} out_t;
+
+static derate_t derate;
+static out_t outs[DERATE_CHANNELS];
+static repeating_timer_t timer;
+static volatile int32_t injected = INT32_MIN;
+static volatile bool changed;
+
+static void write_level(uint32_t ch)
+{
+    out_t *o = &outs[ch];
+    uint16_t level = derate_apply(o->level, derate.factor[ch], o->top);
+    if (hbridge_set_level(o->gpio, level))
+    {
+        return; // Meia ponte: as duas comparações já foram escritas juntas
+    }
+    pwm_wave_update_sibling(o->gpio, level); // O outro canal do slice pode estar tocando uma forma de onda
+    pwm_dither_update_sibling(o->gpio, level);
+    pwm_set_gpio_level(o->gpio, level);
+}
+
+static bool tick_cb(repeating_timer_t *rt)
+{
+    int32_t t = injected;
+    if (t == INT32_MIN)
+    {
+        // Com o ADC em modo livre (captura contínua) a leitura avulsa não é possível; mantém o fator
+        if (adc_hw->cs & ADC_CS_START_MANY_BITS)
+        {
+            return true;
+        }
+        uint prev_input = adc_get_selected_input();
+        adc_select_input(4);
+        t = derate_adc_to_mc(adc_read());
+        adc_select_input(prev_input);
+    }
+
+    if (derate_step(&derate, t))
+    {
+        for (uint32_t ch = 0; ch < DERATE_CHANNELS; ch++)
+        {
+            pid_loop_set_derate(ch, derate.factor[ch]);
+            if (outs[ch].fixed)
+            {
+                write_level(ch);
+            }
+        }
+        changed = true;
+    }
+    return true;
+}
+
+void thermal_loop_start(void)
+{
+    derate_init(&derate, THERMAL_LOOP_FILTER_SHIFT);
+    adc_set_temp_sensor_enabled(true);
+    add_repeating_timer_ms(-THERMAL_LOOP_PERIOD_MS, tick_cb, NULL, &timer);
+}
+
+void thermal_loop_set_level(uint32_t ch, uint32_t gpio, uint16_t level)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    outs[ch] = (out_t){.fixed = true, .gpio = gpio, .top = pwm_hw->slice[pwm_gpio_to_slice_num(gpio)].top, .level = level};
+    write_level(ch);
+    restore_interrupts(ints);
+}
+
+void thermal_loop_retime(uint32_t ch, uint16_t old_top, uint16_t new_top)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    out_t *o = &outs[ch];
+    if (o->fixed)
+    {
+        o->level = (uint16_t)MIN(((uint32_t)o->level * (new_top + 1u)) / (old_top + 1u), new_top + 1u);
+        o->top = new_top;
+        write_level(ch);
+    }
+    restore_interrupts(ints);
+}
+
+void thermal_loop_release(uint32_t ch)
+{
+    outs[ch].fixed = false;
+}
+
+bool thermal_loop_set_policy(uint32_t ch, int32_t start_mc, int32_t full_mc, uint16_t floor, int32_t hyst_mc)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    bool ok = derate_set_policy(&derate, ch, start_mc, full_mc, floor, hyst_mc);
+    restore_interrupts(ints);
+    return ok;
+}
+
+void thermal_loop_inject(int32_t temp_mc)
+{
+    injected = temp_mc;
+}
+
+int32_t thermal_loop_temp_mc(void)
+{
+    return derate_temp_mc(&derate);
+}
+
+uint16_t thermal_loop_factor(uint32_t ch)
+{
+    return derate.factor[ch];
+}
+
+derate_policy_t thermal_loop_policy(uint32_t ch)
+{
+    return derate.policy[ch];
+}
+
+bool thermal_loop_poll_changed(void)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    bool c = changed;
+    changed = false;
+    restore_interrupts(ints);
+    return c;
+}
@@ -0,0 +1,43 @@
+#ifndef THERMAL_LOOP_H
+#define THERMAL_LOOP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "derate.h"
+
+// Redução de potência em segundo plano: um timer repetitivo lê o sensor de temperatura do
+// chip, atualiza o núcleo (derate.c) e, quando um fator muda, reescreve o comparador dos
+// canais em duty fixo e o limite dos canais em laço PID. Nada disso passa pelo MQTT.
+// Servo e formas de onda não são limitados (o pulso do servo é uma posição, não potência).
+
+#ifndef THERMAL_LOOP_PERIOD_MS
+#define THERMAL_LOOP_PERIOD_MS 100
+#endif
+#ifndef THERMAL_LOOP_FILTER_SHIFT
+#define THERMAL_LOOP_FILTER_SHIFT 3 // Constante de tempo de ~0,8 s a 10 Hz
+#endif
+
+void thermal_loop_start(void);
+
+// Duty fixo comandado no canal; o nível escrito é o comandado limitado pelo fator atual
+void thermal_loop_set_level(uint32_t ch, uint32_t gpio, uint16_t level);
+
+// O TOP do slice mudou (troca de clock): reescala o nível comandado e reescreve
+void thermal_loop_retime(uint32_t ch, uint16_t old_top, uint16_t new_top);
+
+// O canal passou a ser controlado por outro modo (forma de onda, servo, PID, reconfiguração)
+void thermal_loop_release(uint32_t ch);
+
+bool thermal_loop_set_policy(uint32_t ch, int32_t start_mc, int32_t full_mc, uint16_t floor, int32_t hyst_mc);
+
+// Substitui o sensor por uma temperatura fixa (teste em bancada); INT32_MIN volta ao sensor
+void thermal_loop_inject(int32_t temp_mc);
+
+int32_t thermal_loop_temp_mc(void);
+uint16_t thermal_loop_factor(uint32_t ch);
+derate_policy_t thermal_loop_policy(uint32_t ch);
+
+// Retorna true uma vez depois de cada mudança de fator, para a publicação no laço principal
+bool thermal_loop_poll_changed(void);
+
+#endif
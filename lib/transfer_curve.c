@@ -0,0 +1,112 @@
+#include <math.h>
+#include "transfer_curve.h"
+
+void transfer_curve_set_linear(transfer_curve_t *c)
+{
+    c->kind = TRANSFER_LINEAR;
+    c->n_knots = 0;
+}
+
+bool transfer_curve_set_gamma(transfer_curve_t *c, uint32_t gamma_milli)
+{
+    if (gamma_milli < TRANSFER_CURVE_GAMMA_MIN || gamma_milli > TRANSFER_CURVE_GAMMA_MAX)
+    {
+        return false;
+    }
+    // powf só nos nós, fora do caminho de escrita; o resto da tabela é interpolado
+    float g = gamma_milli / 1000.0f;
+    for (uint32_t i = 0; i < TRANSFER_CURVE_GAMMA_KNOTS; i++)
+    {
+        float x = (float)i / (TRANSFER_CURVE_GAMMA_KNOTS - 1);
+        c->knots[i] = (uint32_t)(powf(x, g) * 65536.0f + 0.5f);
+    }
+    c->kind = TRANSFER_GAMMA;
+    c->gamma_milli = gamma_milli;
+    c->n_knots = TRANSFER_CURVE_GAMMA_KNOTS;
+    return true;
+}
+
+void transfer_curve_set_cie(transfer_curve_t *c)
+{
+    c->kind = TRANSFER_CIE;
+    c->n_knots = 0;
+}
+
+bool transfer_curve_set_lut(transfer_curve_t *c, const uint16_t *points, uint32_t n)
+{
+    if (n < TRANSFER_CURVE_MIN_POINTS || n > TRANSFER_CURVE_MAX_POINTS)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (points[i] > 1000)
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        c->knots[i] = ((uint32_t)points[i] * 65536u + 500) / 1000;
+    }
+    c->kind = TRANSFER_LUT;
+    c->n_knots = n;
+    return true;
+}
+
+// Saída em Q16 para a entrada em milésimos
+static uint32_t curve_q16(const transfer_curve_t *c, uint32_t x)
+{
+    switch (c->kind)
+    {
+    case TRANSFER_CIE:
+        // Luminância relativa para L* = x / 10: trecho linear até L* = 8, cúbico acima
+        if (x <= 80)
+        {
+            return (x * 65536u * 10u + 45165u) / 90330u;
+        }
+        else
+        {
+            uint64_t l = x + 160; // (L* + 16) em décimos
+            return (uint32_t)((l * l * l * 65536u + 780448000ull) / 1560896000ull);
+        }
+    case TRANSFER_GAMMA:
+    case TRANSFER_LUT:
+    {
+        uint32_t pos = x * (c->n_knots - 1u);
+        uint32_t seg = pos / TRANSFER_CURVE_STEPS;
+        uint32_t frac = pos % TRANSFER_CURVE_STEPS;
+        if (seg >= c->n_knots - 1u)
+        {
+            return c->knots[c->n_knots - 1];
+        }
+        int32_t a = c->knots[seg];
+        int32_t b = c->knots[seg + 1];
+        return (uint32_t)(a + (int32_t)(((int64_t)(b - a) * frac) / TRANSFER_CURVE_STEPS));
+    }
+    default:
+        return (x * 65536u + 500) / 1000;
+    }
+}
+
+void transfer_curve_build(transfer_curve_t *c, uint16_t top)
+{
+    c->top = top;
+    if (top == 0)
+    {
+        return;
+    }
+    // Mesma escala de duty_to_level: 100% corresponde ao nível top
+    for (uint32_t x = 0; x <= TRANSFER_CURVE_STEPS; x++)
+    {
+        uint32_t q = curve_q16(c, x);
+        q = q > 65536u ? 65536u : q;
+        c->table[x] = (uint16_t)(((uint64_t)q * top + 32768) >> 16);
+    }
+}
+
+const char *transfer_curve_name(transfer_kind_t kind)
+{
+    static const char *const names[] = {"linear", "gamma", "cie", "lut"};
+    return kind <= TRANSFER_LUT ? names[kind] : "?";
+}
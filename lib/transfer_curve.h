@@ -0,0 +1,62 @@
+#ifndef TRANSFER_CURVE_H
+#define TRANSFER_CURVE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Curva de transferência do duty pedido para o nível do comparador, para o brilho do LED
+// variar de forma perceptualmente uniforme. A curva (gamma, luminosidade CIE 1931 ou pontos
+// enviados pelo usuário) é convertida uma vez em uma tabela de níveis já escalados para o
+// TOP do canal; no caminho de escrita resta uma leitura indexada. Sem dependências do SDK.
+
+// Entrada em milésimos do fundo de escala (0-1000)
+#define TRANSFER_CURVE_STEPS 1000
+
+// Gamma em milésimos (2200 = 2,2)
+#define TRANSFER_CURVE_GAMMA_MIN 1000
+#define TRANSFER_CURVE_GAMMA_MAX 4000
+
+// Pontos igualmente espaçados da curva do usuário, interpolados linearmente
+#define TRANSFER_CURVE_MIN_POINTS 2
+#define TRANSFER_CURVE_MAX_POINTS 33
+
+// Nós da gamma (2^6 segmentos), também interpolados
+#define TRANSFER_CURVE_GAMMA_KNOTS 65
+
+typedef enum
+{
+    TRANSFER_LINEAR = 0,
+    TRANSFER_GAMMA,
+    TRANSFER_CIE,
+    TRANSFER_LUT,
+} transfer_kind_t;
+
+typedef struct
+{
+    transfer_kind_t kind;
+    uint16_t gamma_milli;
+    uint8_t n_knots;
+    uint32_t knots[TRANSFER_CURVE_GAMMA_KNOTS]; // Saída em Q16 (65536 = 100%)
+    uint16_t top;                               // TOP da tabela atual (0 = sem tabela)
+    uint16_t table[TRANSFER_CURVE_STEPS + 1];
+} transfer_curve_t;
+
+void transfer_curve_set_linear(transfer_curve_t *c);
+bool transfer_curve_set_gamma(transfer_curve_t *c, uint32_t gamma_milli);
+void transfer_curve_set_cie(transfer_curve_t *c);
+
+// Pontos de saída em milésimos (0-1000) para entradas igualmente espaçadas de 0 a 1000
+bool transfer_curve_set_lut(transfer_curve_t *c, const uint16_t *points, uint32_t n);
+
+// Regera a tabela para o TOP do canal; top = 0 descarta a tabela
+void transfer_curve_build(transfer_curve_t *c, uint16_t top);
+
+// Nível para uma entrada em milésimos; só vale se c->top for o TOP atual do canal
+static inline uint16_t transfer_curve_level(const transfer_curve_t *c, uint32_t permille)
+{
+    return c->table[permille > TRANSFER_CURVE_STEPS ? TRANSFER_CURVE_STEPS : permille];
+}
+
+const char *transfer_curve_name(transfer_kind_t kind);
+
+#endif
@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "ui_view.h"
+#include "oled_chart.h"
+
+static ssd1306_t *disp;
+static ui_view_t view = {.ch = {{.mode = "---"}, {.mode = "---"}, {.mode = "---"}}};
+static volatile uint32_t generation; // Incrementa a cada mudança
+static uint32_t drawn_generation;
+static uint64_t next_frame_us;
+static ui_view_stats_t stats = {.rate_hz = UI_VIEW_DEFAULT_RATE_HZ};
+
+// Gráfico: configuração pedida e estado da varredura no display
+static oled_chart_t chart;
+static bool chart_drawn;          // O display mostra o gráfico (senão precisa recomeçar)
+static uint32_t chart_mask;
+static uint32_t chart_period_us;
+static bool chart_freq;
+static ui_chart_sample_fn chart_sample;
+static uint64_t next_sample_us;
+
+void ui_view_init(ssd1306_t *ssd)
+{
+    disp = ssd; // Mudanças anteriores (callbacks durante a conexão) aparecem no primeiro quadro
+}
+
+static void set_mode(ui_channel_t *c, const char *mode)
+{
+    strncpy(c->mode, mode, sizeof(c->mode) - 1);
+    c->mode[sizeof(c->mode) - 1] = '\0';
+}
+
+void ui_view_set_duty(uint32_t ch, uint32_t freq_hz, uint32_t duty_pct, const char *mode)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    ui_channel_t *c = &view.ch[ch];
+    c->freq_hz = freq_hz;
+    c->duty_pct = duty_pct > 100 ? 100 : duty_pct;
+    c->configured = false;
+    set_mode(c, mode);
+    view.focus = ch;
+    generation++;
+    stats.updates++;
+    restore_interrupts(ints);
+}
+
+void ui_view_set_configured(uint32_t ch, uint32_t freq_hz, const char *mode)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    ui_channel_t *c = &view.ch[ch];
+    c->freq_hz = freq_hz;
+    c->duty_pct = 0;
+    c->configured = true;
+    set_mode(c, mode);
+    view.focus = ch;
+    generation++;
+    stats.updates++;
+    restore_interrupts(ints);
+}
+
+void ui_view_set_screen(ui_screen_t screen)
+{
+    if (screen == UI_SCREEN_CHART && chart_sample == NULL)
+    {
+        return;
+    }
+    view.screen = screen;
+    generation++;
+}
+
+bool ui_view_chart(uint32_t mask, uint32_t rate_hz, bool freq, ui_chart_sample_fn sample)
+{
+    mask &= (1u << UI_VIEW_CHANNELS) - 1;
+    if (mask == 0 || rate_hz < UI_CHART_RATE_MIN_HZ || rate_hz > UI_CHART_RATE_MAX_HZ || sample == NULL)
+    {
+        return false;
+    }
+    chart_mask = mask;
+    chart_period_us = 1000000u / rate_hz;
+    chart_freq = freq;
+    chart_sample = sample;
+    chart_drawn = false; // Recomeça com as faixas da nova configuração
+    ui_view_set_screen(UI_SCREEN_CHART);
+    return true;
+}
+
+// Uma coluna por período de amostragem; as outras telas ficam paradas enquanto o gráfico aparece
+static void service_chart(uint64_t now)
+{
+    if (!chart_drawn)
+    {
+        oled_chart_begin(&chart, disp, __builtin_popcount(chart_mask));
+        chart_drawn = true;
+        next_sample_us = now;
+    }
+    if (now < next_sample_us)
+    {
+        return;
+    }
+
+    uint16_t values[OLED_CHART_MAX_LANES];
+    uint32_t lane = 0;
+    for (uint32_t ch = 0; ch < UI_VIEW_CHANNELS; ch++)
+    {
+        if (chart_mask & (1u << ch))
+        {
+            values[lane++] = chart_sample(ch, chart_freq);
+        }
+    }
+    oled_chart_push(&chart, disp, values);
+    stats.chart_samples++;
+
+    // Sem acumular atraso, mas sem rajada de colunas se o laço atrasar muito
+    next_sample_us += chart_period_us;
+    if (next_sample_us < now)
+    {
+        next_sample_us = now + chart_period_us;
+    }
+}
+
+bool ui_view_set_rate(uint32_t hz)
+{
+    if (hz < UI_VIEW_RATE_MIN_HZ || hz > UI_VIEW_RATE_MAX_HZ)
+    {
+        return false;
+    }
+    stats.rate_hz = hz;
+    return true;
+}
+
+// Frequência em no máximo 5 caracteres: "500", "12.5k", "1.25M"
+static void format_freq(char *out, size_t n, uint32_t hz)
+{
+    if (hz >= 1000000)
+    {
+        snprintf(out, n, "%lu.%02luM", (unsigned long)(hz / 1000000), (unsigned long)(hz % 1000000 / 10000));
+    }
+    else if (hz >= 1000)
+    {
+        snprintf(out, n, "%lu.%luk", (unsigned long)(hz / 1000), (unsigned long)(hz % 1000 / 100));
+    }
+    else
+    {
+        snprintf(out, n, "%lu", (unsigned long)hz);
+    }
+}
+
+// Uma linha por canal: letra, duty, frequência e modo, com a barra do duty embaixo
+static void draw_overview(const ui_view_t *v)
+{
+    static const char names[UI_VIEW_CHANNELS] = {'G', 'B', 'R'};
+    char line[20];
+    char freq[12];
+
+    ssd1306_fill(disp, 0);
+    ssd1306_rect(disp, 0, 0, disp->width, disp->height, 1, 0);
+    ssd1306_line(disp, 1, 14, 126, 14, 1);
+    ssd1306_draw_string(disp, "Canais", 40, 3);
+    for (int i = 0; i < UI_VIEW_CHANNELS; i++)
+    {
+        const ui_channel_t *c = &v->ch[i];
+        uint8_t y = 17 + i * 15;
+        format_freq(freq, sizeof(freq), c->freq_hz);
+        snprintf(line, sizeof(line), "%c%3u%% %-5s %s", names[i], c->duty_pct, freq, c->mode);
+        ssd1306_draw_string(disp, line, 3, y);
+        ssd1306_fill_bar(disp, 3, (c->duty_pct * 122) / 100, y + 9, 2);
+    }
+    ssd1306_send_data(disp);
+}
+
+bool ui_view_service(void)
+{
+    uint64_t now = time_us_64();
+    uint32_t gen = generation;
+    if (disp == NULL)
+    {
+        return false;
+    }
+    if (view.screen == UI_SCREEN_CHART)
+    {
+        service_chart(now);
+    }
+    if (gen == drawn_generation || now < next_frame_us)
+    {
+        return false;
+    }
+
+    uint32_t ints = save_and_disable_interrupts();
+    ui_view_t v = view;
+    gen = generation;
+    restore_interrupts(ints);
+
+    const ui_channel_t *c = &v.ch[v.focus];
+    if (v.screen == UI_SCREEN_CHART)
+    {
+        // O display é do gráfico; o estado novo só aparece ao voltar às outras telas
+    }
+    else if (v.screen == UI_SCREEN_OVERVIEW)
+    {
+        draw_overview(&v);
+    }
+    else if (c->configured)
+    {
+        draw_sucess_screen(disp, v.focus + 1);
+    }
+    else
+    {
+        draw_pwm_config(disp, c->freq_hz, c->duty_pct, v.focus + 1);
+    }
+    if (v.screen != UI_SCREEN_CHART)
+    {
+        chart_drawn = false; // Voltar ao gráfico redesenha as faixas
+    }
+
+    // Mudanças feitas durante o desenho ficam para o próximo quadro
+    drawn_generation = gen;
+    next_frame_us = now + 1000000u / stats.rate_hz;
+    uint32_t elapsed = (uint32_t)(time_us_64() - now);
+    stats.frames++;
+    stats.render_max_us = elapsed > stats.render_max_us ? elapsed : stats.render_max_us;
+    return true;
+}
+
+void ui_view_get_stats(ui_view_stats_t *out)
+{
+    uint32_t ints = save_and_disable_interrupts();
+    *out = stats;
+    restore_interrupts(ints);
+}
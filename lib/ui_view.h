@@ -0,0 +1,73 @@
+#ifndef UI_VIEW_H
+#define UI_VIEW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+// Interface em modo retido: os tratadores de comando só atualizam o estado da tela (frequência,
+// duty e modo de cada canal) e o compositor redesenha o display no laço principal, em taxa fixa
+// e só quando algo mudou. Rajadas de comandos viram no máximo um quadro por período, então o
+// custo do display fica limitado e a escrita no I2C sai do contexto dos callbacks do lwIP.
+
+#define UI_VIEW_CHANNELS 3
+#define UI_VIEW_RATE_MIN_HZ 1
+#define UI_VIEW_RATE_MAX_HZ 20 // O laço principal roda a cada 50 ms
+#define UI_VIEW_DEFAULT_RATE_HZ 10
+
+typedef enum
+{
+    UI_SCREEN_CHANNEL = 0, // Canal atualizado por último, como as telas antigas
+    UI_SCREEN_OVERVIEW,    // Os três canais ao mesmo tempo
+    UI_SCREEN_CHART,       // Histórico de duty ou frequência, uma coluna por amostra
+} ui_screen_t;
+
+// Taxa de amostragem do gráfico (limitada pelo laço principal, como o compositor)
+#define UI_CHART_RATE_MIN_HZ 1
+#define UI_CHART_RATE_MAX_HZ 20
+
+// Valor de um canal para o gráfico, em milésimos da faixa
+typedef uint16_t (*ui_chart_sample_fn)(uint32_t ch, bool freq);
+
+typedef struct
+{
+    uint32_t freq_hz;
+    uint8_t duty_pct;
+    bool configured;   // Recebeu configuração e ainda não recebeu duty (tela de sucesso)
+    char mode[4];      // "PWM", "SRV", "PID", ...
+} ui_channel_t;
+
+typedef struct
+{
+    ui_channel_t ch[UI_VIEW_CHANNELS];
+    uint8_t focus;     // Canal da tela individual
+    ui_screen_t screen;
+} ui_view_t;
+
+typedef struct
+{
+    uint32_t rate_hz;
+    uint32_t updates;  // Mudanças de estado recebidas
+    uint32_t frames;   // Quadros desenhados
+    uint32_t render_max_us;
+    uint32_t chart_samples; // Colunas enviadas pelo gráfico
+} ui_view_stats_t;
+
+void ui_view_init(ssd1306_t *ssd);
+
+// Atualizações de estado (podem ser chamadas dos callbacks; não tocam no display)
+void ui_view_set_duty(uint32_t ch, uint32_t freq_hz, uint32_t duty_pct, const char *mode);
+void ui_view_set_configured(uint32_t ch, uint32_t freq_hz, const char *mode);
+void ui_view_set_screen(ui_screen_t screen);
+bool ui_view_set_rate(uint32_t hz);
+
+// Configura e mostra o gráfico: canais da máscara (bit 0 = primeiro), amostras por segundo e
+// grandeza (duty ou frequência). A fonte é chamada no laço principal, a cada amostra.
+bool ui_view_chart(uint32_t mask, uint32_t rate_hz, bool freq, ui_chart_sample_fn sample);
+
+// Desenha um quadro se o estado mudou e o período já passou. Retorna true quando desenhou.
+bool ui_view_service(void);
+
+void ui_view_get_stats(ui_view_stats_t *out);
+
+#endif
@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "usb_shell.h"
+
+static const usb_shell_cmd_t *table;
+static size_t table_len;
+static void *table_ctx;
+static char line[USB_SHELL_LINE_LEN];
+static size_t line_len;
+static bool overflow; // Descarta até o fim da linha
+static bool echo = true;
+static usb_shell_stats_t stats;
+
+static void prompt(void)
+{
+    if (echo)
+    {
+        printf("> ");
+    }
+}
+
+// Divide a linha no próprio buffer; aspas agrupam e são removidas
+static int split(char *p, char **argv)
+{
+    int argc = 0;
+    while (*p && argc < USB_SHELL_MAX_ARGS)
+    {
+        while (*p == ' ' || *p == '\t')
+        {
+            p++;
+        }
+        if (*p == '\0')
+        {
+            break;
+        }
+        char quote = (*p == '"') ? *p++ : 0;
+        argv[argc++] = p;
+        while (*p && (quote ? *p != quote : (*p != ' ' && *p != '\t')))
+        {
+            p++;
+        }
+        if (*p)
+        {
+            *p++ = '\0';
+        }
+    }
+    return argc;
+}
+
+static void help(void)
+{
+    printf("ajuda                       esta lista\n");
+    printf("eco on|off                  eco e prompt (off para scripts)\n");
+    for (size_t i = 0; i < table_len; i++)
+    {
+        char head[32];
+        snprintf(head, sizeof(head), "%s %s", table[i].name, table[i].args);
+        printf("%-27s %s\n", head, table[i].help);
+    }
+}
+
+static bool execute(int argc, char **argv)
+{
+    if (strcmp(argv[0], "ajuda") == 0)
+    {
+        help();
+        return true;
+    }
+    if (strcmp(argv[0], "eco") == 0 && argc == 2 && (strcmp(argv[1], "on") == 0 || strcmp(argv[1], "off") == 0))
+    {
+        echo = strcmp(argv[1], "on") == 0;
+        return true;
+    }
+    for (size_t i = 0; i < table_len; i++)
+    {
+        if (strcmp(argv[0], table[i].name) == 0)
+        {
+            return table[i].fn(table_ctx, argc, argv);
+        }
+    }
+    printf("comando desconhecido: %s (ajuda lista os comandos)\n", argv[0]);
+    return false;
+}
+
+static void run_line(void)
+{
+    char *argv[USB_SHELL_MAX_ARGS];
+    line[line_len] = '\0';
+    int argc = split(line, argv);
+    line_len = 0;
+    if (argc == 0)
+    {
+        return;
+    }
+    stats.lines++;
+    if (execute(argc, argv))
+    {
+        printf("ok\n");
+    }
+    else
+    {
+        stats.errors++;
+        printf("erro\n");
+    }
+}
+
+void usb_shell_init(const usb_shell_cmd_t *cmds, size_t count, void *ctx)
+{
+    table = cmds;
+    table_len = count;
+    table_ctx = ctx;
+    prompt();
+}
+
+void usb_shell_service(void)
+{
+    for (int n = 0; n < USB_SHELL_MAX_CHARS_PER_POLL; n++)
+    {
+        int c = getchar_timeout_us(0);
+        if (c == PICO_ERROR_TIMEOUT)
+        {
+            return;
+        }
+
+        if (c == '\r' || c == '\n')
+        {
+            bool empty = line_len == 0 && !overflow;
+            if (echo && !empty)
+            {
+                printf("\n");
+            }
+            if (overflow)
+            {
+                overflow = false;
+                line_len = 0;
+                stats.overflows++;
+                printf("linha maior que %u caracteres\nerro\n", USB_SHELL_LINE_LEN - 1);
+            }
+            else if (!empty)
+            {
+                run_line();
+            }
+            if (!empty)
+            {
+                prompt();
+            }
+        }
+        else if (c == '\b' || c == 0x7F)
+        {
+            if (line_len > 0 && !overflow)
+            {
+                line_len--;
+                if (echo)
+                {
+                    printf("\b \b");
+                }
+            }
+        }
+        else if (c >= ' ' && !overflow)
+        {
+            if (line_len >= sizeof(line) - 1)
+            {
+                overflow = true;
+                continue;
+            }
+            line[line_len++] = (char)c;
+            if (echo)
+            {
+                putchar(c);
+            }
+        }
+    }
+}
+
+void usb_shell_get_stats(usb_shell_stats_t *out)
+{
+    *out = stats;
+}
@@ -0,0 +1,46 @@
+#ifndef USB_SHELL_H
+#define USB_SHELL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Terminal de comandos na USB (stdio). A leitura não bloqueia: a cada chamada do laço principal
+// os caracteres já recebidos são consumidos e, quando uma linha fecha, o comando é executado.
+// Uma linha pela metade não atrasa nada além dela mesma.
+//
+// Cada linha é dividida em argumentos por espaços (aspas agrupam um argumento com espaços).
+// A saída de cada comando termina com uma linha "ok" ou "erro", para uso por scripts.
+// "eco off" desliga o eco e o prompt; "ajuda" lista os comandos.
+
+#define USB_SHELL_LINE_LEN 192
+#define USB_SHELL_MAX_ARGS 8
+#define USB_SHELL_MAX_CHARS_PER_POLL 256 // Limita o tempo gasto por volta do laço
+
+// Retorna false em caso de erro (a mensagem detalhada já deve ter sido impressa)
+typedef bool (*usb_shell_fn)(void *ctx, int argc, char **argv);
+
+typedef struct
+{
+    const char *name;
+    const char *args; // Sintaxe dos argumentos, para a ajuda
+    const char *help;
+    usb_shell_fn fn;
+} usb_shell_cmd_t;
+
+typedef struct
+{
+    uint32_t lines;     // Linhas executadas
+    uint32_t errors;    // Comandos desconhecidos ou que falharam
+    uint32_t overflows; // Linhas descartadas por passar de USB_SHELL_LINE_LEN
+} usb_shell_stats_t;
+
+// A tabela precisa durar enquanto o terminal estiver em uso; ctx é repassado aos comandos
+void usb_shell_init(const usb_shell_cmd_t *cmds, size_t count, void *ctx);
+
+// Consome os caracteres disponíveis e executa as linhas completas
+void usb_shell_service(void);
+
+void usb_shell_get_stats(usb_shell_stats_t *out);
+
+#endif
@@ -0,0 +1,118 @@
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "hardware/watchdog.h"
+#include "lwip/timeouts.h"
+#include "watchdog_sup.h"
+
+// Registradores de rascunho 0-2 (o SDK usa os de 4 a 7 em watchdog_reboot)
+#define SCRATCH_MAGIC_IDX 0
+#define SCRATCH_REASON_IDX 1
+#define SCRATCH_COUNT_IDX 2
+#define SCRATCH_MAGIC 0x57445355 // "WDSU"
+
+static reboot_reason_t reason;
+static uint32_t reboot_count;
+static volatile uint32_t heartbeat;
+static uint32_t last_heartbeat;
+static uint32_t last_change_ms;
+static bool running;
+
+static const char *const reason_names[REBOOT_REASON_COUNT] = {"power_on", "watchdog", "link_lost", "requested"};
+
+void watchdog_sup_init(void)
+{
+    bool valid = watchdog_hw->scratch[SCRATCH_MAGIC_IDX] == SCRATCH_MAGIC;
+    if (!watchdog_caused_reboot())
+    {
+        reason = REBOOT_POWER_ON;
+        reboot_count = 0;
+    }
+    else if (valid && watchdog_hw->scratch[SCRATCH_REASON_IDX] < REBOOT_REASON_COUNT)
+    {
+        // Estouro (motivo padrão gravado no boot anterior) ou reinício por watchdog_sup_reboot
+        reason = (reboot_reason_t)watchdog_hw->scratch[SCRATCH_REASON_IDX];
+        reboot_count = watchdog_hw->scratch[SCRATCH_COUNT_IDX] + 1;
+    }
+    else
+    {
+        reason = REBOOT_WATCHDOG;
+        reboot_count = 1;
+    }
+
+    // Valores padrão para o próximo reset: estouro do watchdog, se nada for gravado antes
+    watchdog_hw->scratch[SCRATCH_MAGIC_IDX] = SCRATCH_MAGIC;
+    watchdog_hw->scratch[SCRATCH_REASON_IDX] = REBOOT_WATCHDOG;
+    watchdog_hw->scratch[SCRATCH_COUNT_IDX] = reboot_count;
+}
+
+// Executa no contexto do lwIP: se a pilha travar, o contador para
+static void heartbeat_cb(void *arg)
+{
+    heartbeat++;
+    sys_timeout(WATCHDOG_SUP_HEARTBEAT_MS, heartbeat_cb, NULL);
+}
+
+void watchdog_sup_start(void)
+{
+    cyw43_arch_lwip_begin();
+    sys_timeout(WATCHDOG_SUP_HEARTBEAT_MS, heartbeat_cb, NULL);
+    cyw43_arch_lwip_end();
+
+    last_heartbeat = heartbeat;
+    last_change_ms = to_ms_since_boot(get_absolute_time());
+    watchdog_enable(WATCHDOG_SUP_TIMEOUT_MS, true); // Pausa durante a depuração
+    running = true;
+}
+
+void watchdog_sup_service(void)
+{
+    if (!running)
+    {
+        return;
+    }
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    uint32_t hb = heartbeat;
+    if (hb != last_heartbeat)
+    {
+        last_heartbeat = hb;
+        last_change_ms = now;
+    }
+    if (now - last_change_ms < WATCHDOG_SUP_NET_STALL_MS)
+    {
+        watchdog_update();
+    }
+}
+
+void watchdog_sup_stop(void)
+{
+    if (running)
+    {
+        watchdog_disable();
+        running = false;
+    }
+}
+
+void watchdog_sup_reboot(reboot_reason_t r)
+{
+    watchdog_hw->scratch[SCRATCH_REASON_IDX] = r;
+    watchdog_reboot(0, 0, 1);
+    while (true)
+    {
+        tight_loop_contents();
+    }
+}
+
+reboot_reason_t watchdog_sup_reason(void)
+{
+    return reason;
+}
+
+const char *watchdog_sup_reason_name(reboot_reason_t r)
+{
+    return r < REBOOT_REASON_COUNT ? reason_names[r] : "?";
+}
+
+uint32_t watchdog_sup_reboot_count(void)
+{
+    return reboot_count;
+}
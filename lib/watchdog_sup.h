@@ -0,0 +1,50 @@
+#ifndef WATCHDOG_SUP_H
+#define WATCHDOG_SUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Supervisão pelo watchdog de hardware. O laço principal alimenta o watchdog só enquanto
+// um batimento agendado dentro do lwIP continua avançando, então tanto um laço principal
+// travado quanto uma pilha de rede parada levam ao reset. O motivo de cada reinício
+// intencional fica nos registradores de rascunho do watchdog, que sobrevivem ao reset.
+
+#ifndef WATCHDOG_SUP_TIMEOUT_MS
+#define WATCHDOG_SUP_TIMEOUT_MS 8000 // Máximo do RP2040 é ~8,3 s
+#endif
+#ifndef WATCHDOG_SUP_NET_STALL_MS
+#define WATCHDOG_SUP_NET_STALL_MS 5000 // Tempo sem batimento do lwIP até parar de alimentar
+#endif
+#define WATCHDOG_SUP_HEARTBEAT_MS 500
+
+typedef enum
+{
+    REBOOT_POWER_ON = 0, // Energização, botão de reset ou gravação
+    REBOOT_WATCHDOG,     // Watchdog estourou (laço ou pilha de rede travados)
+    REBOOT_LINK_LOST,    // Reinício pedido após perda prolongada do Wi-Fi
+    REBOOT_REQUESTED,    // Reinício pedido por comando
+    REBOOT_REASON_COUNT
+} reboot_reason_t;
+
+// Lê o motivo do último reinício; deve ser chamado no início do main
+void watchdog_sup_init(void);
+
+// Liga o watchdog e o batimento do lwIP (depois da inicialização bloqueante)
+void watchdog_sup_start(void);
+
+// Alimenta o watchdog se o batimento do lwIP estiver vivo; chamado a cada volta do laço principal
+void watchdog_sup_service(void);
+
+// Desliga o watchdog (saída normal do programa)
+void watchdog_sup_stop(void);
+
+// Registra o motivo e reinicia pelo watchdog
+void watchdog_sup_reboot(reboot_reason_t reason);
+
+reboot_reason_t watchdog_sup_reason(void);
+const char *watchdog_sup_reason_name(reboot_reason_t reason);
+
+// Reinícios seguidos sem energização (conta também os do watchdog)
+uint32_t watchdog_sup_reboot_count(void);
+
+#endif
@@ -0,0 +1,50 @@
+#include <math.h>
+#include "wave_table.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+bool wave_table_sine(uint16_t *out, uint32_t n, uint16_t min, uint16_t max)
+{
+    if (n < 2 || min > max)
+    {
+        return false;
+    }
+    float mid = (min + max) / 2.0f;
+    float amp = (max - min) / 2.0f;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        out[i] = (uint16_t)(mid + amp * sinf(2.0f * (float)M_PI * i / n) + 0.5f);
+    }
+    return true;
+}
+
+bool wave_table_trapezoid(uint16_t *out, uint32_t n, uint16_t min, uint16_t max)
+{
+    if (n < 4 || min > max)
+    {
+        return false;
+    }
+    uint32_t q = n / 4;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (i < q)
+        {
+            out[i] = min + (max - min) * i / q;
+        }
+        else if (i < 2 * q)
+        {
+            out[i] = max;
+        }
+        else if (i < 3 * q)
+        {
+            out[i] = max - (max - min) * (i - 2 * q) / q;
+        }
+        else
+        {
+            out[i] = min;
+        }
+    }
+    return true;
+}
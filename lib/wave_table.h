@@ -0,0 +1,16 @@
+#ifndef WAVE_TABLE_H
+#define WAVE_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Geração das tabelas de forma de onda (amostras em milésimos do período), sem dependência
+// do SDK para a simulação no host (tools/wave_sim.c) usar exatamente as mesmas tabelas.
+
+// Um período de senoide entre min e max, começando no ponto médio
+bool wave_table_sine(uint16_t *out, uint32_t n, uint16_t min, uint16_t max);
+
+// Subida, patamar alto, descida e patamar baixo, cada um com n/4 amostras
+bool wave_table_trapezoid(uint16_t *out, uint32_t n, uint16_t min, uint16_t max);
+
+#endif
@@ -0,0 +1,193 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/dhcp.h"
+#include "lwip/dns.h"
+#include "wifi_conn.h"
+#include "flash_store.h"
+#include "boot_timeline.h"
+
+// WLC_GET_CHANNEL já codificado no formato do cyw43_ioctl (comando << 1)
+#ifndef CYW43_IOCTL_GET_CHANNEL
+#define CYW43_IOCTL_GET_CHANNEL (0x3a)
+#endif
+
+#define WIFI_CACHE_VERSION 1
+
+// Dados da última conexão bem-sucedida, gravados na flash
+typedef struct
+{
+    uint32_t version;
+    char ssid[33];
+    uint8_t bssid[6];
+    uint32_t channel;
+    uint32_t ip, netmask, gw, dns;
+} wifi_cache_t;
+
+static bool used_fast_path;
+
+// Espera o link atingir o estado desejado ou falhar
+static int wait_link(int wanted, absolute_time_t deadline)
+{
+    while (!time_reached(deadline))
+    {
+        int status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+        if (status == CYW43_LINK_NOIP || status == CYW43_LINK_UP)
+        {
+            boot_timeline_mark(BOOT_PHASE_WIFI_JOIN);
+        }
+        if (status >= wanted)
+        {
+            return 0;
+        }
+        if (status < 0)
+        {
+            return status; // Falha de autenticação ou rede não encontrada
+        }
+        cyw43_arch_poll();
+        cyw43_arch_wait_for_work_until(make_timeout_time_ms(1));
+    }
+    return PICO_ERROR_TIMEOUT;
+}
+
+// Aplica um endereço fixo na interface. Com stop_dhcp false o DHCP segue ativo e pode substituí-lo.
+static void apply_address(uint32_t ip, uint32_t netmask, uint32_t gw, uint32_t dns, bool stop_dhcp)
+{
+    struct netif *netif = &cyw43_state.netif[CYW43_ITF_STA];
+    ip4_addr_t a_ip, a_mask, a_gw;
+    ip_addr_t a_dns;
+
+    ip4_addr_set_u32(&a_ip, ip);
+    ip4_addr_set_u32(&a_mask, netmask);
+    ip4_addr_set_u32(&a_gw, gw);
+    ip_addr_set_ip4_u32(&a_dns, dns);
+
+    cyw43_arch_lwip_begin();
+    if (stop_dhcp)
+    {
+        dhcp_release_and_stop(netif);
+    }
+    netif_set_addr(netif, &a_ip, &a_mask, &a_gw);
+    if (dns)
+    {
+        dns_setserver(0, &a_dns);
+    }
+    cyw43_arch_lwip_end();
+}
+
+// Após a associação: IP estático configurado ou, opcionalmente, o último lease do DHCP
+static void apply_known_address(const wifi_cache_t *cache)
+{
+#ifdef WIFI_STATIC_IP
+    ip4_addr_t ip, mask, gw, dns;
+    ip4addr_aton(WIFI_STATIC_IP, &ip);
+    ip4addr_aton(WIFI_STATIC_NETMASK, &mask);
+    ip4addr_aton(WIFI_STATIC_GW, &gw);
+    ip4addr_aton(WIFI_STATIC_DNS, &dns);
+    apply_address(ip4_addr_get_u32(&ip), ip4_addr_get_u32(&mask), ip4_addr_get_u32(&gw), ip4_addr_get_u32(&dns), true);
+#else
+    if (WIFI_FAST_REUSE_LEASE && cache && cache->ip)
+    {
+        apply_address(cache->ip, cache->netmask, cache->gw, cache->dns, false);
+    }
+#endif
+}
+
+// Lê BSSID, canal e endereço da conexão atual
+static void read_current(wifi_cache_t *cache, const char *ssid)
+{
+    struct netif *netif = &cyw43_state.netif[CYW43_ITF_STA];
+    uint32_t chan_info[3] = {0};
+
+    memset(cache, 0, sizeof(*cache));
+    cache->version = WIFI_CACHE_VERSION;
+    strncpy(cache->ssid, ssid, sizeof(cache->ssid) - 1);
+
+    cyw43_arch_lwip_begin();
+    cyw43_wifi_get_bssid(&cyw43_state, cache->bssid);
+    cyw43_ioctl(&cyw43_state, CYW43_IOCTL_GET_CHANNEL, sizeof(chan_info), (uint8_t *)chan_info, CYW43_ITF_STA);
+    cache->ip = ip4_addr_get_u32(netif_ip4_addr(netif));
+    cache->netmask = ip4_addr_get_u32(netif_ip4_netmask(netif));
+    cache->gw = ip4_addr_get_u32(netif_ip4_gw(netif));
+    const ip_addr_t *dns = dns_getserver(0);
+    cache->dns = dns ? ip4_addr_get_u32(dns) : 0;
+    cyw43_arch_lwip_end();
+
+    cache->channel = chan_info[0] & 0xFF; // hw_channel
+}
+
+int wifi_conn_connect(const char *ssid, const char *password, uint32_t timeout_ms)
+{
+    absolute_time_t deadline = make_timeout_time_ms(timeout_ms);
+    wifi_cache_t cache;
+    bool have_cache = flash_store_load(FLASH_STORE_SLOT_WIFI, &cache, sizeof(cache)) &&
+                      cache.version == WIFI_CACHE_VERSION && strcmp(cache.ssid, ssid) == 0;
+    int err = -1;
+
+    used_fast_path = false;
+
+    // Caminho rápido: associação direta ao BSSID/canal conhecido, sem varredura
+    if (have_cache)
+    {
+        cyw43_arch_lwip_begin();
+        err = cyw43_wifi_join(&cyw43_state, strlen(ssid), (const uint8_t *)ssid, strlen(password), (const uint8_t *)password,
+                              CYW43_AUTH_WPA2_AES_PSK, cache.bssid, cache.channel);
+        cyw43_arch_lwip_end();
+        if (err == 0)
+        {
+            err = wait_link(CYW43_LINK_NOIP, make_timeout_time_ms(WIFI_FAST_JOIN_TIMEOUT_MS));
+        }
+        if (err == 0)
+        {
+            used_fast_path = true;
+        }
+        else
+        {
+            printf("Conexão rápida falhou (%d), fazendo varredura completa\n", err);
+            cyw43_arch_lwip_begin();
+            cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+            cyw43_arch_lwip_end();
+        }
+    }
+
+    // Caminho normal: varredura e associação
+    if (!used_fast_path)
+    {
+        if (cyw43_arch_wifi_connect_async(ssid, password, CYW43_AUTH_WPA2_AES_PSK))
+        {
+            return -1;
+        }
+        err = wait_link(CYW43_LINK_NOIP, deadline);
+        if (err)
+        {
+            return err;
+        }
+    }
+
+    apply_known_address(have_cache ? &cache : NULL);
+    err = wait_link(CYW43_LINK_UP, deadline);
+    if (err)
+    {
+        return err;
+    }
+    boot_timeline_mark(BOOT_PHASE_DHCP);
+
+    // Atualiza o cache apenas se algo mudou, poupando ciclos de escrita da flash
+    wifi_cache_t now;
+    read_current(&now, ssid);
+    if (!have_cache || memcmp(&now, &cache, sizeof(now)) != 0)
+    {
+        flash_store_save(FLASH_STORE_SLOT_WIFI, &now, sizeof(now));
+    }
+    return 0;
+}
+
+bool wifi_conn_used_fast_path(void)
+{
+    return used_fast_path;
+}
+
+void wifi_conn_forget(void)
+{
+    flash_store_erase(FLASH_STORE_SLOT_WIFI);
+}
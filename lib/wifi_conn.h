@@ -0,0 +1,43 @@
+#ifndef WIFI_CONN_H
+#define WIFI_CONN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Tempo máximo da tentativa de conexão direta (BSSID/canal em cache) antes da varredura completa
+#ifndef WIFI_FAST_JOIN_TIMEOUT_MS
+#define WIFI_FAST_JOIN_TIMEOUT_MS 1500
+#endif
+
+// Definir como 1 para aplicar o último endereço do DHCP logo após a associação.
+// O DHCP continua rodando e substitui o endereço se o servidor oferecer outro.
+#ifndef WIFI_FAST_REUSE_LEASE
+#define WIFI_FAST_REUSE_LEASE 1
+#endif
+
+// IP estático opcional. Ex: -DWIFI_STATIC_IP=\"192.168.1.50\" -DWIFI_STATIC_GW=\"192.168.1.1\"
+// Quando definido, o DHCP é desligado.
+#ifdef WIFI_STATIC_IP
+#ifndef WIFI_STATIC_NETMASK
+#define WIFI_STATIC_NETMASK "255.255.255.0"
+#endif
+#ifndef WIFI_STATIC_GW
+#error "WIFI_STATIC_GW deve ser definido junto com WIFI_STATIC_IP"
+#endif
+#ifndef WIFI_STATIC_DNS
+#define WIFI_STATIC_DNS WIFI_STATIC_GW
+#endif
+#endif
+
+// Conecta ao Wi-Fi. Tenta primeiro a conexão direta com o BSSID e o canal da
+// última conexão bem-sucedida (salvos na flash) e, se falhar, faz a varredura completa.
+// Retorna 0 quando o link está pronto com IP, ou um código de erro negativo.
+int wifi_conn_connect(const char *ssid, const char *password, uint32_t timeout_ms);
+
+// Indica se a última conexão usou o caminho rápido
+bool wifi_conn_used_fast_path(void);
+
+// Apaga o cache da última conexão
+void wifi_conn_forget(void);
+
+#endif
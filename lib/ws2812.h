@@ -1,5 +1,6 @@
 #include "ws2818b.pio.h"
 #include "hardware/pio.h"
+#include "led_matrix.h"
 
 #ifndef WS2812_H
 #define WS2812_H
@@ -9,13 +10,9 @@
 #define MATRIX_ROWS 5
 #define MATRIX_COLS 5
 #define MATRIX_DEPTH 3
+#define WS2812_BIT_FREQ_HZ 800000.f
 
-// Definição de pixel GRB
-struct pixel_t
-{
-    uint8_t G, R, B; // Três valores de 8-bits compõem um pixel.
-};
-typedef struct pixel_t pixel_t;
+// Pixel GRB definido em led_matrix.h
 typedef pixel_t npLED_t; // Mudança de nome de "struct pixel_t" para "npLED_t" por clareza.
 
 // Declaração do buffer de pixels que formam a matriz.
@@ -44,7 +41,7 @@ void npInit()
     }
 
     // Inicia programa na máquina PIO obtida.
-    ws2818b_program_init(np_pio, sm, offset, LED_PIN, 800000.f);
+    ws2818b_program_init(np_pio, sm, offset, LED_PIN, WS2812_BIT_FREQ_HZ);
 
     // Limpa buffer de pixels.
     for (uint i = 0; i < LED_COUNT; ++i)
@@ -53,6 +50,15 @@ void npInit()
         leds[i].G = 0;
         leds[i].B = 0;
     }
+    led_matrix_set_brightness(LED_MATRIX_DEFAULT_BRIGHTNESS, 1000);
+}
+
+/**
+ * Recalcula o divisor da máquina PIO após uma troca do clk_sys (10 ciclos por bit).
+ */
+void npRetime()
+{
+    pio_sm_set_clkdiv(np_pio, sm, clock_get_hz(clk_sys) / (10.f * WS2812_BIT_FREQ_HZ));
 }
 
 /**
@@ -75,81 +81,46 @@ void npClear()
 }
 
 /**
- * Escreve os dados do buffer nos LEDs.
+ * Escreve os dados do buffer nos LEDs. Depois de matrix_anim_start a máquina PIO pertence
+ * ao motor de animações e esta escrita direta não deve mais ser usada.
  */
 void npWrite()
 {
-    // Escreve cada dado de 8-bits dos pixels em sequência no buffer da máquina PIO.
+    // Escreve cada dado de 8-bits dos pixels em sequência no buffer da máquina PIO,
+    // alinhado ao bit 31 porque a saída é deslocada para a esquerda (MSB primeiro).
     for (uint i = 0; i < LED_COUNT; ++i)
     {
-        pio_sm_put_blocking(np_pio, sm, leds[i].G);
-        pio_sm_put_blocking(np_pio, sm, leds[i].R);
-        pio_sm_put_blocking(np_pio, sm, leds[i].B);
+        pio_sm_put_blocking(np_pio, sm, (uint32_t)leds[i].G << 24);
+        pio_sm_put_blocking(np_pio, sm, (uint32_t)leds[i].R << 24);
+        pio_sm_put_blocking(np_pio, sm, (uint32_t)leds[i].B << 24);
     }
     sleep_us(100); // Espera 100us, sinal de RESET do datasheet.
 }
 
 // Modificado do github: https://github.com/BitDogLab/BitDogLab-C/tree/main/neopixel_pio
-// Função para converter a posição do matriz para uma posição do vetor.
+// Função para converter a posição do matriz para uma posição do vetor (x = coluna, y = linha).
 int getIndex(int x, int y)
 {
-    // Se a linha for par (0, 2, 4), percorremos da esquerda para a direita.
-    // Se a linha for ímpar (1, 3), percorremos da direita para a esquerda.
-    if (y % 2 == 0)
-    {
-        return 24 - (y * 5 + x); // Linha par (esquerda para direita).
-    }
-    else
-    {
-        return 24 - (y * 5 + (4 - x)); // Linha ímpar (direita para esquerda).
-    }
+    return led_matrix_index[y * MATRIX_COLS + x];
 }
 
+/**
+ * Desenha um quadro [linha][coluna][r, g, b] (0-255) com o brilho da tabela e envia.
+ */
 void desenhaMatriz(int matriz[5][5][3])
 {
-    float intensidade = 0.01;
-    for (int linha = 0; linha < 5; linha++)
-    {
-        for (int coluna = 0; coluna < 5; coluna++)
-        {
-            int posicao = getIndex(linha, coluna);
-            npSetLED(posicao, ((float)matriz[coluna][linha][0] * intensidade), ((float)matriz[coluna][linha][1] * intensidade), ((float)matriz[coluna][linha][2] * intensidade));
-        }
-    }
+    led_matrix_draw_rgb(leds, (const int (*)[5][3])matriz);
     npWrite();
     npClear();
 }
 
-// Função para converter valores ARGB (0xAARRGGBB) para RGB (Em desenvolvimento)
-void convertToRGB(int argb, int *rgb)
-{
-    rgb[0] = argb & 0xFF;         // Blue
-    rgb[1] = (argb >> 16) & 0xFF; // Red
-    rgb[2] = (argb >> 8) & 0xFF;  // Green
-}
-
+/**
+ * Desenha um quadro ARGB (0xAARRGGBB) em ordem de linha, sem cópia intermediária, e envia.
+ */
 void convert(uint32_t matrix[25])
 {
-
-    // Matriz 5x5x3 para armazenar os valores RGB
-    int rgb_matrix[MATRIX_ROWS][MATRIX_COLS][MATRIX_DEPTH];
-    int rgb[3];
-
-    // Preencher a matriz RGB com a conversão dos valores ARGB
-    for (int i = 0; i < MATRIX_ROWS * MATRIX_COLS; i++)
-    {
-
-        convertToRGB(matrix[i], rgb);
-
-        int row = i / MATRIX_COLS; // Cálculo da linha
-        int col = i % MATRIX_COLS; // Cálculo da coluna
-
-        // Armazenar os valores RGB na matriz 5x5x3
-        rgb_matrix[row][col][0] = rgb[0]; // Red
-        rgb_matrix[row][col][1] = rgb[1]; // Green
-        rgb_matrix[row][col][2] = rgb[2]; // Blue
-    }
-    desenhaMatriz(rgb_matrix);
+    led_matrix_draw_argb(leds, matrix);
+    npWrite();
 }
 
 #endif
\ No newline at end of file
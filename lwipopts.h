@@ -1,18 +1,68 @@
 #ifndef _LWIPOPTS_H
 #define _LWIPOPTS_H
 
-// Need more memory for TLS
+// Perfis de memória do lwIP, escolhidos com -DLWIP_PROFILE=n (ver "Memória do lwIP" no README).
+// O heap (MEM_SIZE) guarda os segmentos TCP enviados até o ACK; o PBUF_POOL guarda cada quadro
+// recebido até ser consumido, então a janela de recepção precisa caber nele.
+// Só o perfil padrão foi usado na placa. Os demais são experimentais: dimensionados pelas contas
+// do README, ainda sem validação com /net/mem sob a carga de tools/mqtt_load.c.
+#define LWIP_PROFILE_DEFAULT    0 // Valores dos exemplos do pico-sdk
+#define LWIP_PROFILE_LOW_RAM    1 // Experimental: só comandos e telemetria leve, sem captura do ADC
+#define LWIP_PROFILE_THROUGHPUT 2 // Experimental: captura contínua do ADC e rajadas de telemetria
+#define LWIP_PROFILE_TLS        3 // Experimental: MQTT com TLS (padrão quando MQTT_CERT_INC é definido)
+
+#ifndef LWIP_PROFILE
 #ifdef MQTT_CERT_INC
-#define MEM_SIZE 8000
+#define LWIP_PROFILE LWIP_PROFILE_TLS
+#else
+#define LWIP_PROFILE LWIP_PROFILE_DEFAULT
+#endif
+#endif
+
+#if LWIP_PROFILE == LWIP_PROFILE_LOW_RAM
+// Janela de 2 segmentos: 8 quadros no pool cobrem a janela, ARP, DHCP e DNS (16 a menos, ~25 KB)
+#define MEM_SIZE                    3000
+#define PBUF_POOL_SIZE              8
+#define TCP_WND                     (2 * TCP_MSS)
+#define TCP_SND_BUF                 (3 * TCP_MSS)
+#define MEMP_NUM_TCP_SEG            16
+#elif LWIP_PROFILE == LWIP_PROFILE_THROUGHPUT
+// O envio é limitado pelo heap, não pelo TCP_SND_BUF: 8 segmentos cheios precisam de ~12 KB.
+// A recepção é só de comandos curtos, então o pool encolhe.
+#define MEM_SIZE                    12000
+#define PBUF_POOL_SIZE              12
+#define TCP_WND                     (4 * TCP_MSS)
+#define TCP_SND_BUF                 (8 * TCP_MSS)
+#define MEMP_NUM_TCP_SEG            40
+#define MQTT_OUTPUT_RINGBUF_SIZE    4096
+#elif LWIP_PROFILE == LWIP_PROFILE_TLS
+// O registro TLS de recepção tem até 16 KB; o pool padrão (24 quadros) já cobre essa janela
+#define MEM_SIZE                    8000
 #endif
 
+// Contadores de uso e pico do heap e dos pools, lidos por lib/net_mem.c (só incrementos
+// nas alocações; a impressão das estatísticas continua só na compilação de depuração)
+#define MEM_STATS                   1
+#define MEMP_STATS                  1
+
 // Generally you would define your own explicit list of lwIP options
 // (see https://www.nongnu.org/lwip/2_1_x/group__lwip__opts.html)
 //
 // This example uses a common include to avoid repetition
 #include "lwipopts_examples_common.h"
 
-#define MEMP_NUM_SYS_TIMEOUT        (LWIP_NUM_SYS_TIMEOUT_INTERNAL+1)
+// MQTT + SNTP + batimento do watchdog
+#define MEMP_NUM_SYS_TIMEOUT        (LWIP_NUM_SYS_TIMEOUT_INTERNAL+3)
+
+// SNTP disciplina o relógio de lib/clock_sync.c em vez de um RTC
+#include "lib/clock_sync.h"
+#define SNTP_SERVER_DNS             1
+#define SNTP_STARTUP_DELAY          0
+#define SNTP_UPDATE_DELAY           CLOCK_SYNC_SNTP_INTERVAL_MS
+#define SNTP_CHECK_RESPONSE         2
+#define SNTP_COMP_ROUNDTRIP         1
+#define SNTP_SET_SYSTEM_TIME_US(sec, us) clock_sync_sntp_set(sec, us)
+#define SNTP_GET_SYSTEM_TIME(sec, us)    clock_sync_sntp_get(&(sec), &(us))
 
 #ifdef MQTT_CERT_INC
 #define LWIP_ALTCP               1
@@ -21,13 +71,22 @@
 #ifndef NDEBUG
 #define ALTCP_MBEDTLS_DEBUG  LWIP_DBG_ON
 #endif
+#endif // MQTT_CERT_INC
+
+#if LWIP_PROFILE == LWIP_PROFILE_TLS
 /* TCP WND must be at least 16 kb to match TLS record size
    or you will get a warning "altcp_tls: TCP_WND is smaller than the RX decrypion buffer, connection RX might stall!" */
 #undef TCP_WND
 #define TCP_WND  16384
-#endif // MQTT_CERT_INC
+#endif
+
+// This defaults to 4. Na conexão ficam em andamento /all, os grupos, um tópico do dispositivo por
+// vez e as publicações QoS 1 (ver MQTT_CONNECT_REQUESTS em pwmControlIOT.c).
+#define MQTT_REQ_MAX_IN_FLIGHT 32
 
-// This defaults to 4
-#define MQTT_REQ_MAX_IN_FLIGHT 10
+// This defaults to 256; precisa comportar os SUBSCRIBEs da conexão e as publicações enfileiradas juntas
+#ifndef MQTT_OUTPUT_RINGBUF_SIZE
+#define MQTT_OUTPUT_RINGBUF_SIZE 1024
+#endif
 
 #endif
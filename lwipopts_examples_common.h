@@ -23,24 +23,36 @@
 #ifndef MEM_SIZE
 #define MEM_SIZE                    4000
 #endif
+#ifndef MEMP_NUM_TCP_SEG
 #define MEMP_NUM_TCP_SEG            32
+#endif
 #define MEMP_NUM_ARP_QUEUE          10
+#ifndef PBUF_POOL_SIZE
 #define PBUF_POOL_SIZE              24
+#endif
 #define LWIP_ARP                    1
 #define LWIP_ETHERNET               1
 #define LWIP_ICMP                   1
 #define LWIP_RAW                    1
+#ifndef TCP_WND
 #define TCP_WND                     (8 * TCP_MSS)
+#endif
 #define TCP_MSS                     1460
+#ifndef TCP_SND_BUF
 #define TCP_SND_BUF                 (8 * TCP_MSS)
+#endif
 #define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
 #define LWIP_NETIF_STATUS_CALLBACK  1
 #define LWIP_NETIF_LINK_CALLBACK    1
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETCONN                0
+#ifndef MEM_STATS
 #define MEM_STATS                   0
+#endif
 #define SYS_STATS                   0
+#ifndef MEMP_STATS
 #define MEMP_STATS                  0
+#endif
 #define LINK_STATS                  0
 // #define ETH_PAD_SIZE                2
 #define LWIP_CHKSUM_ALGORITHM       3
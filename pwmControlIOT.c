@@ -13,14 +13,43 @@
 #include "hardware/irq.h"  // Biblioteca de hardware de interrupções
 #include "hardware/adc.h"  // Biblioteca de hardware para conversão ADC
 #include "hardware/pwm.h"  // Adiciona PWM para simular o controle de motor
+#include "hardware/clocks.h" // Frequência atual do clk_sys
 
 #include "lwip/apps/mqtt.h"      // Biblioteca LWIP MQTT -  fornece funções e recursos para conexão MQTT
 #include "lwip/apps/mqtt_priv.h" // Biblioteca que fornece funções e recursos para Geração de Conexões
 #include "lwip/dns.h"            // Biblioteca que fornece funções e recursos suporte DNS:
 #include "lwip/altcp_tls.h"      // Biblioteca que fornece funções e recursos para conexões seguras usando TLS:
+#include "lwip/memp.h"           // Enum dos pools do lwIP, para o tamanho da tabela do comando mem
 
 #include "lib/ws2812.h"
+#include "lib/matrix_anim.h"
 #include "lib/ssd1306.h"
+#include "lib/ui_view.h"
+#include "lib/oled_chart.h"
+#include "lib/boot_timeline.h"
+#include "lib/wifi_conn.h"
+#include "lib/clock_sync.h"
+#include "lib/cmd_sched.h"
+#include "lib/pwm_wave.h"
+#include "lib/pwm_dither.h"
+#include "lib/sigma_delta.h"
+#include "lib/transfer_curve.h"
+#include "lib/servo.h"
+#include "lib/pid_loop.h"
+#include "lib/pwm_meas.h"
+#include "lib/adc_stream.h"
+#include "lib/thermal_loop.h"
+#include "lib/failsafe.h"
+#include "lib/hbridge.h"
+#include "lib/clock_profile.h"
+#include "lib/watchdog_sup.h"
+#include "lib/scene.h"
+#include "lib/mqtt_group.h"
+#include "lib/net_mem.h"
+#include "lib/link_mon.h"
+#include "lib/flash_store.h"
+#include "lib/lat_hist.h"
+#include "lib/usb_shell.h"
 #include "lib/func.c"
 
 // This file includes your client certificate for client server authentication
@@ -32,17 +61,27 @@
 #define MQTT_TOPIC_LEN 200
 #endif
 
+// Tamanho máximo de uma mensagem recebida (tabelas de forma de onda chegam em várias partes)
+#ifndef MQTT_DATA_LEN
+#define MQTT_DATA_LEN 1024
+#endif
+
 // Dados do cliente MQTT
 typedef struct
 {
     mqtt_client_t *mqtt_client_inst;
     struct mqtt_connect_client_info_t mqtt_client_info;
-    char data[MQTT_OUTPUT_RINGBUF_SIZE];
+    char data[MQTT_DATA_LEN];
     char topic[MQTT_TOPIC_LEN];
     uint32_t len;
     ip_addr_t mqtt_server_address;
     bool connect_done;
     int subscribe_count;
+    int subscribe_total;
+    int sub_next;        // Próximo tópico do dispositivo a (des)assinar, um por vez
+    bool sub_pacing_sub; // Sentido da sequência em andamento
+    bool resubscribe;    // Uma assinatura expirou: o laço principal refaz a conexão
+    uint32_t reconnects; // Conexões ao broker depois da primeira
     bool stop_client;
 } MQTT_CLIENT_DATA_T;
 
@@ -62,8 +101,10 @@ typedef struct
 #define ERROR_printf printf
 #endif
 
-// Manter o programa ativo - keep alive in seconds
+// Manter o programa ativo - keep alive in seconds (valor inicial; /link keepalive,s troca na próxima conexão)
+#ifndef MQTT_KEEP_ALIVE_S
 #define MQTT_KEEP_ALIVE_S 60
+#endif
 
 // QoS - mqtt_subscribe
 // At most once (QoS 0)
@@ -73,6 +114,55 @@ typedef struct
 #define MQTT_PUBLISH_QOS 1
 #define MQTT_PUBLISH_RETAIN 0
 
+// Tópico onde é publicada a linha do tempo da inicialização
+#define MQTT_BOOT_TOPIC "/boot"
+
+// Tópico onde cada dispositivo responde ao /skew
+#define MQTT_SKEW_TOPIC "/skew/report"
+
+// Tópico com a temporização e o estado dos laços PID
+#define MQTT_PID_STATS_TOPIC "/pid/stats"
+
+// Tópico com o resultado das medições de frequência e duty
+#define MQTT_MEAS_TOPIC "/meas/result"
+
+// Blocos da captura contínua do ADC e contadores da captura
+#define MQTT_ADC_DATA_TOPIC "/adc/data"
+#define MQTT_ADC_STATS_TOPIC "/adc/stats"
+
+// Temperatura filtrada e fator de redução de cada canal, publicados quando um fator muda
+#define MQTT_THERMAL_TOPIC "/thermal/derate"
+
+// Motivo do último reinício, publicado a cada conexão ao broker
+#define MQTT_REBOOT_TOPIC "/reboot"
+
+// Intervalo entre tentativas de reconexão ao broker e tempo sem Wi-Fi até reiniciar
+// (a inicialização refaz a associação pelo caminho rápido do BSSID em cache). Sem credenciais
+// na flash o reinício pararia no pedido pela USB, então a associação é refeita sem reiniciar.
+#define MQTT_RECONNECT_PERIOD_MS 5000
+#define WIFI_LINK_LOSS_REBOOT_MS 30000
+
+// Estado do enlace, publicado com QoS 1 a cada sonda: o tempo até o PUBACK é o RTT medido
+#define MQTT_LINK_TOPIC "/link/status"
+#ifndef LINK_PROBE_MS
+#define LINK_PROBE_MS 5000
+#endif
+#define LINK_PROBE_MIN_MS 1000
+#define LINK_PROBE_MAX_MS 60000
+#define LINK_PROBE_TIMEOUT_MS 3000
+
+// Uso de memória do lwIP (heap e pools, atual, pico e falhas), publicado periodicamente e
+// também quando mais um pool fica sem folga
+#define MQTT_NET_MEM_TOPIC "/net/mem"
+#ifndef NET_MEM_PUBLISH_MS
+#define NET_MEM_PUBLISH_MS 10000
+#endif
+
+// Eco de cada comando tratado, ligado por /trace on: "<tópico> <mensagem> <us de tratamento>".
+// Usado por tools/mqtt_load.c para medir a latência de ponta a ponta.
+#define MQTT_APPLIED_TOPIC "/applied"
+#define MQTT_APPLIED_LEN 96
+
 // Tópico usado para: last will and testament
 #define MQTT_WILL_TOPIC "/online"
 #define MQTT_WILL_MSG "0"
@@ -87,23 +177,20 @@ typedef struct
 #define MQTT_UNIQUE_TOPIC 0
 #endif
 
-#define PICO_CLOCK_FREQ_HZ 125000000
+// Tamanho dos tópicos publicados, já com o prefixo do dispositivo
+#define MQTT_PUB_TOPIC_LEN 48
+
 #define CREDENTIAL_BUFFER_SIZE 64 // Tamanho do buffer para armazenar as credenciais
+#define WIFI_CONNECT_TIMEOUT_MS 30000
+#define MAIN_LOOP_PERIOD_MS 50 // Período do laço principal (atualização da interface)
 
 // Add these constants at the top
-#define LED_MATRIX_SIZE 5
-#define LED_GREEN_START 24
-#define LED_RED_START 4
-#define LED_BLUE_START 14
-#define DUTY_CYCLE_DIVISOR 20
 #define RGB_LED_COUNT 3
 #define PWM_ARRAY_OFFSET 11
 
 // Requisição para publicar
 static void pub_request_cb(__unused void *arg, err_t err);
 
-// Topico MQTT
-static const char *full_topic(MQTT_CLIENT_DATA_T *state, const char *name);
 
 // Requisição de Assinatura - subscribe
 static void sub_request_cb(void *arg, err_t err);
@@ -113,6 +200,7 @@ static void unsub_request_cb(void *arg, err_t err);
 
 // Tópicos de assinatura
 static void sub_unsub_topics(MQTT_CLIENT_DATA_T *state, bool sub);
+static void sub_unsub_next(MQTT_CLIENT_DATA_T *state);
 
 // Dados de entrada MQTT
 static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags);
@@ -126,12 +214,91 @@ static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection
 // Inicializar o cliente MQTT
 static void start_client(MQTT_CLIENT_DATA_T *state);
 
+// Conecta (ou reconecta) a instância existente ao broker
+static err_t connect_client(MQTT_CLIENT_DATA_T *state);
+
 // Call back com o resultado do DNS
 static void dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg);
 
+// Terminal de comandos na USB
+static void shell_start(MQTT_CLIENT_DATA_T *state);
+
+// Tópicos ===============================
+// Prefixo dos tópicos do dispositivo ("/pico1a2b" com MQTT_UNIQUE_TOPIC, senão vazio)
+static char device_prefix[sizeof(MQTT_DEVICE_NAME) + 8];
+static size_t device_prefix_len;
+
+// Tópicos publicados, montados uma vez com o prefixo em build_topics()
+typedef enum
+{
+    PUB_ONLINE = 0,
+    PUB_BOOT,
+    PUB_REBOOT,
+    PUB_SKEW,
+    PUB_PID_STATS,
+    PUB_MEAS,
+    PUB_ADC_DATA,
+    PUB_ADC_STATS,
+    PUB_THERMAL,
+    PUB_APPLIED,
+    PUB_NET_MEM,
+    PUB_LINK,
+    PUB_TOPIC_COUNT,
+} pub_topic_t;
+
+static const char *const pub_topic_names[PUB_TOPIC_COUNT] = {
+    [PUB_ONLINE] = MQTT_WILL_TOPIC,
+    [PUB_BOOT] = MQTT_BOOT_TOPIC,
+    [PUB_REBOOT] = MQTT_REBOOT_TOPIC,
+    [PUB_SKEW] = MQTT_SKEW_TOPIC,
+    [PUB_PID_STATS] = MQTT_PID_STATS_TOPIC,
+    [PUB_MEAS] = MQTT_MEAS_TOPIC,
+    [PUB_ADC_DATA] = MQTT_ADC_DATA_TOPIC,
+    [PUB_ADC_STATS] = MQTT_ADC_STATS_TOPIC,
+    [PUB_THERMAL] = MQTT_THERMAL_TOPIC,
+    [PUB_APPLIED] = MQTT_APPLIED_TOPIC,
+    [PUB_NET_MEM] = MQTT_NET_MEM_TOPIC,
+    [PUB_LINK] = MQTT_LINK_TOPIC,
+};
+static char pub_topics[PUB_TOPIC_COUNT][MQTT_PUB_TOPIC_LEN];
+
+static void build_topics(const char *client_id)
+{
+#if MQTT_UNIQUE_TOPIC
+    device_prefix_len = snprintf(device_prefix, sizeof(device_prefix), "/%s", client_id);
+#endif
+    for (int i = 0; i < PUB_TOPIC_COUNT; i++)
+    {
+        snprintf(pub_topics[i], sizeof(pub_topics[i]), "%s%s", device_prefix, pub_topic_names[i]);
+    }
+}
+
+// Tópico de comando sem o prefixo de endereçamento (dispositivo, grupo ou todos), ou NULL se
+// não for para esta placa. shared indica que veio por um grupo ou pelo endereço de todas.
+static const char *route_topic(const char *topic, bool *shared)
+{
+    *shared = true;
+    if (strncmp(topic, MQTT_BROADCAST_PREFIX "/", sizeof(MQTT_BROADCAST_PREFIX)) == 0)
+    {
+        return topic + sizeof(MQTT_BROADCAST_PREFIX) - 1;
+    }
+    if (strncmp(topic, MQTT_GROUP_PREFIX "/", sizeof(MQTT_GROUP_PREFIX)) == 0)
+    {
+        // A assinatura pode ainda estar ativa logo após sair do grupo: a lista local decide
+        const char *name = topic + sizeof(MQTT_GROUP_PREFIX);
+        const char *rest = strchr(name, '/');
+        return rest && mqtt_group_member(name, rest - name) ? rest : NULL;
+    }
+    *shared = false;
+    return strncmp(topic, device_prefix, device_prefix_len) == 0 ? topic + device_prefix_len : NULL;
+}
+
 const uint led_rgb[RGB_LED_COUNT] = {11, 12, 13};
+static const char pwm_suffix[RGB_LED_COUNT] = {'g', 'b', 'r'}; // Sufixo dos tópicos de cada canal
+static const char *const led_names[RGB_LED_COUNT] = {"Verde", "Azul", "Vermelho"};
 static uint16_t pwm_wraps[RGB_LED_COUNT] = {0};
 static uint32_t fpwm[RGB_LED_COUNT] = {0};
+static transfer_curve_t curves[RGB_LED_COUNT]; // Curva de brilho de cada canal, com a tabela para o TOP atual
 // Funções para o controle do PWM ===============================
 void setup_pwm(uint gpio, uint8_t div)
 {
@@ -144,406 +311,2372 @@ void setup_pwm(uint gpio, uint8_t div)
     pwm_set_gpio_level(gpio, 0); // Inicializa o PWM no nível baixo
 }
 
-static void set_pwm_duty(uint gpio, uint duty_cycle_percent)
+// Índice do outro canal do mesmo slice (azul e vermelho), ou -1
+static int slice_sibling(uint ch)
 {
-    uint16_t level = (pwm_wraps[gpio - PWM_ARRAY_OFFSET] * duty_cycle_percent) / 100;
-    pwm_set_gpio_level(gpio, level);
+    int sib = (int)(led_rgb[ch] ^ 1) - PWM_ARRAY_OFFSET;
+    return sib >= 0 && sib < RGB_LED_COUNT ? sib : -1;
 }
-// Fim das funções para o controle do PWM ===============================
 
-// Função para desenhar na matriz de LEDs ===============================
-void draw_matrix_green(uint8_t duty)
+// O canal está em um modo com escala própria do TOP, que não acompanha uma troca de divisor e TOP
+// feita pelo outro canal do slice
+static bool channel_in_mode(uint ch)
 {
-    for (int i = 0; i < LED_MATRIX_SIZE; i++)
-    {
-        int j = LED_GREEN_START - i; // Perccorre do led 24 ao led 20
-        if (duty - i > 0)
-        {
-            npSetLED(j, 0, 1, 0);
-        }
-        else
-        {
-            npSetLED(j, 0, 0, 0);
-        }
-    }
-    npWrite();
+    return servo_get(ch)->enabled || hbridge_get(ch)->enabled || pwm_wave_active(ch) || pwm_dither_active(ch) ||
+           pid_loop_enabled(ch);
 }
 
-void draw_matrix_red(uint8_t duty)
+static uint16_t duty_to_level(uint ch, uint duty_cycle_percent)
 {
-    for (int i = 0; i < LED_MATRIX_SIZE; i++)
+    // A tabela só vale para o TOP em que foi gerada; fora disso o duty é linear
+    const transfer_curve_t *curve = &curves[ch];
+    if (curve->kind != TRANSFER_LINEAR && curve->top != 0 && curve->top == pwm_wraps[ch])
     {
-        int j = LED_RED_START - i; // Perccorre do led 4 ao led 0
-        if (duty - i > 0)
-        {
-            npSetLED(j, 1, 0, 0);
-        }
-        else
-        {
-            npSetLED(j, 0, 0, 0);
-        }
+        return transfer_curve_level(curve, duty_cycle_percent * 10);
     }
-    npWrite();
+    return (pwm_wraps[ch] * duty_cycle_percent) / 100;
 }
 
-void draw_matrix_blue(uint8_t duty)
+static void set_pwm_duty(uint gpio, uint duty_cycle_percent)
 {
-    for (int i = 0; i < LED_MATRIX_SIZE; i++)
-    {
-        int j = LED_BLUE_START - i; // Perccorre do led 14 ao led 10
-        if (duty - i > 0)
-        {
-            npSetLED(j, 0, 0, 1);
-        }
-        else
-        {
-            npSetLED(j, 0, 0, 0);
-        }
-    }
-    npWrite();
+    uint ch = gpio - PWM_ARRAY_OFFSET;
+    thermal_loop_set_level(ch, gpio, duty_to_level(ch, duty_cycle_percent)); // Escreve já limitado pela temperatura
 }
+// Fim das funções para o controle do PWM ===============================
 
 // Variável para o controle do display ===============================
 ssd1306_t ssd;
 
-// Credenciais  da rede Wi-Fi e MQTT ===============================
-char WIFI_SSID[CREDENTIAL_BUFFER_SIZE];     // Substitua pelo nome da sua rede Wi-Fi
-char WIFI_PASSWORD[CREDENTIAL_BUFFER_SIZE]; // Substitua pela senha da sua rede Wi-Fi
-char MQTT_SERVER[CREDENTIAL_BUFFER_SIZE];   // Substitua pelo endereço do host - broket MQTT: Ex: 192.168.1.107
-char MQTT_USERNAME[CREDENTIAL_BUFFER_SIZE]; // Substitua pelo nome da host MQTT - admin
-char MQTT_PASSWORD[CREDENTIAL_BUFFER_SIZE]; // Substitua pelo Password da host MQTT - admin
-
-int main(void)
+// Modo do canal mostrado na visão geral
+static const char *channel_mode(uint ch)
 {
+    if (failsafe_get(ch).tripped)
+    {
+        return "FS";
+    }
+    if (servo_get(ch)->enabled)
+    {
+        return "SRV";
+    }
+    if (hbridge_get(ch)->enabled)
+    {
+        return "HB";
+    }
+    if (pid_loop_enabled(ch))
+    {
+        return "PID";
+    }
+    if (pwm_wave_active(ch))
+    {
+        return "WAV";
+    }
+    return pwm_dither_active(ch) ? "DIT" : "PWM";
+}
 
-    // Inicializa todos os tipos de bibliotecas stdio padrão presentes que estão ligados ao binário.
-    stdio_init_all();
-    INFO_printf("mqtt client starting\n");
+// Atualiza o duty de um canal na interface; o desenho fica para o compositor
+static void show_duty(uint ch, uint duty)
+{
+    ui_view_set_duty(ch, fpwm[ch], duty, channel_mode(ch));
+    matrix_anim_set_bar(ch, duty * 10); // A barra desliza até o novo valor nos próximos quadros
+}
 
-    // Inicializa o conversor ADC
-    adc_init();
-    adc_set_temp_sensor_enabled(true);
-    adc_select_input(4);
+// Tela de configuração concluída do canal
+static void show_configured(uint ch)
+{
+    ui_view_set_configured(ch, fpwm[ch], channel_mode(ch));
+}
 
-    // Inicializa a matriz de LEDs
-    npInit();
-    npClear();
-    npWrite();
+// Compositor: desenha o display com o estado mais recente, em taxa fixa (a matriz de LEDs tem o seu timer)
+static void service_display(void)
+{
+    ui_view_service();
+}
 
-    // Inicializa o display
-    initDisplay(&ssd);
+// Interrupção do alarme de um comando agendado: o nível sai do TOP e da curva atuais e é escrito
+// pelo módulo térmico, que aplica o teto e passa a conhecer o novo nível do canal
+static void apply_scheduled_duty(uint8_t ch, uint16_t gpio, uint8_t duty)
+{
+    scene_stop_ramp(ch);
+    thermal_loop_set_level(ch, gpio, duty_to_level(ch, duty));
+}
 
-    draw_opening_usb(&ssd); // Desenha a tela de espera da comunicação USB
-    waitUSB();              // Espera a comunicação USB
+// Atualiza a interface com os comandos agendados que já foram aplicados pelo alarme
+static void service_scheduled_commands(void)
+{
+    cmd_sched_entry_t cmd;
+    while (cmd_sched_pop_fired(&cmd))
+    {
+        show_duty(cmd.channel, cmd.duty);
+        INFO_printf("Led %s agendado aplicado em %u%% (atraso %ld us)\n", led_names[cmd.channel], cmd.duty, (long)cmd.late_us);
+    }
+}
 
-    wifi_Credentials(WIFI_SSID, WIFI_PASSWORD, MQTT_SERVER, MQTT_USERNAME, MQTT_PASSWORD); // Solicita as credenciais da rede Wi-Fi
-    draw_opening_screen(&ssd);                                                             // Desenha a tela de espera da conexão com a rede Wi-Fi
+// Medição de frequência e duty ===============================
+// Canal comparado no modo loopback (-1 = sinal externo) e os valores esperados dele
+static int meas_loop_ch = -1;
+static uint32_t meas_expected_hz;
+static uint32_t meas_expected_duty_ppm;
 
-    // Cria registro com os dados do cliente
-    static MQTT_CLIENT_DATA_T state;
+// Duty atual do canal lido do registrador de comparação, em partes por milhão
+static uint32_t channel_duty_ppm(uint ch)
+{
+    uint slice = pwm_gpio_to_slice_num(led_rgb[ch]);
+    uint32_t cc = pwm_hw->slice[slice].cc;
+    uint32_t level = pwm_gpio_to_channel(led_rgb[ch]) == PWM_CHAN_B ? cc >> 16 : cc & 0xFFFF;
+    return (uint32_t)(((uint64_t)level * 1000000) / (pwm_hw->slice[slice].top + 1u));
+}
 
-    // Inicializa a arquitetura do cyw43
-    if (cyw43_arch_init())
+// Publica o resultado de uma medição concluída
+static void service_measurement(MQTT_CLIENT_DATA_T *state)
+{
+    static char msg[200];
+    pwm_meas_result_t r;
+    if (!pwm_meas_poll(&r))
     {
-        panic("Failed to inizialize CYW43");
+        return;
     }
 
-    // Usa identificador único da placa
-    char unique_id_buf[5];
-    pico_get_unique_board_id_string(unique_id_buf, sizeof(unique_id_buf));
-    for (int i = 0; i < sizeof(unique_id_buf) - 1; i++)
+    int len = snprintf(msg, sizeof(msg), "gpio=%lu gate_us=%lu edges=%llu f_mhz=%llu duty_ppm=%lu",
+                       (unsigned long)r.gpio, (unsigned long)r.gate_us, (unsigned long long)r.edges,
+                       (unsigned long long)r.freq_mhz, (unsigned long)r.duty_ppm);
+    if (meas_loop_ch >= 0)
     {
-        unique_id_buf[i] = tolower(unique_id_buf[i]);
+        // Erro da frequência informada em fpwm[] em relação à medida
+        int64_t err_ppm = r.freq_mhz ? ((int64_t)meas_expected_hz * 1000 - (int64_t)r.freq_mhz) * 1000000 / (int64_t)r.freq_mhz : 0;
+        len += snprintf(&msg[len], sizeof(msg) - len, " ch=%c fpwm=%lu err_ppm=%lld exp_duty_ppm=%lu",
+                        pwm_suffix[meas_loop_ch], (unsigned long)meas_expected_hz, (long long)err_ppm,
+                        (unsigned long)meas_expected_duty_ppm);
     }
+    len = MIN(len, (int)sizeof(msg) - 1);
+    INFO_printf("Medicao: %s\n", msg);
 
-    // Gera nome único, Ex: pico1234
-    char client_id_buf[sizeof(MQTT_DEVICE_NAME) + sizeof(unique_id_buf) - 1];
-    memcpy(&client_id_buf[0], MQTT_DEVICE_NAME, sizeof(MQTT_DEVICE_NAME) - 1);
-    memcpy(&client_id_buf[sizeof(MQTT_DEVICE_NAME) - 1], unique_id_buf, sizeof(unique_id_buf) - 1);
-    client_id_buf[sizeof(client_id_buf) - 1] = 0;
-    INFO_printf("Device name %s\n", client_id_buf);
+    cyw43_arch_lwip_begin();
+    mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_MEAS], msg, len, MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+    cyw43_arch_lwip_end();
+}
 
-    state.mqtt_client_info.client_id = client_id_buf;
-    state.mqtt_client_info.keep_alive = MQTT_KEEP_ALIVE_S; // Keep alive in sec
-    state.mqtt_client_info.client_user = MQTT_USERNAME;
-    state.mqtt_client_info.client_pass = MQTT_PASSWORD;
-    static char will_topic[MQTT_TOPIC_LEN];
-    strncpy(will_topic, full_topic(&state, MQTT_WILL_TOPIC), sizeof(will_topic));
-    state.mqtt_client_info.will_topic = will_topic;
-    state.mqtt_client_info.will_msg = MQTT_WILL_MSG;
-    state.mqtt_client_info.will_qos = MQTT_WILL_QOS;
-    state.mqtt_client_info.will_retain = true;
-#if LWIP_ALTCP && LWIP_ALTCP_TLS
-    // TLS enabled
-#ifdef MQTT_CERT_INC
-    static const uint8_t ca_cert[] = TLS_ROOT_CERT;
-    static const uint8_t client_key[] = TLS_CLIENT_KEY;
-    static const uint8_t client_cert[] = TLS_CLIENT_CERT;
-    // This confirms the indentity of the server and the client
-    state.mqtt_client_info.tls_config = altcp_tls_create_config_client_2wayauth(ca_cert, sizeof(ca_cert),
-                                                                                client_key, sizeof(client_key), NULL, 0, client_cert, sizeof(client_cert));
-#if ALTCP_MBEDTLS_AUTHMODE != MBEDTLS_SSL_VERIFY_REQUIRED
-    WARN_printf("Warning: tls without verification is insecure\n");
-#endif
-#else
-    state->client_info.tls_config = altcp_tls_create_config_client(NULL, 0);
-    WARN_printf("Warning: tls without a certificate is insecure\n");
-#endif
-#endif
+// Captura contínua do ADC =====================================
+static volatile uint32_t adc_stream_in_flight;
+static uint32_t adc_stream_deferred; // Tentativas adiadas por fila do MQTT cheia
+static uint32_t adc_stream_decimated; // Blocos pulados pela política do enlace
+static bool adc_stream_delta;
 
-    // Conectar à rede WiFI - fazer um loop até que esteja conectado
-    cyw43_arch_enable_sta_mode();
-    if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 30000))
+static void adc_stream_pub_cb(__unused void *arg, err_t err)
+{
+    if (adc_stream_in_flight)
     {
-        panic("Failed to connect");
+        adc_stream_in_flight--;
     }
-    INFO_printf("\nConnected to Wifi\n");
+}
 
-    // Faz um pedido de DNS para o endereço IP do servidor MQTT
-    cyw43_arch_lwip_begin();
-    int err = dns_gethostbyname(MQTT_SERVER, &state.mqtt_server_address, dns_found, &state);
-    cyw43_arch_lwip_end();
+// Publica os blocos prontos enquanto houver espaço na fila do MQTT; o que não couber
+// fica no anel e, se ele encher, a própria captura descarta e conta os blocos.
+// A política do enlace limita as publicações em voo e pode publicar só 1 de cada N blocos.
+static void service_adc_stream(MQTT_CLIENT_DATA_T *state)
+{
+    static uint8_t payload[ADC_STREAM_MAX_PAYLOAD];
+    static uint32_t skip;
+    const link_mon_policy_t *policy = link_mon_policy();
+    const adc_stream_block_t *b;
 
-    // Se tiver o endereço, inicia o cliente
-    if (err == ERR_OK)
+    while (adc_stream_in_flight < policy->adc_in_flight && (b = adc_stream_peek()) != NULL)
     {
-        start_client(&state);
-    }
-    else if (err != ERR_INPROGRESS)
-    { // ERR_INPROGRESS means expect a callback
-        panic("dns request failed");
-    }
+        if (++skip < policy->adc_decimate)
+        {
+            adc_stream_decimated++;
+            adc_stream_release(false); // Aparece como lacuna na sequência, como uma perda
+            continue;
+        }
+        skip = 0;
 
-    // Loop condicionado a conexão mqtt
-    while (!state.connect_done || mqtt_client_is_connected(state.mqtt_client_inst))
-    {
-        cyw43_arch_poll();
-        cyw43_arch_wait_for_work_until(make_timeout_time_ms(10000));
-    }
+        bool unix_time = clock_sync_valid();
+        uint64_t t = unix_time ? clock_sync_local_to_unix(b->t_first_us) : b->t_first_us;
+        size_t len = adc_stream_encode(b, adc_stream_delta, t, unix_time, payload);
 
-    INFO_printf("mqtt client exiting\n");
-    return 0;
+        cyw43_arch_lwip_begin();
+        err_t err = mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_ADC_DATA], payload, len, 0, 0, adc_stream_pub_cb, state);
+        cyw43_arch_lwip_end();
+
+        if (err == ERR_MEM)
+        {
+            adc_stream_deferred++;
+            break;
+        }
+        if (err == ERR_OK)
+        {
+            adc_stream_in_flight++;
+        }
+        adc_stream_release(err == ERR_OK);
+    }
 }
 
-// Requisição para publicar
-static void pub_request_cb(__unused void *arg, err_t err)
+// Redução térmica ===========================================
+static void publish_thermal(MQTT_CLIENT_DATA_T *state)
 {
-    if (err != 0)
+    static char msg[80];
+    int len = snprintf(msg, sizeof(msg), "t_mc=%ld", (long)thermal_loop_temp_mc());
+    for (int ch = 0; ch < RGB_LED_COUNT; ch++)
     {
-        ERROR_printf("pub_request_cb failed %d", err);
+        len += snprintf(&msg[len], sizeof(msg) - len, " %c=%u", pwm_suffix[ch], thermal_loop_factor(ch));
     }
+    mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_THERMAL], msg, len, MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
 }
 
-// Topico MQTT
-static const char *full_topic(MQTT_CLIENT_DATA_T *state, const char *name)
+// Uso de memória do lwIP. Chamar com o lwIP travado.
+static void publish_net_mem(MQTT_CLIENT_DATA_T *state)
 {
-#if MQTT_UNIQUE_TOPIC
-    static char full_topic[MQTT_TOPIC_LEN];
-    snprintf(full_topic, sizeof(full_topic), "/%s%s", state->mqtt_client_info.client_id, name);
-    return full_topic;
-#else
-    return name;
-#endif
+    static char msg[256];
+    size_t len = net_mem_format(msg, sizeof(msg));
+    mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_NET_MEM], msg, len, MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
 }
 
-// Requisição de Assinatura - subscribe
-static void sub_request_cb(void *arg, err_t err)
+static void service_net_mem(MQTT_CLIENT_DATA_T *state)
 {
-    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
-    if (err != 0)
+    static absolute_time_t next;
+    static uint32_t last_tight;
+    if (!mqtt_client_is_connected(state->mqtt_client_inst))
     {
-        panic("subscribe request failed %d", err);
+        return;
     }
-    state->subscribe_count++;
-}
-
-// Requisição para encerrar a assinatura
-static void unsub_request_cb(void *arg, err_t err)
-{
-    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
-    if (err != 0)
+    cyw43_arch_lwip_begin();
+    uint32_t tight = net_mem_tight();
+    if (tight > last_tight || time_reached(next))
     {
-        panic("unsubscribe request failed %d", err);
+        if (tight > last_tight)
+        {
+            ERROR_printf("lwIP: %lu pools sem folga\n", (unsigned long)tight);
+        }
+        publish_net_mem(state);
+        next = make_timeout_time_ms(NET_MEM_PUBLISH_MS * link_mon_policy()->interval_mult);
     }
-    state->subscribe_count--;
-    assert(state->subscribe_count >= 0);
+    last_tight = tight;
+    cyw43_arch_lwip_end();
+}
 
-    // Stop if requested
-    if (state->subscribe_count <= 0 && state->stop_client)
+// Monitor do enlace ===========================================
+static uint32_t link_probe_period_ms = LINK_PROBE_MS;
+static absolute_time_t link_probe_next;
+static bool link_probe_pending;
+static uint64_t link_probe_sent_us;
+static uint32_t link_probe_gen; // Descarta o PUBACK de uma sonda que já expirou
+static volatile bool link_probe_answered;
+static volatile uint32_t link_probe_rtt_us;
+
+// PUBACK da sonda (ou erro do pedido), no contexto do lwIP: só guarda o tempo para o laço principal
+static void link_probe_cb(void *arg, err_t err)
+{
+    if ((uint32_t)(uintptr_t)arg == link_probe_gen)
     {
-        mqtt_disconnect(state->mqtt_client_inst);
+        link_probe_rtt_us = err == ERR_OK ? (uint32_t)(time_us_64() - link_probe_sent_us) : UINT32_MAX;
+        link_probe_answered = true;
     }
 }
 
-// Tópicos de assinatura
-static void sub_unsub_topics(MQTT_CLIENT_DATA_T *state, bool sub)
+// Estado do enlace com QoS 1: a própria publicação é a sonda do RTT. Chamar com o lwIP travado.
+static void publish_link(MQTT_CLIENT_DATA_T *state)
 {
-    mqtt_request_cb_t cb = sub ? sub_request_cb : unsub_request_cb;
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/exit"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    // Estes são os tópicos de assinatura do texto input no MQTT Panel (div: 8bits, wrap: 16bits)
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/pwmg"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/pwmb"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/pwmr"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    // Estes são os tópicos de assinatura do slider no MQTT Panel (duty cycle: 0-100%)
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/spwmg"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/spwmb"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/spwmr"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
+    static char msg[160];
+    link_mon_stats_t st;
+    link_mon_get_stats(&st);
+    const link_mon_policy_t *p = link_mon_policy();
+    int len = snprintf(msg, sizeof(msg),
+                       "level=%s rtt=%lu/%lu/%lu rssi=%ld timeouts=%lu mult=%u decim=%u inflight=%u keepalive=%u",
+                       link_mon_level_name(st.level), (unsigned long)st.rtt_avg_ms, (unsigned long)st.rtt_last_ms,
+                       (unsigned long)st.rtt_max_ms, (long)st.rssi_dbm, (unsigned long)st.timeouts, p->interval_mult,
+                       p->adc_decimate, p->adc_in_flight, state->mqtt_client_info.keep_alive);
+
+    link_probe_gen++;
+    link_probe_answered = false;
+    link_probe_sent_us = time_us_64();
+    err_t err = mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_LINK], msg, len, 1, 0, link_probe_cb,
+                             (void *)(uintptr_t)link_probe_gen);
+    if (err == ERR_OK)
+    {
+        link_probe_pending = true;
+    }
+    else
+    {
+        link_mon_timeout(); // Fila do MQTT cheia já é sinal de enlace congestionado
+    }
 }
 
-// Dados de entrada MQTT
-static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags)
+// Sonda o RTT e lê o RSSI a cada período; uma troca de nível é publicada na hora
+static void service_link(MQTT_CLIENT_DATA_T *state)
 {
-    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
-#if MQTT_UNIQUE_TOPIC
-    const char *basic_topic = state->topic + strlen(state->mqtt_client_info.client_id) + 1;
-#else
-    const char *basic_topic = state->topic;
-#endif
-    strncpy(state->data, (const char *)data, len);
-    state->len = len;
-    state->data[len] = '\0';
-
-    DEBUG_printf("Topic: %s, Message: %s\n", state->topic, state->data);
-
-    if (strcmp(basic_topic, "/exit") == 0)
+    if (!mqtt_client_is_connected(state->mqtt_client_inst))
     {
-        state->stop_client = true;      // stop the client when ALL subscriptions are stopped
-        sub_unsub_topics(state, false); // unsubscribe
+        link_probe_pending = false;
+        return;
     }
-    else if (strcmp(basic_topic, "/spwmg") == 0)
+
+    if (link_probe_pending && link_probe_answered)
     {
-        // Espera uma string no formato "div,wrap"
-        uint8_t div;
-        uint16_t wrap;
-        if (sscanf(state->data, "%hhu,%u", &div, &wrap) == 2)
+        link_probe_pending = false;
+        if (link_probe_rtt_us == UINT32_MAX)
         {
-            if (div > 255)
-            {
-                ERROR_printf("Divisor invalido\n");
-                div = 255;
-            }
-            else if (wrap > 65535)
-            {
-                ERROR_printf("Wrap invalido\n");
-                wrap = 65535;
-            }
-            pwm_wraps[0] = wrap;
-            fpwm[0] = PICO_CLOCK_FREQ_HZ / (wrap * div);
-            setup_pwm(led_rgb[0], div); // Configura o pwm para o led verde
-            draw_sucess_screen(&ssd, 1);
-            INFO_printf("Configurou o pwm para div:%hhu wrap:%u\n", div, wrap);
-            INFO_printf("E frequência de:%u Hz\n", fpwm[0]);
+            link_mon_timeout();
         }
         else
         {
-            ERROR_printf("Formato invalido. Esperado div,wrap\n");
+            link_mon_rtt(link_probe_rtt_us / 1000);
         }
     }
-    else if (strcmp(basic_topic, "/spwmb") == 0)
+    else if (link_probe_pending && time_us_64() - link_probe_sent_us > LINK_PROBE_TIMEOUT_MS * 1000ull)
     {
-        // Espera uma string no formato "div,wrap"
-        uint8_t div;
-        uint16_t wrap;
-        if (sscanf(state->data, "%hhu,%u", &div, &wrap) == 2)
-        {
-            if (div > 255)
-            {
-                ERROR_printf("Divisor invalido\n");
-                div = 255;
-            }
-            else if (wrap > 65535)
-            {
-                ERROR_printf("Wrap invalido\n");
-                wrap = 65535;
-            }
-            pwm_wraps[1] = wrap;
-            fpwm[1] = PICO_CLOCK_FREQ_HZ / (wrap * div);
-            setup_pwm(led_rgb[1], div); // Configura o pwm para o led verde
-            draw_sucess_screen(&ssd, 2);
-            INFO_printf("Configurou o pwm para div:%hhu wrap:%u\n", div, wrap);
-            INFO_printf("E frequência de:%u Hz\n", fpwm[1]);
-        }
-        else
-        {
-            ERROR_printf("Formato invalido. Esperado div,wrap\n");
-        }
+        cyw43_arch_lwip_begin();
+        link_probe_gen++; // O PUBACK atrasado não conta mais
+        cyw43_arch_lwip_end();
+        link_probe_pending = false;
+        link_mon_timeout();
+    }
+
+    bool changed = link_mon_poll_changed();
+    if (changed)
+    {
+        const link_mon_policy_t *p = link_mon_policy();
+        INFO_printf("Enlace %s: intervalos x%u, captura 1/%u com %u em voo\n", link_mon_level_name(link_mon_level()),
+                    p->interval_mult, p->adc_decimate, p->adc_in_flight);
     }
-    else if (strcmp(basic_topic, "/spwmr") == 0)
+    if (!link_probe_pending && (changed || time_reached(link_probe_next)))
     {
-        // Espera uma string no formato "div,wrap"
+        int32_t rssi = 0;
+        cyw43_wifi_get_rssi(&cyw43_state, &rssi);
+        link_mon_rssi(rssi);
+        cyw43_arch_lwip_begin();
+        publish_link(state);
+        cyw43_arch_lwip_end();
+        link_probe_next = make_timeout_time_ms(link_probe_period_ms);
+    }
+}
 
-        uint8_t div;
-        uint16_t wrap;
-        if (sscanf(state->data, "%hhu,%u", &div, &wrap) == 2)
-        {
-            if (div > 255)
+// Enlace: "rtt,razoavel_ms,ruim_ms[,hist_pct]", "rssi,razoavel_dbm,ruim_dbm[,hist_db]",
+// "policy,nivel,mult,decim,emvoo" (nivel 0 bom, 1 razoável, 2 ruim), "probe,ms",
+// "keepalive,s" (vale na próxima conexão) ou "status" para publicar na hora
+static void handle_link(MQTT_CLIENT_DATA_T *state, const char *data)
+{
+    link_mon_thresholds_t t = *link_mon_thresholds();
+    unsigned a, b, c, d;
+    int da, db, dc;
+    int n;
+    bool ok = true;
+
+    if ((n = sscanf(data, "rtt,%u,%u,%u", &a, &b, &c)) >= 2)
+    {
+        t.rtt_fair_ms = a;
+        t.rtt_poor_ms = b;
+        t.rtt_hyst_pct = n == 3 ? c : t.rtt_hyst_pct;
+        ok = link_mon_set_thresholds(&t);
+    }
+    else if ((n = sscanf(data, "rssi,%d,%d,%d", &da, &db, &dc)) >= 2)
+    {
+        t.rssi_fair_dbm = da;
+        t.rssi_poor_dbm = db;
+        t.rssi_hyst_db = n == 3 ? dc : t.rssi_hyst_db;
+        ok = link_mon_set_thresholds(&t);
+    }
+    else if (sscanf(data, "policy,%u,%u,%u,%u", &a, &b, &c, &d) == 4)
+    {
+        link_mon_policy_t p = {.interval_mult = MIN(b, 255), .adc_decimate = MIN(c, 255), .adc_in_flight = MIN(d, 255)};
+        ok = link_mon_set_policy(a, &p);
+    }
+    else if (sscanf(data, "probe,%u", &a) == 1)
+    {
+        ok = a >= LINK_PROBE_MIN_MS && a <= LINK_PROBE_MAX_MS;
+        link_probe_period_ms = ok ? a : link_probe_period_ms;
+    }
+    else if (sscanf(data, "keepalive,%u", &a) == 1)
+    {
+        ok = a <= UINT16_MAX;
+        state->mqtt_client_info.keep_alive = ok ? a : state->mqtt_client_info.keep_alive;
+    }
+    else if (strncmp(data, "status", 6) != 0)
+    {
+        ERROR_printf("Formato invalido. Esperado rtt,..., rssi,..., policy,..., probe,ms, keepalive,s ou status\n");
+        return;
+    }
+
+    if (!ok)
+    {
+        ERROR_printf("Parametros do enlace invalidos\n");
+        return;
+    }
+    link_probe_next = get_absolute_time(); // Publica o estado com a configuração nova
+}
+
+// Duty pedido para o dithering de cada canal e o último aplicado, já limitado pelo fator térmico
+static uint32_t dither_duty_q16[RGB_LED_COUNT];
+static uint32_t dither_applied_q16[RGB_LED_COUNT];
+
+// Regera a sequência do dithering com o duty limitado pelo fator térmico, como o teto de
+// derate_apply nos canais em duty fixo; só quando o duty efetivo muda
+static void apply_dither_duty(uint ch, bool force)
+{
+    uint32_t cap = ((uint64_t)SIGMA_DELTA_ONE * thermal_loop_factor(ch)) / DERATE_ONE;
+    uint32_t duty = MIN(dither_duty_q16[ch], cap);
+    if (force || duty != dither_applied_q16[ch])
+    {
+        dither_applied_q16[ch] = duty;
+        pwm_dither_set(ch, duty);
+    }
+}
+
+// Publica o fator ativo quando a política em segundo plano o altera. Com o enlace bom, no máximo
+// uma vez por período do timer térmico; a política do enlace multiplica esse intervalo, e a
+// mudança que chega antes dele sai depois com o valor mais recente.
+static void service_thermal(MQTT_CLIENT_DATA_T *state)
+{
+    static bool pending;
+    static absolute_time_t next;
+    if (thermal_loop_poll_changed())
+    {
+        pending = true;
+        for (int ch = 0; ch < RGB_LED_COUNT; ch++)
+        {
+            if (pwm_dither_active(ch))
+            {
+                apply_dither_duty(ch, false);
+            }
+        }
+    }
+    if (!pending || !time_reached(next) || !mqtt_client_is_connected(state->mqtt_client_inst))
+    {
+        return;
+    }
+    pending = false;
+    next = make_timeout_time_ms(THERMAL_LOOP_PERIOD_MS * link_mon_policy()->interval_mult);
+    INFO_printf("Reducao termica: %ld mC, fatores %u/%u/%u\n", (long)thermal_loop_temp_mc(), thermal_loop_factor(0),
+                thermal_loop_factor(1), thermal_loop_factor(2));
+    cyw43_arch_lwip_begin();
+    publish_thermal(state);
+    cyw43_arch_lwip_end();
+}
+
+// Falha segura e reconexão =====================================
+// Mostra na interface os canais que foram levados ao duty seguro
+static void service_failsafe(void)
+{
+    uint32_t mask = failsafe_poll_tripped();
+    for (int ch = 0; ch < RGB_LED_COUNT; ch++)
+    {
+        if (mask & (1u << ch))
+        {
+            failsafe_channel_t fs = failsafe_get(ch);
+            show_duty(ch, fs.safe_permille / 10);
+            matrix_anim_play(MATRIX_LAYER_ALERT, &matrix_seq_failsafe);
+            ERROR_printf("Falha segura no Led %s: sem comandos ha %lu ms, indo a %u%%\n", led_names[ch],
+                         (unsigned long)fs.timeout_ms, fs.safe_permille / 10);
+        }
+    }
+}
+
+// Indicador do estado da conexão na matriz de LEDs; só troca a sequência quando o estado muda
+static void show_link(const matrix_anim_seq_t *seq)
+{
+    static const matrix_anim_seq_t *current;
+    if (seq != current)
+    {
+        current = seq;
+        matrix_anim_play(MATRIX_LAYER_STATUS, seq);
+    }
+}
+
+// Credenciais  da rede Wi-Fi e MQTT ===============================
+char WIFI_SSID[CREDENTIAL_BUFFER_SIZE];     // Substitua pelo nome da sua rede Wi-Fi
+char WIFI_PASSWORD[CREDENTIAL_BUFFER_SIZE]; // Substitua pela senha da sua rede Wi-Fi
+char MQTT_SERVER[CREDENTIAL_BUFFER_SIZE];   // Substitua pelo endereço do host - broket MQTT: Ex: 192.168.1.107
+char MQTT_USERNAME[CREDENTIAL_BUFFER_SIZE]; // Substitua pelo nome da host MQTT - admin
+char MQTT_PASSWORD[CREDENTIAL_BUFFER_SIZE]; // Substitua pelo Password da host MQTT - admin
+
+// Credenciais lidas da flash na inicialização ou gravadas depois por "salvar"
+static bool credentials_in_flash;
+
+// Reconecta ao broker periodicamente; sem Wi-Fi por muito tempo, reinicia pelo watchdog
+static void service_connection(MQTT_CLIENT_DATA_T *state)
+{
+    static uint32_t link_down_since;
+    static uint32_t last_attempt;
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    bool link_up = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) == CYW43_LINK_UP;
+    bool mqtt_up = mqtt_client_is_connected(state->mqtt_client_inst);
+
+    show_link(!link_up ? &matrix_seq_link_lost : (mqtt_up ? &matrix_seq_connected : &matrix_seq_connecting));
+    if (!link_up)
+    {
+        if (link_down_since == 0)
+        {
+            link_down_since = now ? now : 1;
+            ERROR_printf("Wi-Fi perdido\n");
+        }
+        else if (now - link_down_since > WIFI_LINK_LOSS_REBOOT_MS && credentials_in_flash)
+        {
+            watchdog_sup_reboot(REBOOT_LINK_LOST);
+        }
+        else if (now - link_down_since > WIFI_LINK_LOSS_REBOOT_MS)
+        {
+            ERROR_printf("Wi-Fi perdido ha %lu s; credenciais fora da flash, associando de novo sem reiniciar\n",
+                         (unsigned long)((now - link_down_since) / 1000));
+            link_down_since = now ? now : 1;
+            cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+            cyw43_arch_wifi_connect_async(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK);
+        }
+        return;
+    }
+    link_down_since = 0;
+
+    if (state->resubscribe && mqtt_up && !state->stop_client)
+    {
+        ERROR_printf("Assinatura expirou; reconectando ao broker\n");
+        state->resubscribe = false;
+        last_attempt = now; // Reconecta depois de MQTT_RECONNECT_PERIOD_MS
+        cyw43_arch_lwip_begin();
+        mqtt_disconnect(state->mqtt_client_inst);
+        cyw43_arch_lwip_end();
+        return;
+    }
+    if (!state->connect_done || state->stop_client || mqtt_up || now - last_attempt < MQTT_RECONNECT_PERIOD_MS)
+    {
+        return;
+    }
+    last_attempt = now;
+    INFO_printf("Reconectando ao broker\n");
+    err_t err = connect_client(state);
+    if (err != ERR_OK)
+    {
+        ERROR_printf("Reconexao falhou %d\n", err);
+    }
+}
+
+// Perfis de clock =============================================
+// Perfil pedido por MQTT, aplicado no laço principal (0 = nenhum)
+static volatile uint32_t pending_clock_khz;
+
+// Refaz divisor e TOP de um canal em duty fixo ou PID para manter a frequência pedida
+static void retime_pwm_channel(uint ch)
+{
+    pwm_timing_t t;
+    uint16_t old_top = pwm_wraps[ch];
+    uint slice = pwm_gpio_to_slice_num(led_rgb[ch]);
+    if (!pwm_calc_solve(clock_get_hz(clk_sys), fpwm[ch], &t))
+    {
+        ERROR_printf("Led %s: %lu Hz fora da faixa no novo clock\n", led_names[ch], (unsigned long)fpwm[ch]);
+        return;
+    }
+    pwm_set_clkdiv_int_frac(slice, t.div16 >> 4, t.div16 & 0xF);
+    pwm_set_wrap(slice, t.top);
+    pwm_wraps[ch] = t.top;
+    transfer_curve_build(&curves[ch], t.top);
+    pid_loop_set_top(ch, t.top);
+    thermal_loop_retime(ch, old_top, t.top); // Mantém o duty do canal em duty fixo
+}
+
+// Troca o clk_sys e recalcula tudo o que depende dele: PWM de cada canal, PIO da matriz e I2C
+static void service_clock_profile(void)
+{
+    uint32_t khz = pending_clock_khz;
+    if (khz == 0)
+    {
+        return;
+    }
+    pending_clock_khz = 0;
+    if (pwm_meas_busy())
+    {
+        ERROR_printf("Troca de clock adiada: medicao em andamento\n");
+        pending_clock_khz = khz;
+        return;
+    }
+
+    // Formas de onda, dithering e rampas guardam níveis calculados para o TOP antigo (os comandos
+    // agendados guardam o duty e calculam o nível na aplicação)
+    for (int ch = 0; ch < RGB_LED_COUNT; ch++)
+    {
+        pwm_wave_stop(ch);
+        pwm_dither_stop(ch);
+        scene_stop_ramp(ch);
+    }
+
+    // Sem atividade do driver do Wi-Fi durante a troca do PLL
+    cyw43_arch_lwip_begin();
+    bool ok = clock_profile_set(khz);
+    cyw43_arch_lwip_end();
+    if (!ok)
+    {
+        ERROR_printf("Perfil de clock invalido: %lu kHz\n", (unsigned long)khz);
+        return;
+    }
+
+    npRetime();
+    i2c_set_baudrate(I2C_PORT, I2C_BAUD_HZ);
+    for (int ch = 0; ch < RGB_LED_COUNT; ch++)
+    {
+        if (servo_get(ch)->enabled)
+        {
+            servo_retime(ch, led_rgb[ch]);
+            pwm_wraps[ch] = servo_get(ch)->timing.top;
+        }
+        else if (hbridge_get(ch)->enabled)
+        {
+            uint16_t old_top = pwm_wraps[ch];
+            hbridge_retime(ch);
+            pwm_wraps[ch] = hbridge_get(ch)->timing.top;
+            transfer_curve_build(&curves[ch], pwm_wraps[ch]);
+            thermal_loop_retime(ch, old_top, pwm_wraps[ch]);
+        }
+        else if (pwm_wraps[ch] > 0 && hbridge_complement_owner(led_rgb[ch]) < 0)
+        {
+            retime_pwm_channel(ch);
+        }
+    }
+    scene_recompile();
+    INFO_printf("clk_sys em %lu kHz; TOP dos canais: %u/%u/%u\n", (unsigned long)clock_profile_current_khz(), pwm_wraps[0],
+                pwm_wraps[1], pwm_wraps[2]);
+}
+
+// Credenciais gravadas pelo comando "salvar" do terminal USB; com elas a inicialização não espera pelo terminal
+typedef struct
+{
+    char wifi_ssid[CREDENTIAL_BUFFER_SIZE];
+    char wifi_password[CREDENTIAL_BUFFER_SIZE];
+    char mqtt_server[CREDENTIAL_BUFFER_SIZE];
+    char mqtt_username[CREDENTIAL_BUFFER_SIZE];
+    char mqtt_password[CREDENTIAL_BUFFER_SIZE];
+} credentials_t;
+
+static bool load_credentials(void)
+{
+    static credentials_t c; // Fora da pilha: cinco buffers de credencial
+    if (!flash_store_load(FLASH_STORE_SLOT_CREDENTIALS, &c, sizeof(c)))
+    {
+        return false;
+    }
+    memcpy(WIFI_SSID, c.wifi_ssid, CREDENTIAL_BUFFER_SIZE);
+    memcpy(WIFI_PASSWORD, c.wifi_password, CREDENTIAL_BUFFER_SIZE);
+    memcpy(MQTT_SERVER, c.mqtt_server, CREDENTIAL_BUFFER_SIZE);
+    memcpy(MQTT_USERNAME, c.mqtt_username, CREDENTIAL_BUFFER_SIZE);
+    memcpy(MQTT_PASSWORD, c.mqtt_password, CREDENTIAL_BUFFER_SIZE);
+    return true;
+}
+
+static bool save_credentials(void)
+{
+    static credentials_t c;
+    memcpy(c.wifi_ssid, WIFI_SSID, CREDENTIAL_BUFFER_SIZE);
+    memcpy(c.wifi_password, WIFI_PASSWORD, CREDENTIAL_BUFFER_SIZE);
+    memcpy(c.mqtt_server, MQTT_SERVER, CREDENTIAL_BUFFER_SIZE);
+    memcpy(c.mqtt_username, MQTT_USERNAME, CREDENTIAL_BUFFER_SIZE);
+    memcpy(c.mqtt_password, MQTT_PASSWORD, CREDENTIAL_BUFFER_SIZE);
+    return flash_store_save(FLASH_STORE_SLOT_CREDENTIALS, &c, sizeof(c));
+}
+
+int main(void)
+{
+    // Registra o instante de cada fase da inicialização
+    boot_timeline_init();
+    watchdog_sup_init();
+
+    // Inicializa todos os tipos de bibliotecas stdio padrão presentes que estão ligados ao binário.
+    stdio_init_all();
+    INFO_printf("mqtt client starting\n");
+
+    // Inicializa o conversor ADC
+    adc_init();
+    adc_set_temp_sensor_enabled(true);
+    adc_select_input(4);
+    thermal_loop_start(); // Redução de potência pela temperatura do chip, em segundo plano
+    cmd_sched_init(apply_scheduled_duty);
+
+    // Cenas dos canais e grupos de endereçamento guardados na flash
+    const uint32_t scene_gpios[SCENE_CHANNELS] = {led_rgb[0], led_rgb[1], led_rgb[2]};
+    scene_init(scene_gpios);
+    mqtt_group_init();
+    link_mon_init();
+
+    // Inicializa a matriz de LEDs
+    npInit();
+    npClear();
+    npWrite();
+    // A partir daqui a matriz é transmitida pelo motor de animações, em taxa fixa
+    if (matrix_anim_start(np_pio, sm, MATRIX_ANIM_DEFAULT_FPS))
+    {
+        matrix_anim_play(MATRIX_LAYER_STATUS, &matrix_seq_connecting);
+    }
+
+    // Inicializa o display
+    initDisplay(&ssd);
+    boot_timeline_mark(BOOT_PHASE_DISPLAY);
+
+    credentials_in_flash = load_credentials();
+    if (credentials_in_flash)
+    {
+        // Credenciais da flash: sem esperar pelo terminal ("esquecer" no terminal volta a pedir)
+        boot_timeline_mark(BOOT_PHASE_USB);
+        INFO_printf("Credenciais lidas da flash (rede %s)\n", WIFI_SSID);
+    }
+    else
+    {
+        draw_opening_usb(&ssd); // Desenha a tela de espera da comunicação USB
+        waitUSB();              // Espera a comunicação USB
+        boot_timeline_mark(BOOT_PHASE_USB);
+
+        wifi_Credentials(WIFI_SSID, WIFI_PASSWORD, MQTT_SERVER, MQTT_USERNAME, MQTT_PASSWORD); // Solicita as credenciais da rede Wi-Fi
+    }
+    boot_timeline_mark(BOOT_PHASE_CREDENTIALS);
+    draw_opening_screen(&ssd);                                                             // Desenha a tela de espera da conexão com a rede Wi-Fi
+
+    // Cria registro com os dados do cliente
+    static MQTT_CLIENT_DATA_T state;
+
+    // Inicializa a arquitetura do cyw43
+    if (cyw43_arch_init())
+    {
+        panic("Failed to inizialize CYW43");
+    }
+    boot_timeline_mark(BOOT_PHASE_CYW43_INIT);
+
+    // Usa identificador único da placa
+    char unique_id_buf[5];
+    pico_get_unique_board_id_string(unique_id_buf, sizeof(unique_id_buf));
+    for (int i = 0; i < sizeof(unique_id_buf) - 1; i++)
+    {
+        unique_id_buf[i] = tolower(unique_id_buf[i]);
+    }
+
+    // Gera nome único, Ex: pico1234
+    char client_id_buf[sizeof(MQTT_DEVICE_NAME) + sizeof(unique_id_buf) - 1];
+    memcpy(&client_id_buf[0], MQTT_DEVICE_NAME, sizeof(MQTT_DEVICE_NAME) - 1);
+    memcpy(&client_id_buf[sizeof(MQTT_DEVICE_NAME) - 1], unique_id_buf, sizeof(unique_id_buf) - 1);
+    client_id_buf[sizeof(client_id_buf) - 1] = 0;
+    INFO_printf("Device name %s\n", client_id_buf);
+
+    state.mqtt_client_info.client_id = client_id_buf;
+    state.mqtt_client_info.keep_alive = MQTT_KEEP_ALIVE_S; // Keep alive in sec
+    state.mqtt_client_info.client_user = MQTT_USERNAME;
+    state.mqtt_client_info.client_pass = MQTT_PASSWORD;
+    build_topics(client_id_buf); // Prefixos montados uma vez; as publicações só apontam para eles
+    state.mqtt_client_info.will_topic = pub_topics[PUB_ONLINE];
+    state.mqtt_client_info.will_msg = MQTT_WILL_MSG;
+    state.mqtt_client_info.will_qos = MQTT_WILL_QOS;
+    state.mqtt_client_info.will_retain = true;
+#if LWIP_ALTCP && LWIP_ALTCP_TLS
+    // TLS enabled
+#ifdef MQTT_CERT_INC
+    static const uint8_t ca_cert[] = TLS_ROOT_CERT;
+    static const uint8_t client_key[] = TLS_CLIENT_KEY;
+    static const uint8_t client_cert[] = TLS_CLIENT_CERT;
+    // This confirms the indentity of the server and the client
+    state.mqtt_client_info.tls_config = altcp_tls_create_config_client_2wayauth(ca_cert, sizeof(ca_cert),
+                                                                                client_key, sizeof(client_key), NULL, 0, client_cert, sizeof(client_cert));
+#if ALTCP_MBEDTLS_AUTHMODE != MBEDTLS_SSL_VERIFY_REQUIRED
+    WARN_printf("Warning: tls without verification is insecure\n");
+#endif
+#else
+    state->client_info.tls_config = altcp_tls_create_config_client(NULL, 0);
+    WARN_printf("Warning: tls without a certificate is insecure\n");
+#endif
+#endif
+
+    // Conectar à rede WiFI - fazer um loop até que esteja conectado
+    cyw43_arch_enable_sta_mode();
+    if (wifi_conn_connect(WIFI_SSID, WIFI_PASSWORD, WIFI_CONNECT_TIMEOUT_MS))
+    {
+        panic("Failed to connect");
+    }
+    INFO_printf("\nConnected to Wifi%s\n", wifi_conn_used_fast_path() ? " (fast join)" : "");
+
+    // Disciplina o relógio local por SNTP para os comandos agendados
+#ifdef CLOCK_SYNC_NTP_SERVER
+    clock_sync_start(CLOCK_SYNC_NTP_SERVER);
+#else
+    clock_sync_start(MQTT_SERVER);
+#endif
+
+    // Faz um pedido de DNS para o endereço IP do servidor MQTT
+    cyw43_arch_lwip_begin();
+    int err = dns_gethostbyname(MQTT_SERVER, &state.mqtt_server_address, dns_found, &state);
+    cyw43_arch_lwip_end();
+
+    // Se tiver o endereço, inicia o cliente
+    if (err == ERR_OK)
+    {
+        boot_timeline_mark(BOOT_PHASE_DNS);
+        start_client(&state);
+    }
+    else if (err != ERR_INPROGRESS)
+    { // ERR_INPROGRESS means expect a callback
+        panic("dns request failed");
+    }
+
+    // A partir daqui nada bloqueia: falha segura dos canais e watchdog ligados
+    failsafe_start();
+    ui_view_init(&ssd); // A tela de abertura fica até a primeira mudança de estado
+    watchdog_sup_start();
+    INFO_printf("Ultimo reinicio: %s (%lu seguidos)\n", watchdog_sup_reason_name(watchdog_sup_reason()),
+                (unsigned long)watchdog_sup_reboot_count());
+    shell_start(&state);
+
+    // Loop até o /exit; quedas do broker ou do Wi-Fi são tratadas dentro dele
+    while (!state.stop_client || mqtt_client_is_connected(state.mqtt_client_inst))
+    {
+        cyw43_arch_poll();
+        service_connection(&state);
+        service_failsafe();
+        service_scheduled_commands();
+        service_measurement(&state);
+        service_adc_stream(&state);
+        service_thermal(&state);
+        service_net_mem(&state);
+        service_link(&state);
+        service_clock_profile();
+        service_display();
+        usb_shell_service();
+        watchdog_sup_service();
+        pwm_wave_service();
+        cyw43_arch_wait_for_work_until(make_timeout_time_ms(MAIN_LOOP_PERIOD_MS));
+    }
+
+    watchdog_sup_stop();
+    INFO_printf("mqtt client exiting\n");
+    return 0;
+}
+
+// Requisição para publicar
+static void pub_request_cb(__unused void *arg, err_t err)
+{
+    if (err != 0)
+    {
+        ERROR_printf("pub_request_cb failed %d", err);
+    }
+}
+
+// Publica a linha do tempo da inicialização e imprime na USB
+static void publish_boot_timeline(MQTT_CLIENT_DATA_T *state)
+{
+    static char msg[160];
+    size_t len = boot_timeline_format(boot_timeline_current(), msg, sizeof(msg));
+    boot_timeline_print();
+    mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_BOOT], msg, len, MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+}
+
+// Publica o motivo do último reinício, a cada conexão ao broker
+static void publish_reboot_reason(MQTT_CLIENT_DATA_T *state)
+{
+    static char msg[96];
+    int len = snprintf(msg, sizeof(msg), "reason=%s count=%lu reconnects=%lu uptime_ms=%lu",
+                       watchdog_sup_reason_name(watchdog_sup_reason()), (unsigned long)watchdog_sup_reboot_count(),
+                       (unsigned long)state->reconnects, (unsigned long)to_ms_since_boot(get_absolute_time()));
+    mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_REBOOT], msg, len, MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+}
+
+// Requisição de Assinatura - subscribe
+static void sub_request_cb(void *arg, err_t err)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
+    if (err == ERR_TIMEOUT)
+    {
+        // Link instável: encerra a sequência e deixa o laço principal reconectar e assinar tudo de novo
+        ERROR_printf("subscribe request timed out\n");
+        state->resubscribe = true;
+        return;
+    }
+    if (err != 0)
+    {
+        // SUBACK com falha (ERR_ABRT), por exemplo /all/# ou um grupo negado pela ACL do broker:
+        // conta como respondida para a sequência seguir e a placa chegar a pronta
+        ERROR_printf("subscribe request failed %d\n", err);
+    }
+    state->subscribe_count++;
+    boot_timeline_mark(BOOT_PHASE_SUBACK);
+    sub_unsub_next(state);
+
+    // Todos os tópicos assinados: dispositivo pronto para receber comandos
+    if (state->subscribe_count == state->subscribe_total && state->reconnects == 0)
+    {
+        boot_timeline_mark(BOOT_PHASE_READY);
+        publish_boot_timeline(state);
+    }
+}
+
+// Requisição para encerrar a assinatura
+static void unsub_request_cb(void *arg, err_t err)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
+    if (err == ERR_TIMEOUT)
+    {
+        // Conta como feita: a desconexão no fim encerra a assinatura do mesmo jeito
+        ERROR_printf("unsubscribe request timed out\n");
+    }
+    else if (err != 0)
+    {
+        panic("unsubscribe request failed %d", err);
+    }
+    state->subscribe_count--;
+    assert(state->subscribe_count >= 0);
+    sub_unsub_next(state);
+
+    // Stop if requested
+    if (state->subscribe_count <= 0 && state->stop_client)
+    {
+        mqtt_disconnect(state->mqtt_client_inst);
+    }
+}
+
+// Tópicos de assinatura
+static const char *const sub_topics[] = {
+    "/exit",
+    // Estes são os tópicos de assinatura do texto input no MQTT Panel (div: 8bits, wrap: 16bits)
+    "/pwmg",
+    "/pwmb",
+    "/pwmr",
+    // Estes são os tópicos de assinatura do slider no MQTT Panel (duty cycle: 0-100%)
+    "/spwmg",
+    "/spwmb",
+    "/spwmr",
+    // Formas de onda reproduzidas por DMA no comparador do PWM
+    "/waveg",
+    "/waveb",
+    "/waver",
+    // Dithering sigma-delta do duty por DMA
+    "/ditherg",
+    "/ditherb",
+    "/ditherr",
+    // Curva de brilho (gamma, CIE ou tabela do usuário)
+    "/curveg",
+    "/curveb",
+    "/curver",
+    // Modo servo/ESC: configuração do quadro e pulso em us ou graus
+    "/srvcfgg",
+    "/srvcfgb",
+    "/srvcfgr",
+    "/servog",
+    "/servob",
+    "/servor",
+    // Laço fechado PID com realimentação pelo ADC
+    "/pidg",
+    "/pidb",
+    "/pidr",
+    // Medição de frequência e duty
+    "/meas",
+    // Captura contínua do ADC
+    "/adc",
+    // Perfil do clock do sistema
+    "/clock",
+    // Tela do display: canal atual ou visão geral
+    "/ui",
+    // Animações da matriz de LEDs
+    "/matrix",
+    // Cenas: configuração de todos os canais por uma mensagem
+    "/scene",
+    // Grupos de endereçamento desta placa
+    "/group",
+    // Eco dos comandos tratados em /applied
+    "/trace",
+    // Uso de memória do lwIP: "reset" recomeça os picos; qualquer outra mensagem publica na hora
+    "/netmem",
+    // Limiares e política do monitor do enlace
+    "/link",
+    // Meia ponte com saídas complementares e tempo morto
+    "/hbridgeg",
+    "/hbridgeb",
+    "/hbridger",
+    // Falha segura: tempo limite por canal e batimento que rearma todos
+    "/failsafeg",
+    "/failsafeb",
+    "/failsafer",
+    "/hb",
+    // Redução térmica: política por canal e teste com temperatura injetada
+    "/derateg",
+    "/derateb",
+    "/derater",
+    "/thermal",
+    // Sincronização de relógio: referência do broker e medição de defasagem
+    "/time",
+    "/skew",
+};
+
+// Os tópicos do dispositivo são (des)assinados em sequência, então a lista pode crescer além dos
+// slots de requisição do lwIP. Na conexão saem de uma vez /all, os grupos e o primeiro tópico do
+// dispositivo. Cada SUBACK, de grupo ou de tópico, envia o tópico seguinte: até 2 + grupos tópicos
+// do dispositivo podem estar em andamento juntos, mas cada resposta libera o slot que o próximo
+// ocupa, então as assinaturas nunca passam de 1 + grupos + 1. Somam-se as publicações QoS 1 de
+// /online e /reboot e um /group add recebido durante a sequência; metade dos slots fica livre
+// para as publicações QoS 1 do laço principal.
+#define MQTT_CONNECT_REQUESTS ((1 + MQTT_GROUP_MAX + 1) + 2 + 1)
+static_assert(MQTT_CONNECT_REQUESTS <= MQTT_REQ_MAX_IN_FLIGHT / 2, "assinaturas da conexao ocupariam os slots do MQTT");
+
+// Prefixos dos tópicos dirigidos a um canal (seguidos do sufixo g, b ou r)
+static const char *const channel_topics[] = {"/spwm", "/pwm", "/wave", "/srvcfg", "/servo", "/pid", "/derate", "/failsafe", "/hbridge", "/dither", "/curve"};
+
+// Filtro de assinatura de um grupo ("/grp/<nome>/#") ou, sem nome, de todas as placas ("/all/#")
+static void group_sub_unsub(MQTT_CLIENT_DATA_T *state, const char *name, mqtt_request_cb_t cb, bool sub)
+{
+    char filter[sizeof(MQTT_GROUP_PREFIX) + MQTT_GROUP_NAME_LEN + 2];
+    if (name)
+    {
+        snprintf(filter, sizeof(filter), "%s/%s/#", MQTT_GROUP_PREFIX, name);
+    }
+    else
+    {
+        snprintf(filter, sizeof(filter), "%s/#", MQTT_BROADCAST_PREFIX);
+    }
+    err_t err = mqtt_sub_unsub(state->mqtt_client_inst, filter, MQTT_SUBSCRIBE_QOS, cb, state, sub);
+    if (err != ERR_OK)
+    {
+        ERROR_printf("mqtt_sub_unsub %s failed %d\n", filter, err);
+    }
+}
+
+// Envia o próximo tópico do dispositivo da sequência em andamento; chamado ao iniciar a sequência
+// e no callback de cada resposta do broker. Uma falha ou uma assinatura expirada encerra a
+// sequência (a próxima conexão refaz).
+static void sub_unsub_next(MQTT_CLIENT_DATA_T *state)
+{
+    if (state->resubscribe || state->sub_next >= count_of(sub_topics))
+    {
+        return;
+    }
+    char topic[MQTT_PUB_TOPIC_LEN];
+    const char *name = sub_topics[state->sub_next++];
+    bool sub = state->sub_pacing_sub;
+    memcpy(topic, device_prefix, device_prefix_len);
+    strncpy(&topic[device_prefix_len], name, sizeof(topic) - device_prefix_len - 1);
+    topic[sizeof(topic) - 1] = '\0';
+    err_t err = mqtt_sub_unsub(state->mqtt_client_inst, topic, MQTT_SUBSCRIBE_QOS, sub ? sub_request_cb : unsub_request_cb,
+                               state, sub);
+    if (err != ERR_OK)
+    {
+        ERROR_printf("mqtt_sub_unsub %s failed %d; %d topicos nao %sassinados\n", name, err,
+                     (int)(count_of(sub_topics) - state->sub_next + 1), sub ? "" : "des");
+        state->sub_next = count_of(sub_topics);
+    }
+}
+
+static void sub_unsub_topics(MQTT_CLIENT_DATA_T *state, bool sub)
+{
+    mqtt_request_cb_t cb = sub ? sub_request_cb : unsub_request_cb;
+    state->subscribe_total = count_of(sub_topics) + 1 + mqtt_group_count();
+
+    // Primeiro uma assinatura com curinga para todas as placas e uma por grupo, de uma vez, para
+    // que comandos em grupo cheguem já na conexão; depois os tópicos do dispositivo, um por vez
+    group_sub_unsub(state, NULL, cb, sub);
+    for (size_t i = 0; i < mqtt_group_count(); i++)
+    {
+        group_sub_unsub(state, mqtt_group_name(i), cb, sub);
+    }
+
+    state->sub_next = 0;
+    state->sub_pacing_sub = sub;
+    state->resubscribe = false;
+    sub_unsub_next(state);
+}
+
+// Retorna o índice do canal se o tópico for o prefixo seguido do sufixo de um canal (ex: "/pwm" + 'g')
+static int topic_channel(const char *topic, const char *prefix)
+{
+    size_t n = strlen(prefix);
+    if (strncmp(topic, prefix, n) != 0 || topic[n] == '\0' || topic[n + 1] != '\0')
+    {
+        return -1;
+    }
+    for (int i = 0; i < RGB_LED_COUNT; i++)
+    {
+        if (topic[n] == pwm_suffix[i])
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Espera uma string no formato "div,wrap"
+static void handle_pwm_config(uint ch, const char *data)
+{
+    uint div;
+    uint wrap;
+    if (sscanf(data, "%u,%u", &div, &wrap) == 2)
+    {
+        if (div < 1 || div > 255)
+        {
+            ERROR_printf("Divisor invalido\n");
+            div = div < 1 ? 1 : 255;
+        }
+        if (wrap < 1 || wrap > 65535)
+        {
+            ERROR_printf("Wrap invalido\n");
+            wrap = wrap < 1 ? 1 : 65535;
+        }
+        pwm_wave_stop(ch);
+        pwm_dither_stop(ch);
+        scene_stop_ramp(ch);
+        pid_loop_disable(ch);
+        servo_disable(ch);
+        hbridge_disable(ch);
+        thermal_loop_release(ch);
+        pwm_wraps[ch] = wrap;
+        transfer_curve_build(&curves[ch], wrap); // Níveis da curva escalados para o novo TOP
+        fpwm[ch] = clock_get_hz(clk_sys) / ((wrap + 1) * div); // O período tem wrap + 1 ciclos do contador
+        setup_pwm(led_rgb[ch], div);
+        show_configured(ch);
+        INFO_printf("Configurou o pwm para div:%u wrap:%u\n", div, wrap);
+        INFO_printf("E frequência de:%u Hz\n", fpwm[ch]);
+    }
+    else
+    {
+        ERROR_printf("Formato invalido. Esperado div,wrap\n");
+    }
+}
+
+static void handle_dither_duty(uint ch, const char *data);
+
+// Espera o duty cycle "0-100", ou "0-100@us_desde_1970" para aplicar no instante indicado
+static void handle_pwm_duty(uint ch, const char *data)
+{
+    uint duty;
+    unsigned long long at_unix_us;
+    if (pwm_dither_active(ch))
+    {
+        handle_dither_duty(ch, data); // Com dithering o duty aceita casas decimais
+        return;
+    }
+    int n = sscanf(data, "%u@%llu", &duty, &at_unix_us);
+    if (n < 1)
+    {
+        ERROR_printf("Erro formato invalido. Esperado 0-100\n");
+        return;
+    }
+    if (duty > 100)
+    {
+        duty = 100;
+    }
+
+    // Em modo servo o duty também precisa respeitar os limites do pulso
+    const servo_t *servo = servo_get(ch);
+    if (servo->enabled)
+    {
+        uint32_t pulse_ns = (uint64_t)duty * 10000000u / servo->freq_hz;
+        if (pulse_ns < servo->min_ns || pulse_ns > servo->max_ns)
+        {
+            ERROR_printf("Duty fora dos limites do servo\n");
+            return;
+        }
+    }
+
+    if (n == 2)
+    {
+        // O alarme escreve só metade do CC, o que quebraria o tempo morto da meia ponte
+        if (hbridge_get(ch)->enabled)
+        {
+            ERROR_printf("Comando agendado nao suportado em meia ponte\n");
+            return;
+        }
+        // Forma de onda e PID reescreveriam o comparador depois do alarme
+        if (pwm_wave_active(ch) || pid_loop_enabled(ch))
+        {
+            ERROR_printf("Comando agendado exige duty fixo: pare a forma de onda ou o PID do Led %s\n", led_names[ch]);
+            return;
+        }
+        if (!clock_sync_valid())
+        {
+            ERROR_printf("Relogio nao sincronizado, comando agendado descartado\n");
+            return;
+        }
+        uint64_t target_us = clock_sync_unix_to_local(at_unix_us);
+        if (!cmd_sched_add(target_us, ch, led_rgb[ch], duty))
+        {
+            ERROR_printf("Agendamento recusado (fila cheia ou instante passado)\n");
+            return;
+        }
+        INFO_printf("Led %s agendado para %u%% em %lld us\n", led_names[ch], duty, (long long)(target_us - time_us_64()));
+        return;
+    }
+
+    pwm_wave_stop(ch); // Um duty fixo substitui a forma de onda em reprodução, o laço fechado e a rampa de uma cena
+    pid_loop_disable(ch);
+    scene_stop_ramp(ch);
+    set_pwm_duty(led_rgb[ch], duty);
+    show_duty(ch, duty);
+    INFO_printf("Ligou o Led %s no valor de: %u%%\n", led_names[ch], duty);
+}
+
+// Converte um decimal com até 3 casas ("1500" ou "1500.25") para milésimos da unidade.
+// Retorna o ponteiro após o número, ou NULL se não houver número.
+static const char *parse_milli(const char *p, int32_t *out)
+{
+    char *end;
+    long whole = strtol(p, &end, 10);
+    int32_t frac = 0;
+    if (end == p)
+    {
+        return NULL;
+    }
+    if (*end == '.')
+    {
+        int32_t scale = 100;
+        for (end++; isdigit((unsigned char)*end); end++)
+        {
+            frac += (*end - '0') * scale;
+            scale /= 10;
+        }
+    }
+    *out = whole * 1000 + (*p == '-' ? -frac : frac);
+    return end;
+}
+
+// Configuração do modo servo: "freq_hz,min_us,max_us[,us_0graus,us_180graus]"
+static void handle_servo_config(uint ch, const char *data)
+{
+    int32_t v[4];
+    int count = 0;
+    char *end;
+    uint freq = strtoul(data, &end, 10);
+    const char *p = end;
+
+    while (count < 4 && *p == ',' && (p = parse_milli(p + 1, &v[count])) != NULL)
+    {
+        count++;
+    }
+    if (p == NULL || (count != 2 && count != 4) || v[0] < 0 || v[1] < 0)
+    {
+        ERROR_printf("Formato invalido. Esperado freq,min_us,max_us[,us_0,us_180]\n");
+        return;
+    }
+    if (count == 2)
+    {
+        v[2] = v[0];
+        v[3] = v[1];
+    }
+    // O servo troca o divisor e o TOP do slice inteiro
+    int sib = slice_sibling(ch);
+    if (sib >= 0 && channel_in_mode(sib))
+    {
+        ERROR_printf("Servo nao permitido com servo, forma de onda, dithering ou PID no Led %s (mesmo slice)\n", led_names[sib]);
+        return;
+    }
+
+    pwm_wave_stop(ch);
+    pwm_dither_stop(ch);
+    pid_loop_disable(ch);
+    hbridge_disable(ch);
+    thermal_loop_release(ch);
+    if (!servo_configure(ch, led_rgb[ch], freq, v[0], v[1], v[2], v[3]))
+    {
+        ERROR_printf("Configuracao de servo invalida (%u-%u Hz, min < max < periodo)\n", SERVO_FREQ_MIN_HZ, SERVO_FREQ_MAX_HZ);
+        return;
+    }
+    const servo_t *servo = servo_get(ch);
+    // O outro canal do slice, em duty fixo, segue o novo TOP mantendo o seu duty
+    if (sib >= 0 && pwm_wraps[sib] != 0)
+    {
+        thermal_loop_retime(sib, pwm_wraps[sib], servo->timing.top);
+        pwm_wraps[sib] = servo->timing.top;
+        fpwm[sib] = freq;
+        transfer_curve_build(&curves[sib], servo->timing.top);
+    }
+    pwm_wraps[ch] = servo->timing.top;
+    transfer_curve_build(&curves[ch], 0); // O duty do servo continua linear
+    fpwm[ch] = freq;
+    show_configured(ch);
+    INFO_printf("Servo no Led %s: %u Hz, pulso %ld-%ld ns, passo de %lu ns\n", led_names[ch], freq, (long)v[0], (long)v[1],
+                (unsigned long)(1000000000u / freq / (servo->timing.top + 1u)));
+}
+
+// Pulso do servo em us ("1500.25") ou ângulo em graus com sufixo d ("90d")
+static void handle_servo_pulse(uint ch, const char *data)
+{
+    int32_t value;
+    const char *end = parse_milli(data, &value);
+    const servo_t *servo = servo_get(ch);
+
+    if (!servo->enabled)
+    {
+        ERROR_printf("Canal nao esta em modo servo\n");
+        return;
+    }
+    if (end == NULL || value < 0)
+    {
+        ERROR_printf("Formato invalido. Esperado us ou graus seguido de d\n");
+        return;
+    }
+
+    uint32_t pulse_ns = *end == 'd' ? servo_angle_to_ns(ch, value) : (uint32_t)value;
+    if (!servo_set_pulse_ns(ch, led_rgb[ch], pulse_ns))
+    {
+        ERROR_printf("Pulso de %lu ns fora dos limites %lu-%lu ns\n", (unsigned long)pulse_ns,
+                     (unsigned long)servo->min_ns, (unsigned long)servo->max_ns);
+        return;
+    }
+    show_duty(ch, (uint64_t)pulse_ns * servo->freq_hz / 10000000u);
+    INFO_printf("Servo do Led %s em %lu ns\n", led_names[ch], (unsigned long)pulse_ns);
+}
+
+// Duty com dithering: percentual com até 3 casas ("37.125"), sem agendamento
+static void handle_dither_duty(uint ch, const char *data)
+{
+    int32_t milli;
+    const char *end = parse_milli(data, &milli);
+    if (end == NULL || *end == '@' || milli < 0)
+    {
+        ERROR_printf("Formato invalido. Esperado 0-100 com ate 3 casas (sem agendamento)\n");
+        return;
+    }
+    milli = MIN(milli, 100000);
+    dither_duty_q16[ch] = (uint32_t)(((uint64_t)milli * SIGMA_DELTA_ONE + 50000) / 100000);
+    apply_dither_duty(ch, true);
+    show_duty(ch, (milli + 500) / 1000);
+    INFO_printf("Led %s com dithering em %ld.%03ld%%\n", led_names[ch], (long)(milli / 1000), (long)(milli % 1000));
+}
+
+// Dithering do duty: "len" (16-4096, potência de 2) liga com sequências desse tamanho; "off" desliga
+static void handle_dither(uint ch, const char *data)
+{
+    if (strncmp(data, "off", 3) == 0)
+    {
+        pwm_dither_stop(ch);
+        INFO_printf("Dithering do Led %s desligado\n", led_names[ch]);
+        return;
+    }
+
+    // Dois canais DMA escrevendo o mesmo CC se sobrescreveriam
+    uint len = strtoul(data, NULL, 10);
+    int sibling = (led_rgb[ch] ^ 1) - PWM_ARRAY_OFFSET;
+    bool sibling_dma = sibling >= 0 && sibling < RGB_LED_COUNT && (pwm_wave_active(sibling) || pwm_dither_active(sibling));
+    if (pwm_wraps[ch] == 0 || servo_get(ch)->enabled || hbridge_get(ch)->enabled || sibling_dma)
+    {
+        ERROR_printf("Dithering exige /spwm e nao convive com servo, meia ponte ou DMA no outro canal do slice\n");
+        return;
+    }
+
+    pwm_wave_stop(ch);
+    pid_loop_disable(ch);
+    thermal_loop_release(ch);
+    cmd_sched_cancel_channel(ch);
+    pwm_dither_err_t err = pwm_dither_start(ch, led_rgb[ch], len);
+    if (err != PWM_DITHER_OK)
+    {
+        ERROR_printf("Dithering recusado: %s (tamanho %u-%u, pelo menos %u bits e %u ciclos por periodo)\n",
+                     pwm_dither_err_name(err), PWM_DITHER_MIN_LEN, PWM_DITHER_MAX_LEN, PWM_DITHER_MIN_BITS,
+                     PWM_DITHER_MIN_PERIOD_CYCLES);
+        return;
+    }
+    dither_duty_q16[ch] = dither_applied_q16[ch] = 0; // pwm_dither_start começa em 0%
+    show_configured(ch);
+    INFO_printf("Dithering no Led %s: %u periodos, ~%lu.%02lu bits efetivos\n", led_names[ch], len,
+                (unsigned long)(sigma_delta_bits_x100(pwm_wraps[ch], len) / 100),
+                (unsigned long)(sigma_delta_bits_x100(pwm_wraps[ch], len) % 100));
+}
+
+// Curva de brilho: "linear", "cie", "gamma[,valor]" (padrão 2.2) ou "lut,p0,p1,...,pn" com 2 a 33
+// pontos de saída em milésimos para entradas igualmente espaçadas. Vale a partir do próximo /pwm.
+static void handle_curve(uint ch, const char *data)
+{
+    transfer_curve_t *curve = &curves[ch];
+    bool ok = true;
+
+    if (strncmp(data, "linear", 6) == 0)
+    {
+        transfer_curve_set_linear(curve);
+    }
+    else if (strncmp(data, "cie", 3) == 0)
+    {
+        transfer_curve_set_cie(curve);
+    }
+    else if (strncmp(data, "gamma", 5) == 0)
+    {
+        int32_t gamma = 2200;
+        ok = (data[5] == '\0' || (data[5] == ',' && parse_milli(data + 6, &gamma) != NULL)) && gamma > 0 &&
+             transfer_curve_set_gamma(curve, gamma);
+    }
+    else if (strncmp(data, "lut,", 4) == 0)
+    {
+        uint16_t points[TRANSFER_CURVE_MAX_POINTS];
+        uint32_t n = 0;
+        const char *p = data + 3;
+        char *end;
+        while (ok && *p == ',' && n < TRANSFER_CURVE_MAX_POINTS)
+        {
+            points[n++] = strtoul(p + 1, &end, 10);
+            ok = end != p + 1;
+            p = end;
+        }
+        ok = ok && *p == '\0' && transfer_curve_set_lut(curve, points, n);
+    }
+    else
+    {
+        ok = false;
+    }
+
+    if (!ok)
+    {
+        ERROR_printf("Curva invalida. Esperado linear, cie, gamma[,%u-%u] ou lut,p0,...,pn (%u-%u pontos 0-1000)\n",
+                     TRANSFER_CURVE_GAMMA_MIN / 1000, TRANSFER_CURVE_GAMMA_MAX / 1000, TRANSFER_CURVE_MIN_POINTS,
+                     TRANSFER_CURVE_MAX_POINTS);
+        return;
+    }
+    transfer_curve_build(curve, servo_get(ch)->enabled ? 0 : pwm_wraps[ch]);
+    INFO_printf("Curva do Led %s: %s (1%% -> nivel %u de %u)\n", led_names[ch], transfer_curve_name(curve->kind),
+                duty_to_level(ch, 1), pwm_wraps[ch]);
+}
+
+// Ganho decimal ("0.25") para Q16.16
+static bool parse_gain(const char **p, int32_t *gain)
+{
+    int32_t milli;
+    const char *end = parse_milli(*p, &milli);
+    if (end == NULL)
+    {
+        return false;
+    }
+    *gain = (int32_t)(((int64_t)milli << PID_Q) / 1000);
+    *p = *end == ',' ? end + 1 : end;
+    return true;
+}
+
+// Publica as estatísticas de temporização do laço e o estado de cada canal
+static void publish_pid_stats(MQTT_CLIENT_DATA_T *state)
+{
+    static char msg[400];
+    pid_loop_stats_t st;
+    pid_loop_get_stats(&st);
+    int len = snprintf(msg, sizeof(msg), "rate=%lu ticks=%lu ovr=%lu jit=%ld..%ld exec_max=%lu",
+                       (unsigned long)st.rate_hz, (unsigned long)st.ticks, (unsigned long)st.overruns,
+                       st.ticks > 1 ? (long)st.jitter_min_us : 0L, st.ticks > 1 ? (long)st.jitter_max_us : 0L,
+                       (unsigned long)st.exec_max_us);
+    for (int ch = 0; ch < RGB_LED_COUNT && len < sizeof(msg); ch++)
+    {
+        pid_loop_channel_t c;
+        pid_loop_get_channel(ch, &c);
+        len += snprintf(&msg[len], sizeof(msg) - len, " | %c on=%d in=%u sp=%ld y=%ld u=%ld kp=%ld ki=%ld kd=%ld lim=%ld..%ld",
+                        pwm_suffix[ch], c.enabled, c.adc_input, (long)c.setpoint, (long)c.measurement, (long)c.output,
+                        (long)c.pid.kp, (long)c.pid.ki, (long)c.pid.kd, (long)c.pid.out_min, (long)c.pid.out_max);
+    }
+    len = MIN(len, (int)sizeof(msg) - 1);
+    mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_PID_STATS], msg, len, MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+}
+
+// Laço fechado, na escala de 12 bits do ADC (0-4095):
+//   "on,entrada_adc" liga com realimentação na entrada 0-3; "off" desliga;
+//   "sp,valor" setpoint; "gains,kp,ki,kd" ganhos decimais (ki em 1/s, kd em s);
+//   "lim,min,max" limites da saída; "rate,hz" frequência do laço (1000-10000, todos os canais);
+//   "stats" publica temporização e estado em /pid/stats
+static void handle_pid(MQTT_CLIENT_DATA_T *state, uint ch, const char *data)
+{
+    const char *args = strchr(data, ',');
+    bool ok = false;
+    uint a, b;
+
+    args = args ? args + 1 : "";
+    if (strncmp(data, "on", 2) == 0 && sscanf(args, "%u", &a) == 1 && pwm_wraps[ch] > 0 && !servo_get(ch)->enabled &&
+        !hbridge_get(ch)->enabled &&
+        !adc_stream_active())
+    {
+        pwm_wave_stop(ch);
+        pwm_dither_stop(ch);
+        thermal_loop_release(ch);
+        cmd_sched_cancel_channel(ch);
+        ok = pid_loop_enable(ch, led_rgb[ch], a, pwm_wraps[ch]);
+    }
+    else if (strncmp(data, "off", 3) == 0)
+    {
+        pid_loop_disable(ch);
+        ok = true;
+    }
+    else if (strncmp(data, "sp", 2) == 0 && sscanf(args, "%u", &a) == 1)
+    {
+        pid_loop_set_setpoint(ch, a);
+        ok = true;
+    }
+    else if (strncmp(data, "gains", 5) == 0)
+    {
+        int32_t kp, ki, kd;
+        ok = parse_gain(&args, &kp) && parse_gain(&args, &ki) && parse_gain(&args, &kd);
+        if (ok)
+        {
+            pid_loop_set_gains(ch, kp, ki, kd);
+        }
+    }
+    else if (strncmp(data, "lim", 3) == 0 && sscanf(args, "%u,%u", &a, &b) == 2 && a <= b)
+    {
+        pid_loop_set_limits(ch, a, b);
+        ok = true;
+    }
+    else if (strncmp(data, "rate", 4) == 0 && sscanf(args, "%u", &a) == 1)
+    {
+        ok = pid_loop_set_rate(a);
+    }
+    else if (strncmp(data, "stats", 5) == 0)
+    {
+        publish_pid_stats(state);
+        ok = true;
+    }
+
+    if (!ok)
+    {
+        ERROR_printf("Comando PID invalido: %s\n", data);
+    }
+}
+
+static void publish_adc_stats(MQTT_CLIENT_DATA_T *state)
+{
+    static char msg[160];
+    adc_stream_stats_t st;
+    adc_stream_get_stats(&st);
+    int len = snprintf(msg, sizeof(msg), "active=%d mask=0x%lx rate=%lu blocks=%lu sent=%lu dropped=%lu deferred=%lu decimated=%lu",
+                       adc_stream_active(), (unsigned long)st.input_mask, (unsigned long)st.rate_hz, (unsigned long)st.blocks,
+                       (unsigned long)st.sent, (unsigned long)st.dropped, (unsigned long)adc_stream_deferred,
+                       (unsigned long)adc_stream_decimated);
+    mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_ADC_STATS], msg, len, MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+}
+
+// Captura do ADC: "start,mascara,hz[,delta]" (bits 0-4 da máscara = entradas, hz por entrada),
+// "stop" ou "stats". O ADC roda livre durante a captura, então não convive com o laço PID.
+static void handle_adc_stream(MQTT_CLIENT_DATA_T *state, const char *data)
+{
+    unsigned long mask, rate;
+    bool ok = false;
+
+    if (strncmp(data, "start,", 6) == 0)
+    {
+        char *end;
+        mask = strtoul(data + 6, &end, 0);
+        rate = *end == ',' ? strtoul(end + 1, &end, 10) : 0;
+        bool any_pid = false;
+        for (int ch = 0; ch < RGB_LED_COUNT; ch++)
+        {
+            any_pid |= pid_loop_enabled(ch);
+        }
+        if (!any_pid)
+        {
+            adc_stream_delta = strstr(end, "delta") != NULL;
+            adc_stream_deferred = 0;
+            adc_stream_decimated = 0;
+            ok = adc_stream_start(mask, rate);
+        }
+    }
+    else if (strncmp(data, "stop", 4) == 0)
+    {
+        adc_stream_stop();
+        ok = true;
+    }
+    else if (strncmp(data, "stats", 5) == 0)
+    {
+        publish_adc_stats(state);
+        ok = true;
+    }
+
+    if (!ok)
+    {
+        ERROR_printf("Comando de captura invalido: %s\n", data);
+    }
+}
+
+// Política térmica do canal: "inicio_c,total_c,minimo_pct[,histerese_c]" (temperaturas com decimais)
+static void handle_derate_policy(uint ch, const char *data)
+{
+    int32_t v[4] = {0, 0, 0, 3000};
+    int count = 0;
+    const char *p = parse_milli(data, &v[0]);
+
+    while (p != NULL && ++count < 4 && *p == ',')
+    {
+        p = parse_milli(p + 1, &v[count]);
+    }
+    // O mínimo chega em milésimos de ponto percentual; o fator é em milésimos
+    if (count < 3 || v[2] < 0 || !thermal_loop_set_policy(ch, v[0], v[1], v[2] / 100, v[3]))
+    {
+        ERROR_printf("Politica termica invalida. Esperado inicio_c,total_c,minimo_pct[,histerese_c]\n");
+        return;
+    }
+    INFO_printf("Reducao termica do Led %s: %ld-%ld mC, minimo %ld%%\n", led_names[ch], (long)v[0], (long)v[1], (long)(v[2] / 1000));
+}
+
+// Temperatura: "inject,graus" substitui o sensor (teste), "sensor" volta ao sensor, "status" publica o estado
+static void handle_thermal(MQTT_CLIENT_DATA_T *state, const char *data)
+{
+    int32_t mc;
+    if (strncmp(data, "inject,", 7) == 0 && parse_milli(data + 7, &mc))
+    {
+        thermal_loop_inject(mc);
+    }
+    else if (strncmp(data, "sensor", 6) == 0)
+    {
+        thermal_loop_inject(INT32_MIN);
+    }
+    else if (strncmp(data, "status", 6) == 0)
+    {
+        publish_thermal(state);
+    }
+    else
+    {
+        ERROR_printf("Comando termico invalido: %s\n", data);
+    }
+}
+
+// Perfil de clock: "48", "125" ou "200" (MHz)
+static void handle_clock(const char *data)
+{
+    uint32_t khz = strtoul(data, NULL, 10) * 1000;
+    if (!clock_profile_valid(khz))
+    {
+        ERROR_printf("Perfil de clock invalido. Esperado 48, 125 ou 200\n");
+        return;
+    }
+    pending_clock_khz = khz; // A troca bloqueia o Wi-Fi por alguns ms; fica para o laço principal
+}
+
+// Amostra do gráfico: duty lido do comparador, ou frequência em escala log2 de 1 Hz a 2^26 Hz
+static uint16_t chart_sample(uint32_t ch, bool freq)
+{
+    if (!freq)
+    {
+        return channel_duty_ppm(ch) / 1000;
+    }
+    uint32_t f = fpwm[ch];
+    if (f == 0)
+    {
+        return 0;
+    }
+    // Parte inteira do log2 pelo bit mais alto e 10 bits de fração por interpolação linear
+    uint32_t bits = 31 - __builtin_clz(f);
+    uint32_t frac = (uint32_t)((((uint64_t)f - (1u << bits)) << 10) >> bits);
+    return (uint16_t)MIN((bits * 1024 + frac) * OLED_CHART_FULL_SCALE / (26 * 1024), OLED_CHART_FULL_SCALE);
+}
+
+// Interface: "geral" mostra os três canais; "canal" volta à tela do último canal alterado;
+// "grafico,canais,hz[,freq]" mostra o histórico (ex: "grafico,gbr,10"); "rate,hz" muda a
+// taxa do compositor (1-20 Hz); "stats" mostra os contadores no terminal
+static void handle_ui(const char *data)
+{
+    uint hz;
+    char chans[8];
+    if (sscanf(data, "grafico,%7[gbr],%u", chans, &hz) == 2)
+    {
+        uint32_t mask = 0;
+        for (int ch = 0; ch < RGB_LED_COUNT; ch++)
+        {
+            mask |= strchr(chans, pwm_suffix[ch]) ? 1u << ch : 0;
+        }
+        if (!ui_view_chart(mask, hz, strstr(data, ",freq") != NULL, chart_sample))
+        {
+            ERROR_printf("Grafico invalido (%u-%u amostras/s)\n", UI_CHART_RATE_MIN_HZ, UI_CHART_RATE_MAX_HZ);
+        }
+    }
+    else if (strncmp(data, "geral", 5) == 0)
+    {
+        ui_view_set_screen(UI_SCREEN_OVERVIEW);
+    }
+    else if (strncmp(data, "canal", 5) == 0)
+    {
+        ui_view_set_screen(UI_SCREEN_CHANNEL);
+    }
+    else if (sscanf(data, "rate,%u", &hz) == 1 && ui_view_set_rate(hz))
+    {
+        INFO_printf("Compositor a %u Hz\n", hz);
+    }
+    else if (strncmp(data, "stats", 5) == 0)
+    {
+        ui_view_stats_t st;
+        ui_view_get_stats(&st);
+        INFO_printf("Interface: %lu Hz, %lu mudancas, %lu quadros, desenho max %lu us, %lu colunas do grafico\n",
+                    (unsigned long)st.rate_hz, (unsigned long)st.updates, (unsigned long)st.frames,
+                    (unsigned long)st.render_max_us, (unsigned long)st.chart_samples);
+    }
+    else
+    {
+        ERROR_printf("Formato invalido. Esperado geral, canal, grafico,canais,hz[,freq], rate,%u-%u ou stats\n",
+                     UI_VIEW_RATE_MIN_HZ, UI_VIEW_RATE_MAX_HZ);
+    }
+}
+
+// Matriz de LEDs: "fps,n" muda a taxa de quadros (10-60); "brilho,pct[,gama]" recalcula a
+// tabela de brilho (ex: "brilho,2.5,2.2"); "stats" mostra a temporização no terminal
+static void handle_matrix(const char *data)
+{
+    uint fps;
+    int32_t pct, gamma = 1000;
+    const char *p;
+    if (sscanf(data, "fps,%u", &fps) == 1 && matrix_anim_set_fps(fps))
+    {
+        INFO_printf("Matriz a %u quadros/s\n", fps);
+    }
+    else if (strncmp(data, "brilho,", 7) == 0 && (p = parse_milli(data + 7, &pct)) != NULL && pct >= 0 && pct <= 100000 &&
+             (*p != ',' || parse_milli(p + 1, &gamma) != NULL) && gamma > 0 && gamma <= 5000)
+    {
+        led_matrix_set_brightness(pct / 100, gamma);
+        INFO_printf("Brilho da matriz: %ld.%01ld%%, gama %ld.%03ld\n", (long)(pct / 1000), (long)(pct % 1000 / 100),
+                    (long)(gamma / 1000), (long)(gamma % 1000));
+    }
+    else if (strncmp(data, "stats", 5) == 0)
+    {
+        matrix_anim_stats_t st;
+        matrix_anim_get_stats(&st);
+        INFO_printf("Matriz: %lu quadros/s, %lu quadros, %lu descartados, composicao max %lu us, jitter max %ld us\n",
+                    (unsigned long)st.fps, (unsigned long)st.frames, (unsigned long)st.overruns,
+                    (unsigned long)st.compose_max_us, (long)st.jitter_max_us);
+    }
+    else
+    {
+        ERROR_printf("Formato invalido. Esperado fps,%u-%u, brilho,pct[,gama] ou stats\n", MATRIX_ANIM_FPS_MIN, MATRIX_ANIM_FPS_MAX);
+    }
+}
+
+// Libera um canal de qualquer modo ativo antes de o slice ser reconfigurado
+static void release_channel(uint ch)
+{
+    pwm_wave_stop(ch);
+    pwm_dither_stop(ch);
+    scene_stop_ramp(ch);
+    pid_loop_disable(ch);
+    servo_disable(ch);
+    thermal_loop_release(ch);
+    pwm_wraps[ch] = 0; // Volta a exigir /spwm
+}
+
+// Aplica uma cena: libera os canais dela de qualquer modo, copia a imagem dos registradores e
+// atualiza o estado de cada canal
+static void recall_scene(uint32_t n)
+{
+    const scene_t *s = scene_get(n);
+    if (s == NULL)
+    {
+        ERROR_printf("Cena %lu: %s\n", (unsigned long)n, scene_err_name(SCENE_ERR_INDEX));
+        return;
+    }
+    // O outro canal do slice, fora da cena, só acompanha o novo divisor e TOP em duty fixo; uma
+    // meia ponte dele sobre o canal da cena é desfeita abaixo
+    for (int ch = 0; ch < RGB_LED_COUNT; ch++)
+    {
+        int sib = slice_sibling(ch);
+        if ((s->mask & (1u << ch)) && sib >= 0 && !(s->mask & (1u << sib)) &&
+            hbridge_complement_owner(led_rgb[ch]) != sib && channel_in_mode(sib))
+        {
+            ERROR_printf("Cena %lu: %s (Led %s fora da cena em servo, forma de onda, dithering, PID ou meia ponte)\n",
+                         (unsigned long)n, scene_err_name(SCENE_ERR_SLICE), led_names[sib]);
+            return;
+        }
+    }
+    for (int ch = 0; ch < RGB_LED_COUNT; ch++)
+    {
+        if (!(s->mask & (1u << ch)))
+        {
+            continue;
+        }
+        int owner = hbridge_complement_owner(led_rgb[ch]);
+        if (owner >= 0)
+        {
+            hbridge_disable(owner); // O canal volta a ser independente do vizinho
+            release_channel(owner);
+        }
+        hbridge_disable(ch);
+        release_channel(ch);
+        cmd_sched_cancel_channel(ch);
+        failsafe_feed(ch);
+    }
+
+    scene_err_t err = scene_recall(n);
+    if (err != SCENE_OK)
+    {
+        ERROR_printf("Cena %lu: %s\n", (unsigned long)n, scene_err_name(err));
+        return;
+    }
+
+    for (int ch = 0; ch < RGB_LED_COUNT; ch++)
+    {
+        if (!(s->mask & (1u << ch)))
+        {
+            continue;
+        }
+        const scene_reg_t *r = &s->reg[ch];
+        pwm_timing_t t = {.div16 = r->div16, .top = r->top};
+        pwm_wraps[ch] = r->top;
+        fpwm[ch] = pwm_calc_freq(clock_get_hz(clk_sys), &t);
+        transfer_curve_build(&curves[ch], r->top);
+        show_duty(ch, s->ch[ch].duty_permille / 10);
+
+        // O outro canal do slice, fora da cena, segue o novo TOP mantendo o seu duty
+        for (int sib = 0; sib < RGB_LED_COUNT; sib++)
+        {
+            if (sib != ch && !(s->mask & (1u << sib)) && pwm_gpio_to_slice_num(led_rgb[sib]) == r->slice &&
+                pwm_wraps[sib] != 0 && pwm_wraps[sib] != r->top)
+            {
+                thermal_loop_retime(sib, pwm_wraps[sib], r->top);
+                pwm_wraps[sib] = r->top;
+                fpwm[sib] = fpwm[ch];
+                transfer_curve_build(&curves[sib], r->top);
+            }
+        }
+    }
+    INFO_printf("Cena %lu%s%s aplicada\n", (unsigned long)n, s->name[0] ? " " : "", s->name);
+}
+
+// Lê "freq_hz/duty_pct[/rampa_ms]" ou "-"; retorna o ponteiro após o canal, ou NULL
+static const char *parse_scene_channel(const char *p, scene_channel_t *out, bool *used)
+{
+    char *end;
+    int32_t milli;
+    *used = *p != '-';
+    if (!*used)
+    {
+        return p + 1;
+    }
+    out->freq_hz = strtoul(p, &end, 10);
+    if (end == p || *end != '/' || (p = parse_milli(end + 1, &milli)) == NULL || milli < 0 || milli > 100000)
+    {
+        return NULL;
+    }
+    out->duty_permille = (uint16_t)(milli / 100);
+    out->ramp_ms = 0;
+    if (*p == '/')
+    {
+        out->ramp_ms = strtoul(p + 1, &end, 10);
+        p = end;
+    }
+    return p;
+}
+
+// Cenas: "n" ou "nome" aplica a cena; "def,n[:nome],g,b,r" define, com cada canal como
+// "freq_hz/duty_pct[/rampa_ms]" ou "-" para não mexer (ex: "def,1:palco,1000/50/300,1000/20,-");
+// "del,n" apaga; "list" mostra as cenas no terminal
+static void handle_scene(const char *data)
+{
+    if (strncmp(data, "def,", 4) == 0)
+    {
+        char *end;
+        char name[SCENE_NAME_LEN] = "";
+        scene_channel_t chans[SCENE_CHANNELS] = {0};
+        uint32_t mask = 0;
+        uint32_t n = strtoul(data + 4, &end, 10);
+        const char *p = end;
+        if (*p == ':')
+        {
+            size_t len = strcspn(p + 1, ",");
+            if (len == 0 || len >= sizeof(name) || isdigit((unsigned char)p[1]))
+            {
+                ERROR_printf("Nome de cena invalido (1-%u caracteres, comecando por letra)\n", SCENE_NAME_LEN - 1);
+                return;
+            }
+            memcpy(name, p + 1, len);
+            p += len + 1;
+        }
+        for (int ch = 0; ch < SCENE_CHANNELS && p; ch++)
+        {
+            bool used;
+            p = *p == ',' ? parse_scene_channel(p + 1, &chans[ch], &used) : NULL;
+            mask |= p && used ? 1u << ch : 0;
+        }
+        if (p == NULL || end == data + 4)
+        {
+            ERROR_printf("Formato invalido. Esperado def,n[:nome],g,b,r com freq_hz/duty_pct[/rampa_ms] ou -\n");
+            return;
+        }
+        scene_err_t err = scene_define(n, name, mask, chans);
+        if (err != SCENE_OK)
+        {
+            ERROR_printf("Cena %lu: %s\n", (unsigned long)n, scene_err_name(err));
+            return;
+        }
+        INFO_printf("Cena %lu definida\n", (unsigned long)n);
+    }
+    else if (strncmp(data, "del,", 4) == 0)
+    {
+        uint32_t n = strtoul(data + 4, NULL, 10);
+        scene_err_t err = scene_delete(n);
+        if (err != SCENE_OK)
+        {
+            ERROR_printf("Cena %lu: %s\n", (unsigned long)n, scene_err_name(err));
+        }
+    }
+    else if (strncmp(data, "list", 4) == 0)
+    {
+        for (uint32_t n = 0; n < SCENE_COUNT; n++)
+        {
+            const scene_t *s = scene_get(n);
+            if (s == NULL)
+            {
+                continue;
+            }
+            INFO_printf("Cena %lu %s:", (unsigned long)n, s->name);
+            for (int ch = 0; ch < SCENE_CHANNELS; ch++)
+            {
+                if (s->mask & (1u << ch))
+                {
+                    INFO_printf(" %c=%lu/%u.%u/%lu", pwm_suffix[ch], (unsigned long)s->ch[ch].freq_hz, s->ch[ch].duty_permille / 10,
+                                s->ch[ch].duty_permille % 10, (unsigned long)s->ch[ch].ramp_ms);
+                }
+            }
+            INFO_printf("\n");
+        }
+    }
+    else if (isdigit((unsigned char)data[0]))
+    {
+        recall_scene(strtoul(data, NULL, 10));
+    }
+    else
+    {
+        int n = scene_find(data);
+        if (n < 0)
+        {
+            ERROR_printf("Cena %s nao encontrada\n", data);
+            return;
+        }
+        recall_scene(n);
+    }
+}
+
+// Meia ponte: "freq_hz,tempo_morto_ns" usa as duas saídas do slice do canal como par
+// complementar; "off" volta ao modo normal. A saída complementar do canal azul é a do
+// vermelho (GPIO 13), que fica indisponível enquanto a meia ponte estiver ativa.
+static void handle_hbridge(uint ch, const char *data)
+{
+    uint freq, dead_ns;
+    if (strncmp(data, "off", 3) == 0)
+    {
+        hbridge_disable(ch);
+        release_channel(ch);
+        INFO_printf("Meia ponte do Led %s desligada\n", led_names[ch]);
+        return;
+    }
+    if (sscanf(data, "%u,%u", &freq, &dead_ns) != 2)
+    {
+        ERROR_printf("Formato invalido. Esperado freq_hz,tempo_morto_ns ou off\n");
+        return;
+    }
+
+    release_channel(ch);
+    uint comp_gpio = led_rgb[ch] ^ 1;
+    if (comp_gpio >= PWM_ARRAY_OFFSET && comp_gpio < PWM_ARRAY_OFFSET + RGB_LED_COUNT)
+    {
+        release_channel(comp_gpio - PWM_ARRAY_OFFSET);
+        hbridge_disable(comp_gpio - PWM_ARRAY_OFFSET);
+    }
+    if (!hbridge_configure(ch, led_rgb[ch], freq, dead_ns))
+    {
+        ERROR_printf("Meia ponte invalida (tempo morto ate %u ns e no maximo 1/4 do periodo)\n", HBRIDGE_DEAD_MAX_NS);
+        return;
+    }
+    const hbridge_t *h = hbridge_get(ch);
+    pwm_wraps[ch] = h->timing.top;
+    transfer_curve_build(&curves[ch], h->timing.top);
+    fpwm[ch] = freq;
+    show_configured(ch);
+    INFO_printf("Meia ponte no Led %s (GPIO %u/%u): %u Hz, tempo morto %u ticks\n", led_names[ch], led_rgb[ch], comp_gpio, freq,
+                h->dead_ticks);
+}
+
+// Falha segura do canal: "timeout_ms,duty_seguro_pct[,rampa_ms]" ou "off"
+static void handle_failsafe(uint ch, const char *data)
+{
+    uint timeout_ms, safe, ramp_ms = 0;
+    if (strncmp(data, "off", 3) == 0)
+    {
+        failsafe_configure(ch, led_rgb[ch], 0, 0, 0);
+        INFO_printf("Falha segura do Led %s desligada\n", led_names[ch]);
+    }
+    else if (sscanf(data, "%u,%u,%u", &timeout_ms, &safe, &ramp_ms) >= 2 && timeout_ms >= FAILSAFE_TICK_MS && safe <= 100)
+    {
+        failsafe_configure(ch, led_rgb[ch], timeout_ms, safe * 10, ramp_ms);
+        INFO_printf("Falha segura do Led %s: %u ms sem comandos, rampa de %u ms ate %u%%\n", led_names[ch], timeout_ms, ramp_ms, safe);
+    }
+    else
+    {
+        ERROR_printf("Formato invalido. Esperado timeout_ms,duty_pct[,rampa_ms] ou off\n");
+    }
+}
+
+// Medição: "gate_ms" mede o sinal no GPIO de entrada; "loop,canal[,gate_ms]" mede a saída de um
+// canal ligada por jumper ao GPIO de entrada e compara com fpwm[] e o duty programado
+static void handle_meas(const char *data)
+{
+    uint gate_ms = 100;
+    char c;
+
+    meas_loop_ch = -1;
+    if (strncmp(data, "loop,", 5) == 0 && sscanf(data + 5, "%c,%u", &c, &gate_ms) >= 1)
+    {
+        for (int i = 0; i < RGB_LED_COUNT; i++)
+        {
+            if (pwm_suffix[i] == c)
             {
-                ERROR_printf("Divisor invalido\n");
-                div = 255;
+                meas_loop_ch = i;
             }
-            else if (wrap > 65535)
+        }
+        if (meas_loop_ch < 0)
+        {
+            ERROR_printf("Canal invalido para loopback\n");
+            return;
+        }
+        meas_expected_hz = fpwm[meas_loop_ch];
+        meas_expected_duty_ppm = channel_duty_ppm(meas_loop_ch);
+    }
+    else if (data[0] != '\0')
+    {
+        gate_ms = strtoul(data, NULL, 10);
+    }
+
+    if (!pwm_meas_start(PWM_MEAS_DEFAULT_GPIO, gate_ms))
+    {
+        ERROR_printf("Medicao recusada (em andamento ou porta fora de %u-%u ms)\n", PWM_MEAS_GATE_MIN_MS, PWM_MEAS_GATE_MAX_MS);
+    }
+}
+
+// Forma de onda, com amostras em milésimos do período (0-1000):
+//   "sine,n,min,max" ou "trap,n,min,max" gera a tabela; "add,a0,a1,..." acrescenta amostras;
+//   "loop,taxa_hz[,a0,...]" ou "once,taxa_hz[,a0,...]" inicia (taxa 0 = uma amostra por período PWM);
+//   "clear" esvazia a tabela e "stop" interrompe a reprodução
+static void handle_pwm_wave(uint ch, char *data)
+{
+    char *cmd = data;
+    char *args = strchr(data, ',');
+    bool ok = true;
+
+    if (args)
+    {
+        *args++ = '\0';
+    }
+
+    if (strcmp(cmd, "stop") == 0)
+    {
+        pwm_wave_stop(ch);
+    }
+    else if (strcmp(cmd, "clear") == 0)
+    {
+        pwm_wave_stage_clear(ch);
+    }
+    else if (strcmp(cmd, "sine") == 0 || strcmp(cmd, "trap") == 0)
+    {
+        uint n, min, max;
+        ok = args && sscanf(args, "%u,%u,%u", &n, &min, &max) == 3 && max <= PWM_WAVE_FULL_SCALE &&
+             (cmd[0] == 's' ? pwm_wave_stage_sine(ch, n, min, max) : pwm_wave_stage_trapezoid(ch, n, min, max));
+    }
+    else if (strcmp(cmd, "add") == 0 || strcmp(cmd, "loop") == 0 || strcmp(cmd, "once") == 0)
+    {
+        bool start = cmd[0] != 'a';
+        uint rate_hz = 0;
+        if (start && (servo_get(ch)->enabled || hbridge_get(ch)->enabled))
+        {
+            ERROR_printf("Forma de onda nao permitida em modo servo ou meia ponte\n");
+            return;
+        }
+        char *p = args;
+        char *end;
+        if (start && p)
+        {
+            rate_hz = strtoul(p, &end, 10);
+            p = *end == ',' ? end + 1 : NULL;
+            if (p)
             {
-                ERROR_printf("Wrap invalido\n");
-                wrap = 65535;
+                pwm_wave_stage_clear(ch); // Amostras na própria mensagem substituem a tabela
             }
-            pwm_wraps[2] = wrap;
-            fpwm[2] = PICO_CLOCK_FREQ_HZ / (wrap * div);
-            setup_pwm(led_rgb[2], div); // Configura o pwm para o led verde
-            draw_sucess_screen(&ssd, 3);
-            INFO_printf("Configurou o pwm para div:%hhu wrap:%u\n", div, wrap);
-            INFO_printf("E frequência de:%u Hz\n", fpwm[2]);
         }
-        else
+        while (ok && p && *p)
+        {
+            uint sample = strtoul(p, &end, 10);
+            ok = end != p && pwm_wave_stage_append(ch, sample);
+            p = *end == ',' ? end + 1 : end;
+        }
+        int sibling = (led_rgb[ch] ^ 1) - PWM_ARRAY_OFFSET;
+        // As duas DMAs escreveriam a palavra CC inteira, cada uma com a metade antiga da outra
+        if (start && sibling >= 0 && sibling < RGB_LED_COUNT && (pwm_wave_active(sibling) || pwm_dither_active(sibling)))
+        {
+            ERROR_printf("Forma de onda nao permitida com forma de onda ou dithering no outro canal do slice\n");
+            return;
+        }
+        if (ok && start)
+        {
+            pid_loop_disable(ch);
+            pwm_dither_stop(ch);
+            thermal_loop_release(ch);
+            cmd_sched_cancel_channel(ch);
+            ok = pwm_wave_start(ch, led_rgb[ch], rate_hz, cmd[0] == 'l');
+        }
+    }
+    else
+    {
+        ok = false;
+    }
+
+    if (ok)
+    {
+        INFO_printf("Forma de onda do Led %s: %s, %lu amostras%s\n", led_names[ch], cmd,
+                    (unsigned long)pwm_wave_stage_count(ch), pwm_wave_active(ch) ? ", reproduzindo" : "");
+    }
+    else
+    {
+        ERROR_printf("Forma de onda invalida (tabela cheia, taxa acima do PWM ou formato errado)\n");
+    }
+}
+
+// Modo de medição de defasagem: responde com o relógio sincronizado no instante do recebimento.
+// Todos os dispositivos recebem o mesmo /skew quase ao mesmo tempo, então comparar os
+// t_rx publicados mostra a diferença entre os relógios da frota.
+static void publish_skew_report(MQTT_CLIENT_DATA_T *state, uint64_t rx_us)
+{
+    static char msg[160];
+    clock_sync_status_t cs;
+    unsigned long long ref_us = 0;
+
+    clock_sync_get_status(&cs);
+    sscanf(state->data, "%llu", &ref_us);
+    uint64_t t_rx = clock_sync_local_to_unix(rx_us);
+    int len = snprintf(msg, sizeof(msg), "id=%s t_rx=%llu ref=%llu off=%lld src=%d step=%lld drift_ppb=%ld age_ms=%llu",
+                       state->mqtt_client_info.client_id, (unsigned long long)t_rx, ref_us,
+                       ref_us ? (long long)(t_rx - ref_us) : 0LL, cs.source, (long long)cs.last_step_us, (long)cs.drift_ppb,
+                       (unsigned long long)((rx_us - cs.last_sync_us) / 1000));
+    mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_SKEW], msg, len, MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+}
+
+// Só registra falhas das assinaturas de grupo feitas em funcionamento (fora da contagem da conexão)
+static void group_request_cb(void *arg, err_t err)
+{
+    if (err != 0)
+    {
+        ERROR_printf("Assinatura de grupo falhou %d\n", err);
+    }
+}
+
+// Grupos: "add,nome" entra, "del,nome" sai, "clear" sai de todos, "list" mostra no terminal.
+// A lista fica na flash e a assinatura muda na hora se houver conexão.
+static void handle_group(MQTT_CLIENT_DATA_T *state, const char *data)
+{
+    bool connected = mqtt_client_is_connected(state->mqtt_client_inst);
+    if (strncmp(data, "add,", 4) == 0)
+    {
+        if (mqtt_group_member(data + 4, strlen(data + 4)))
+        {
+            return;
+        }
+        if (!mqtt_group_add(data + 4))
+        {
+            ERROR_printf("Grupo invalido ou lista cheia (%u grupos de ate %u caracteres: letras, digitos, - e _)\n",
+                         MQTT_GROUP_MAX, MQTT_GROUP_NAME_LEN - 1);
+            return;
+        }
+        if (connected)
         {
-            ERROR_printf("Formato invalido. Esperado div,wrap\n");
+            group_sub_unsub(state, data + 4, group_request_cb, true);
         }
+        INFO_printf("Entrou no grupo %s\n", data + 4);
     }
-    else if (strcmp(basic_topic, "/pwmg") == 0)
+    else if (strncmp(data, "del,", 4) == 0)
     {
-        // Espera o duty cyclo do pwm 1
-        uint duty;
-        if (sscanf(state->data, "%u", &duty) == 1)
+        if (!mqtt_group_remove(data + 4))
         {
-            draw_matrix_green(duty / DUTY_CYCLE_DIVISOR);
-            set_pwm_duty(led_rgb[0], duty);
-            draw_pwm_config(&ssd, fpwm[0], duty, 1);
-            INFO_printf("Ligou o Led Verde no valor de: %u%%\n", duty);
+            ERROR_printf("Grupo %s nao encontrado\n", data + 4);
+            return;
         }
-        else
+        if (connected)
         {
-            ERROR_printf("Erro formato invalido. Esperado 0-100\n");
+            group_sub_unsub(state, data + 4, group_request_cb, false);
         }
+        INFO_printf("Saiu do grupo %s\n", data + 4);
     }
-    else if (strcmp(basic_topic, "/pwmb") == 0)
+    else if (strncmp(data, "clear", 5) == 0)
     {
-        // Espera o duty cyclo do pwm 2
-        uint duty;
-        if (sscanf(state->data, "%u", &duty) == 1)
+        for (size_t i = 0; connected && i < mqtt_group_count(); i++)
         {
-            draw_matrix_blue(duty / DUTY_CYCLE_DIVISOR);
-            set_pwm_duty(led_rgb[1], duty);
-            draw_pwm_config(&ssd, fpwm[1], duty, 2);
-            INFO_printf("Ligou o Led AZUL no valor de: %u%%\n", duty);
+            group_sub_unsub(state, mqtt_group_name(i), group_request_cb, false);
         }
-        else
+        mqtt_group_clear();
+    }
+    else if (strncmp(data, "list", 4) == 0)
+    {
+        INFO_printf("Grupos:");
+        for (size_t i = 0; i < mqtt_group_count(); i++)
         {
-            ERROR_printf("Erro formato invalido. Esperado 0-100\n");
+            INFO_printf(" %s", mqtt_group_name(i));
         }
+        INFO_printf("\n");
+    }
+    else
+    {
+        ERROR_printf("Formato invalido. Esperado add,nome, del,nome, clear ou list\n");
     }
-    else if (strcmp(basic_topic, "/pwmr") == 0)
+}
+
+// Eco dos comandos tratados (/trace) e publicações do eco recusadas por falta de espaço
+static bool trace_applied;
+static uint32_t trace_dropped;
+
+// Tempo de tratamento dos comandos, do recebimento ao fim do tratador, por origem
+static lat_hist_t hist_mqtt;
+static lat_hist_t hist_usb;
+
+// Aplica um comando pelo tópico (sem o prefixo do dispositivo). Usado pelas mensagens MQTT
+// e pelo comando "cmd" do terminal USB.
+static void dispatch_command(MQTT_CLIENT_DATA_T *state, const char *basic_topic, char *data, uint64_t rx_us)
+{
+    int ch = -1;
+
+    // Qualquer mensagem de um canal rearma a falha segura dele antes de ser aplicada
+    for (int i = 0; i < count_of(channel_topics) && ch < 0; i++)
     {
-        // Espera o duty cyclo do pwm 3
-        uint duty;
-        if (sscanf(state->data, "%u", &duty) == 1)
+        if ((ch = topic_channel(basic_topic, channel_topics[i])) >= 0)
         {
-            draw_matrix_red(duty / DUTY_CYCLE_DIVISOR);
-            set_pwm_duty(led_rgb[2], duty);
-            draw_pwm_config(&ssd, fpwm[2], duty, 3);
-            INFO_printf("Ligou o Led Vermelho no valor de: %u%%\n", duty);
+            failsafe_feed(ch);
         }
-        else
+    }
+    if (ch >= 0 && hbridge_complement_owner(led_rgb[ch]) >= 0)
+    {
+        ERROR_printf("Led %s em uso como saida complementar de meia ponte\n", led_names[ch]);
+        return;
+    }
+
+    if (strcmp(basic_topic, "/exit") == 0)
+    {
+        state->stop_client = true;      // stop the client when ALL subscriptions are stopped
+        sub_unsub_topics(state, false); // unsubscribe
+    }
+    else if (strcmp(basic_topic, "/clock") == 0)
+    {
+        handle_clock(data);
+    }
+    else if (strcmp(basic_topic, "/ui") == 0)
+    {
+        handle_ui(data);
+    }
+    else if (strcmp(basic_topic, "/matrix") == 0)
+    {
+        handle_matrix(data);
+    }
+    else if (strcmp(basic_topic, "/scene") == 0)
+    {
+        handle_scene(data);
+    }
+    else if (strcmp(basic_topic, "/group") == 0)
+    {
+        handle_group(state, data);
+    }
+    else if (strcmp(basic_topic, "/link") == 0)
+    {
+        handle_link(state, data);
+    }
+    else if (strcmp(basic_topic, "/netmem") == 0)
+    {
+        if (strncmp(data, "reset", 5) == 0)
+        {
+            net_mem_reset_peaks();
+        }
+        publish_net_mem(state);
+    }
+    else if (strcmp(basic_topic, "/trace") == 0)
+    {
+        trace_applied = strncmp(data, "on", 2) == 0;
+        INFO_printf("Eco dos comandos %s\n", trace_applied ? "ligado" : "desligado");
+    }
+    else if (strcmp(basic_topic, "/hb") == 0)
+    {
+        failsafe_feed_all(); // Batimento do controlador: mantém todos os canais como estão
+    }
+    else if (strcmp(basic_topic, "/time") == 0)
+    {
+        // Referência de tempo publicada pelo broker, em us desde 1970
+        unsigned long long unix_us;
+        if (sscanf(data, "%llu", &unix_us) == 1)
+        {
+            clock_sync_beacon(unix_us);
+        }
+    }
+    else if (strcmp(basic_topic, "/skew") == 0)
+    {
+        publish_skew_report(state, rx_us);
+    }
+    else if ((ch = topic_channel(basic_topic, "/spwm")) >= 0)
+    {
+        handle_pwm_config(ch, data);
+    }
+    else if ((ch = topic_channel(basic_topic, "/pwm")) >= 0)
+    {
+        handle_pwm_duty(ch, data);
+    }
+    else if ((ch = topic_channel(basic_topic, "/wave")) >= 0)
+    {
+        handle_pwm_wave(ch, data);
+    }
+    else if ((ch = topic_channel(basic_topic, "/srvcfg")) >= 0)
+    {
+        handle_servo_config(ch, data);
+    }
+    else if ((ch = topic_channel(basic_topic, "/servo")) >= 0)
+    {
+        handle_servo_pulse(ch, data);
+    }
+    else if ((ch = topic_channel(basic_topic, "/pid")) >= 0)
+    {
+        handle_pid(state, ch, data);
+    }
+    else if (strcmp(basic_topic, "/meas") == 0)
+    {
+        handle_meas(data);
+    }
+    else if (strcmp(basic_topic, "/adc") == 0)
+    {
+        handle_adc_stream(state, data);
+    }
+    else if (strcmp(basic_topic, "/thermal") == 0)
+    {
+        handle_thermal(state, data);
+    }
+    else if ((ch = topic_channel(basic_topic, "/derate")) >= 0)
+    {
+        handle_derate_policy(ch, data);
+    }
+    else if ((ch = topic_channel(basic_topic, "/failsafe")) >= 0)
+    {
+        handle_failsafe(ch, data);
+    }
+    else if ((ch = topic_channel(basic_topic, "/hbridge")) >= 0)
+    {
+        handle_hbridge(ch, data);
+    }
+    else if ((ch = topic_channel(basic_topic, "/dither")) >= 0)
+    {
+        handle_dither(ch, data);
+    }
+    else if ((ch = topic_channel(basic_topic, "/curve")) >= 0)
+    {
+        handle_curve(ch, data);
+    }
+}
+
+// Dados de entrada MQTT
+static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
+    uint64_t rx_us = time_us_64();
+    bool shared;
+    const char *basic_topic = route_topic(state->topic, &shared);
+    // O lwIP entrega mensagens grandes em partes; junta até a última antes de tratar
+    u16_t copy = MIN(len, sizeof(state->data) - 1 - state->len);
+    memcpy(&state->data[state->len], data, copy);
+    state->len += copy;
+    state->data[state->len] = '\0';
+    if (!(flags & MQTT_DATA_FLAG_LAST))
+    {
+        return;
+    }
+
+    DEBUG_printf("Topic: %s, Message: %s\n", state->topic, state->data);
+    if (basic_topic == NULL)
+    {
+        return; // Grupo de que esta placa já saiu
+    }
+    if (shared && strcmp(basic_topic, "/group") == 0)
+    {
+        ERROR_printf("/group so pelo topico do dispositivo\n");
+        return;
+    }
+    // A mensagem é copiada antes: alguns tratadores alteram o texto ao interpretá-lo
+    char echo[MQTT_APPLIED_LEN];
+    int echo_len = trace_applied ? snprintf(echo, sizeof(echo), "%s %s", basic_topic, state->data) : 0;
+
+    dispatch_command(state, basic_topic, state->data, rx_us);
+    uint32_t us = (uint32_t)(time_us_64() - rx_us);
+    lat_hist_record(&hist_mqtt, us);
+
+    if (echo_len > 0 && echo_len < (int)sizeof(echo) - 12)
+    {
+        echo_len += snprintf(&echo[echo_len], sizeof(echo) - echo_len, " %lu", (unsigned long)us);
+        // QoS 0: sob carga o eco é o primeiro a ser descartado, e a perda aparece na medida
+        if (mqtt_publish(state->mqtt_client_inst, pub_topics[PUB_APPLIED], echo, echo_len, 0, 0, NULL, NULL) != ERR_OK)
         {
-            ERROR_printf("Erro formato invalido. Esperado 0-100\n");
+            trace_dropped++;
         }
     }
 }
@@ -555,7 +2688,8 @@ static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len
     // Safer approach:
     strncpy(state->topic, topic, sizeof(state->topic) - 1);
     state->topic[sizeof(state->topic) - 1] = '\0';
-    ;
+    state->len = 0; // Nova mensagem
+
 }
 
 // Conexão MQTT
@@ -564,7 +2698,14 @@ static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
     if (status == MQTT_CONNECT_ACCEPTED)
     {
+        boot_timeline_mark(BOOT_PHASE_CONNACK);
+        if (state->connect_done)
+        {
+            state->reconnects++;
+        }
         state->connect_done = true;
+        state->subscribe_count = 0;
+        adc_stream_in_flight = 0; // Publicações pendentes não sobrevivem à conexão anterior
         sub_unsub_topics(state, true); // subscribe;
 
         // indicate online
@@ -573,14 +2714,17 @@ static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection
             mqtt_publish(state->mqtt_client_inst, state->mqtt_client_info.will_topic, "1", 1, MQTT_WILL_QOS, true, pub_request_cb, state);
         }
 
+        publish_reboot_reason(state);
         INFO_printf("Connected to MQTT server\n");
     }
+    else if (state->connect_done)
+    {
+        // Queda ou reconexão recusada: o laço principal tenta de novo e a falha segura cuida dos canais
+        ERROR_printf("Conexao MQTT perdida (status %d)\n", status);
+    }
     else if (status == MQTT_CONNECT_DISCONNECTED)
     {
-        if (!state->connect_done)
-        {
-            panic("Failed to connect to mqtt server");
-        }
+        panic("Failed to connect to mqtt server");
     }
     else
     {
@@ -592,10 +2736,8 @@ static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection
 static void start_client(MQTT_CLIENT_DATA_T *state)
 {
 #if LWIP_ALTCP && LWIP_ALTCP_TLS
-    const int port = MQTT_TLS_PORT;
     INFO_printf("Using TLS\n");
 #else
-    const int port = MQTT_PORT;
     INFO_printf("Warning: Not using TLS\n");
 #endif
 
@@ -607,17 +2749,33 @@ static void start_client(MQTT_CLIENT_DATA_T *state)
     INFO_printf("IP address of this device %s\n", ipaddr_ntoa(&(netif_list->ip_addr)));
     INFO_printf("Connecting to mqtt server at %s\n", ipaddr_ntoa(&state->mqtt_server_address));
 
-    cyw43_arch_lwip_begin();
-    if (mqtt_client_connect(state->mqtt_client_inst, &state->mqtt_server_address, port, mqtt_connection_cb, state, &state->mqtt_client_info) != ERR_OK)
+    if (connect_client(state) != ERR_OK)
     {
         panic("MQTT broker connection error");
     }
+}
+
+// O lwIP limpa a instância a cada conexão, então os callbacks de entrada são refeitos aqui
+static err_t connect_client(MQTT_CLIENT_DATA_T *state)
+{
+#if LWIP_ALTCP && LWIP_ALTCP_TLS
+    const int port = MQTT_TLS_PORT;
+#else
+    const int port = MQTT_PORT;
+#endif
+
+    cyw43_arch_lwip_begin();
+    err_t err = mqtt_client_connect(state->mqtt_client_inst, &state->mqtt_server_address, port, mqtt_connection_cb, state, &state->mqtt_client_info);
+    if (err == ERR_OK)
+    {
 #if LWIP_ALTCP && LWIP_ALTCP_TLS
-    // This is important for MBEDTLS_SSL_SERVER_NAME_INDICATION
-    mbedtls_ssl_set_hostname(altcp_tls_context(state->mqtt_client_inst->conn), MQTT_SERVER);
+        // This is important for MBEDTLS_SSL_SERVER_NAME_INDICATION
+        mbedtls_ssl_set_hostname(altcp_tls_context(state->mqtt_client_inst->conn), MQTT_SERVER);
 #endif
-    mqtt_set_inpub_callback(state->mqtt_client_inst, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, state);
+        mqtt_set_inpub_callback(state->mqtt_client_inst, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, state);
+    }
     cyw43_arch_lwip_end();
+    return err;
 }
 
 // Call back com o resultado do DNS
@@ -626,6 +2784,7 @@ static void dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg)
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
     if (ipaddr)
     {
+        boot_timeline_mark(BOOT_PHASE_DNS);
         state->mqtt_server_address = *ipaddr;
         start_client(state);
     }
@@ -634,3 +2793,276 @@ static void dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg)
         panic("dns request failed");
     }
 }
+
+// Terminal de comandos na USB ===============================
+// As respostas usam printf direto: são a saída do comando, não registro de depuração
+
+// "cmd /pwmg 50": aplica um comando como se tivesse chegado pelo MQTT
+static bool shell_cmd(void *ctx, int argc, char **argv)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)ctx;
+    if (argc < 2 || argv[1][0] != '/')
+    {
+        printf("uso: cmd /topico [dados]\n");
+        return false;
+    }
+    static char empty[1];
+    uint64_t rx_us = time_us_64();
+    // Mesmo contexto dos callbacks do MQTT: os tratadores não rodam ao mesmo tempo
+    cyw43_arch_lwip_begin();
+    dispatch_command(state, argv[1], argc > 2 ? argv[2] : empty, rx_us);
+    uint32_t us = (uint32_t)(time_us_64() - rx_us);
+    lat_hist_record(&hist_usb, us);
+    cyw43_arch_lwip_end();
+    printf("tratado em %lu us\n", (unsigned long)us);
+    return true;
+}
+
+static bool copy_credential(char *dst, const char *src)
+{
+    if (strlen(src) >= CREDENTIAL_BUFFER_SIZE)
+    {
+        printf("credencial maior que %u caracteres\n", CREDENTIAL_BUFFER_SIZE - 1);
+        return false;
+    }
+    strcpy(dst, src);
+    return true;
+}
+
+// "wifi ssid senha": troca de rede sem reiniciar; se a nova associação não completar, o
+// laço principal reinicia pelo watchdog após WIFI_LINK_LOSS_REBOOT_MS
+static bool shell_wifi(void *ctx, int argc, char **argv)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)ctx;
+    if (argc != 3 || strlen(argv[1]) >= CREDENTIAL_BUFFER_SIZE || !copy_credential(WIFI_PASSWORD, argv[2]))
+    {
+        printf("uso: wifi ssid senha (ate %u caracteres)\n", CREDENTIAL_BUFFER_SIZE - 1);
+        return false;
+    }
+    copy_credential(WIFI_SSID, argv[1]);
+
+    cyw43_arch_lwip_begin();
+    mqtt_disconnect(state->mqtt_client_inst); // O laço principal reconecta quando o link voltar
+    cyw43_arch_lwip_end();
+    cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+    if (cyw43_arch_wifi_connect_async(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK))
+    {
+        printf("falha ao iniciar a associacao\n");
+        return false;
+    }
+    printf("associando a %s\n", WIFI_SSID);
+    return true;
+}
+
+// Endereço novo do broker: só então derruba a conexão, e o laço principal reconecta nele
+static void shell_dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
+    if (ipaddr == NULL)
+    {
+        ERROR_printf("DNS falhou para %s; broker anterior mantido\n", hostname);
+        return;
+    }
+    state->mqtt_server_address = *ipaddr;
+    mqtt_disconnect(state->mqtt_client_inst);
+    INFO_printf("Broker em %s; reconectando\n", ipaddr_ntoa(ipaddr));
+}
+
+// "mqtt servidor usuario senha": troca de broker ou de conta sem reiniciar
+static bool shell_mqtt(void *ctx, int argc, char **argv)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)ctx;
+    if (argc != 4 || strlen(argv[1]) >= CREDENTIAL_BUFFER_SIZE || strlen(argv[2]) >= CREDENTIAL_BUFFER_SIZE ||
+        strlen(argv[3]) >= CREDENTIAL_BUFFER_SIZE)
+    {
+        printf("uso: mqtt servidor usuario senha (ate %u caracteres)\n", CREDENTIAL_BUFFER_SIZE - 1);
+        return false;
+    }
+    // client_user e client_pass apontam para estes buffers: valem na próxima conexão
+    copy_credential(MQTT_SERVER, argv[1]);
+    copy_credential(MQTT_USERNAME, argv[2]);
+    copy_credential(MQTT_PASSWORD, argv[3]);
+
+    ip_addr_t addr;
+    cyw43_arch_lwip_begin();
+    err_t err = dns_gethostbyname(MQTT_SERVER, &addr, shell_dns_found, state);
+    if (err == ERR_OK)
+    {
+        shell_dns_found(MQTT_SERVER, &addr, state);
+    }
+    cyw43_arch_lwip_end();
+    if (err != ERR_OK && err != ERR_INPROGRESS)
+    {
+        printf("DNS falhou (%d)\n", err);
+        return false;
+    }
+    return true;
+}
+
+static bool shell_save(void *ctx, int argc, char **argv)
+{
+    if (!save_credentials())
+    {
+        printf("falha ao gravar a flash\n");
+        return false;
+    }
+    credentials_in_flash = true;
+    printf("credenciais gravadas; a inicializacao nao espera mais pelo terminal\n");
+    return true;
+}
+
+static bool shell_forget(void *ctx, int argc, char **argv)
+{
+    flash_store_erase(FLASH_STORE_SLOT_CREDENTIALS);
+    credentials_in_flash = false;
+    printf("credenciais apagadas; a proxima inicializacao volta a pedir pela USB\n");
+    return true;
+}
+
+static bool shell_net(void *ctx, int argc, char **argv)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)ctx;
+    int32_t rssi = 0;
+    cyw43_wifi_get_rssi(&cyw43_state, &rssi);
+
+    cyw43_arch_lwip_begin();
+    int link = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+    bool connected = mqtt_client_is_connected(state->mqtt_client_inst);
+    char ip[IPADDR_STRLEN_MAX], broker[IPADDR_STRLEN_MAX];
+    ipaddr_ntoa_r(&netif_list->ip_addr, ip, sizeof(ip));
+    ipaddr_ntoa_r(&state->mqtt_server_address, broker, sizeof(broker));
+    cyw43_arch_lwip_end();
+
+    printf("wifi: rede=%s link=%d rssi=%ld dBm ip=%s%s\n", WIFI_SSID, link, (long)rssi, ip,
+           wifi_conn_used_fast_path() ? " (fast join)" : "");
+    printf("mqtt: broker=%s (%s) usuario=%s conectado=%d reconexoes=%lu assinaturas=%d/%d\n", MQTT_SERVER, broker,
+           MQTT_USERNAME, connected, (unsigned long)state->reconnects, state->subscribe_count, state->subscribe_total);
+    printf("topicos: prefixo=%s grupos=", device_prefix_len ? device_prefix : "(nenhum)");
+    for (size_t i = 0; i < mqtt_group_count(); i++)
+    {
+        printf("%s%s", i ? "," : "", mqtt_group_name(i));
+    }
+    printf("\n");
+    return true;
+}
+
+static bool shell_stats(void *ctx, int argc, char **argv)
+{
+    ui_view_stats_t ui;
+    matrix_anim_stats_t mx;
+    pid_loop_stats_t pid;
+    adc_stream_stats_t adc;
+    usb_shell_stats_t sh;
+    link_mon_stats_t link;
+    ui_view_get_stats(&ui);
+    matrix_anim_get_stats(&mx);
+    pid_loop_get_stats(&pid);
+    adc_stream_get_stats(&adc);
+    usb_shell_get_stats(&sh);
+    link_mon_get_stats(&link);
+
+    printf("uptime: %lu ms, reinicio: %s (%lu seguidos)\n", (unsigned long)to_ms_since_boot(get_absolute_time()),
+           watchdog_sup_reason_name(watchdog_sup_reason()), (unsigned long)watchdog_sup_reboot_count());
+    printf("comandos: mqtt=%lu usb=%lu, eco %s (%lu perdidos)\n", (unsigned long)hist_mqtt.total,
+           (unsigned long)hist_usb.total, trace_applied ? "ligado" : "desligado", (unsigned long)trace_dropped);
+    printf("ui: %lu Hz, %lu mudancas, %lu quadros, desenho max %lu us\n", (unsigned long)ui.rate_hz,
+           (unsigned long)ui.updates, (unsigned long)ui.frames, (unsigned long)ui.render_max_us);
+    printf("matriz: %lu quadros/s, %lu quadros, %lu descartados, jitter max %ld us\n", (unsigned long)mx.fps,
+           (unsigned long)mx.frames, (unsigned long)mx.overruns, (long)mx.jitter_max_us);
+    printf("pid: %lu Hz, %lu ticks, %lu atrasos, exec max %lu us\n", (unsigned long)pid.rate_hz, (unsigned long)pid.ticks,
+           (unsigned long)pid.overruns, (unsigned long)pid.exec_max_us);
+    printf("adc: %lu blocos, %lu enviados, %lu perdidos\n", (unsigned long)adc.blocks, (unsigned long)adc.sent,
+           (unsigned long)adc.dropped);
+    printf("terminal: %lu linhas, %lu erros, %lu longas\n", (unsigned long)sh.lines, (unsigned long)sh.errors,
+           (unsigned long)sh.overflows);
+    printf("enlace: %s, rtt medio %lu ms (max %lu), rssi %ld dBm, %lu sondas, %lu sem resposta, %lu trocas\n",
+           link_mon_level_name(link.level), (unsigned long)link.rtt_avg_ms, (unsigned long)link.rtt_max_ms,
+           (long)link.rssi_dbm, (unsigned long)link.samples, (unsigned long)link.timeouts, (unsigned long)link.changes);
+    return true;
+}
+
+static void print_hist(const char *name, const lat_hist_t *h)
+{
+    printf("%s: n=%lu p50=%lu p99=%lu p999=%lu max=%lu us\n", name, (unsigned long)h->total,
+           (unsigned long)lat_hist_percentile(h, 500), (unsigned long)lat_hist_percentile(h, 990),
+           (unsigned long)lat_hist_percentile(h, 999), (unsigned long)h->max_us);
+    for (int b = 0; b < LAT_HIST_BUCKETS; b++)
+    {
+        if (h->count[b])
+        {
+            printf("  < %8lu us: %lu\n", (unsigned long)(2u << b), (unsigned long)h->count[b]);
+        }
+    }
+}
+
+// "hist" mostra o tempo de tratamento dos comandos por origem; "hist reset" zera
+static bool shell_hist(void *ctx, int argc, char **argv)
+{
+    static lat_hist_t mqtt, usb;
+    cyw43_arch_lwip_begin();
+    if (argc > 1 && strcmp(argv[1], "reset") == 0)
+    {
+        hist_mqtt = (lat_hist_t){0};
+        hist_usb = (lat_hist_t){0};
+    }
+    mqtt = hist_mqtt;
+    usb = hist_usb;
+    cyw43_arch_lwip_end();
+    print_hist("mqtt", &mqtt);
+    print_hist("usb", &usb);
+    return true;
+}
+
+// "mem" mostra heap e pools do lwIP: uso, pico, capacidade e falhas; "mem reset" recomeça os picos
+static bool shell_mem(void *ctx, int argc, char **argv)
+{
+    net_mem_pool_t pools[1 + MEMP_MAX];
+    size_t n = 0;
+    uint32_t tight;
+    cyw43_arch_lwip_begin();
+    if (argc > 1 && strcmp(argv[1], "reset") == 0)
+    {
+        net_mem_reset_peaks();
+    }
+    for (size_t i = 0; i < net_mem_count() && n < count_of(pools); i++)
+    {
+        n += net_mem_get(i, &pools[n]);
+    }
+    tight = net_mem_tight();
+    cyw43_arch_lwip_end();
+
+    printf("perfil %s, %lu sem folga (pico > %u%% ou falha)\n", net_mem_profile(), (unsigned long)tight,
+           NET_MEM_TIGHT_PERMILLE / 10);
+    for (size_t i = 0; i < n; i++)
+    {
+        printf("  %-16s uso %6lu pico %6lu de %6lu falhas %lu\n", pools[i].name, (unsigned long)pools[i].used,
+               (unsigned long)pools[i].max, (unsigned long)pools[i].avail, (unsigned long)pools[i].err);
+    }
+    return true;
+}
+
+// Marca de tempo para scripts no host correlacionarem com o que o dispositivo publica
+static bool shell_ping(void *ctx, int argc, char **argv)
+{
+    printf("t_us=%llu\n", (unsigned long long)time_us_64());
+    return true;
+}
+
+static const usb_shell_cmd_t shell_cmds[] = {
+    {"cmd", "/topico [dados]", "aplica um comando MQTT localmente", shell_cmd},
+    {"wifi", "ssid senha", "troca a rede Wi-Fi", shell_wifi},
+    {"mqtt", "servidor usuario senha", "troca o broker e a conta", shell_mqtt},
+    {"salvar", "", "grava as credenciais atuais na flash", shell_save},
+    {"esquecer", "", "apaga as credenciais da flash", shell_forget},
+    {"rede", "", "estado do Wi-Fi e do MQTT", shell_net},
+    {"stats", "", "contadores dos modulos", shell_stats},
+    {"hist", "[reset]", "tempo de tratamento dos comandos", shell_hist},
+    {"mem", "[reset]", "uso de memoria do lwIP", shell_mem},
+    {"ping", "", "instante atual em us desde o boot", shell_ping},
+};
+
+static void shell_start(MQTT_CLIENT_DATA_T *state)
+{
+    INFO_printf("Terminal USB pronto (ajuda lista os comandos)\n");
+    usb_shell_init(shell_cmds, count_of(shell_cmds), state);
+}
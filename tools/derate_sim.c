@@ -0,0 +1,183 @@
+// Simulação no host da redução térmica (lib/derate.c) com uma série de temperaturas injetada,
+// amostrada a 10 Hz e com o mesmo filtro do aparelho. A série aquece de 25 a 90 °C, fica
+// parada com ruído em torno de 70 °C e esfria. Confere:
+//   - fator 1000 abaixo de inicio_c, queda linear até o mínimo em total_c, sem subir enquanto aquece;
+//   - ruído de ±1,5 °C menor que a histerese não faz o fator oscilar: ele só relaxa até o ponto
+//     dado pelo vale do ruído filtrado e não volta a cair;
+//   - ao esfriar, o fator só volta a 1000 abaixo de inicio_c menos a histerese;
+//   - derate_apply é um teto: níveis abaixo de fator*(TOP+1) passam sem mudança;
+//   - no PID, o teto baixa o limite da saída e o integrador não acumula acima dele.
+//
+// Compilar e rodar: gcc -O2 -Ilib -o derate_sim tools/derate_sim.c lib/derate.c lib/pid_ctrl.c && ./derate_sim
+// Retorna 1 se alguma verificação falhar.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "derate.h"
+#include "pid_ctrl.h"
+
+#define SAMPLE_HZ 10
+#define FILTER_SHIFT 3 // THERMAL_LOOP_FILTER_SHIFT
+
+static uint32_t failures;
+static uint32_t rng = 12345;
+
+static void expect(bool ok, const char *what)
+{
+    printf("  %-64s %s\n", what, ok ? "ok" : "FALHA");
+    failures += !ok;
+}
+
+// Ruído uniforme em ±amp_mc
+static int32_t noise(int32_t amp_mc)
+{
+    rng = rng * 1103515245u + 12345u;
+    return (int32_t)((rng >> 8) % (2u * amp_mc + 1)) - amp_mc;
+}
+
+// Fator esperado sem histerese, para a temperatura filtrada
+static int32_t linear_factor(const derate_policy_t *p, int32_t t)
+{
+    if (t <= p->start_mc)
+    {
+        return DERATE_ONE;
+    }
+    if (t >= p->full_mc)
+    {
+        return p->floor;
+    }
+    return DERATE_ONE - (int32_t)(((int64_t)(DERATE_ONE - p->floor) * (t - p->start_mc)) / (p->full_mc - p->start_mc));
+}
+
+static void check_series(void)
+{
+    derate_t d;
+    char line[96];
+    derate_init(&d, FILTER_SHIFT);
+    const derate_policy_t *p = &d.policy[0];
+
+    // Aquecimento: 10 s a 25 °C e rampa até 90 °C em 60 s
+    bool rose = false, linear = true;
+    uint16_t prev = DERATE_ONE;
+    for (uint32_t i = 0; i < 70 * SAMPLE_HZ; i++)
+    {
+        int32_t t = i < 10 * SAMPLE_HZ ? 25000 : 25000 + (int32_t)((i - 10 * SAMPLE_HZ) * 65000 / (60 * SAMPLE_HZ));
+        derate_step(&d, t);
+        rose |= d.factor[0] > prev;
+        linear &= abs(d.factor[0] - linear_factor(p, derate_temp_mc(&d))) <= 1;
+        prev = d.factor[0];
+    }
+    printf("aquecimento 25 -> 90 C:\n");
+    expect(!rose && linear, "fator segue a reta da politica e nunca sobe");
+    for (uint32_t i = 0; i < 5 * SAMPLE_HZ; i++)
+    {
+        derate_step(&d, 90000);
+    }
+    snprintf(line, sizeof(line), "em 90 C: fator %u (minimo %u)", d.factor[0], p->floor);
+    expect(d.factor[0] == p->floor, line);
+
+    // Esfria até 70 °C e fica 60 s com ruído menor que a histerese
+    for (uint32_t i = 0; i < 20 * SAMPLE_HZ; i++)
+    {
+        derate_step(&d, 70000);
+    }
+    uint16_t settled = d.factor[0];
+    uint32_t drops = 0;
+    for (uint32_t i = 0; i < 60 * SAMPLE_HZ; i++)
+    {
+        prev = d.factor[0];
+        derate_step(&d, 70000 + noise(1500));
+        drops += d.factor[0] < prev;
+    }
+    printf("70 C com ruido de +-1,5 C por 60 s:\n");
+    snprintf(line, sizeof(line), "fator %u -> %u, %lu quedas", settled, d.factor[0], (unsigned long)drops);
+    expect(drops == 0 && d.factor[0] <= linear_factor(p, 70000 - 1500 + p->hyst_mc), line);
+
+    // Esfriamento lento até 50 °C: o fator só chega a 1000 abaixo de 57 °C (mais um milésimo
+    // do fator, perdido no arredondamento da reta)
+    int32_t released_at = 0;
+    for (uint32_t i = 0; i < 200 * SAMPLE_HZ && !released_at; i++)
+    {
+        derate_step(&d, 70000 - (int32_t)(i * 20000 / (200 * SAMPLE_HZ)));
+        if (d.factor[0] == DERATE_ONE)
+        {
+            released_at = derate_temp_mc(&d);
+        }
+    }
+    printf("esfriamento 70 -> 50 C:\n");
+    snprintf(line, sizeof(line), "fator volta a 1000 em %ld mC (limite %ld)", (long)released_at, (long)(p->start_mc - p->hyst_mc));
+    int32_t step_mc = (p->full_mc - p->start_mc) / (DERATE_ONE - p->floor);
+    expect(released_at != 0 && released_at <= p->start_mc - p->hyst_mc + step_mc, line);
+}
+
+static void check_apply(void)
+{
+    static const uint16_t tops[] = {0, 999, 4095, 65534};
+    static const uint16_t factors[] = {300, 500, 999, 1000};
+    bool ok = true;
+    for (uint32_t i = 0; i < sizeof(tops) / sizeof(tops[0]); i++)
+    {
+        for (uint32_t k = 0; k < sizeof(factors) / sizeof(factors[0]); k++)
+        {
+            uint32_t cap = ((tops[i] + 1u) * factors[k]) / DERATE_ONE;
+            for (uint32_t level = 0; level <= tops[i] + 1u; level++)
+            {
+                uint16_t out = derate_apply((uint16_t)level, factors[k], tops[i]);
+                ok &= out == (level < cap ? level : cap);
+            }
+        }
+    }
+    printf("derate_apply:\n");
+    expect(ok, "nivel abaixo do teto sem mudanca, acima dele igual ao teto");
+    expect(derate_apply(200, 500, 999) == 200 && derate_apply(1000, 500, 999) == 500, "20% com fator 50%: 20%; 100% com fator 50%: 50%");
+}
+
+// Planta estática (medição = 0,8 * saída) com o teto térmico em 50% e um setpoint de 80%
+static void check_pid(void)
+{
+    pid_ctrl_t pid;
+    char line[96];
+    pid_ctrl_init(&pid, PID_GAIN(0.2), PID_GAIN(50), 0, 0, PID_FULL_SCALE, 1000);
+    pid.out_max = ((PID_FULL_SCALE + 1) * 500) / DERATE_ONE;
+
+    int32_t y = 0, out = 0, peak = 0;
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        out = pid_ctrl_step(&pid, 3276, y);
+        peak = out > peak ? out : peak;
+        y = out * 4 / 5;
+    }
+    printf("PID com teto de 50%% por 5 s pedindo 80%%:\n");
+    snprintf(line, sizeof(line), "saida maxima %ld, teto %ld", (long)peak, (long)pid.out_max);
+    expect(peak <= pid.out_max && pid.integ <= ((int64_t)pid.out_max << PID_Q) * pid.rate_hz, line);
+
+    // Teto removido e setpoint de 30%: sem integrador acumulado acima do teto, a saída não passa
+    // dele ao voltar
+    pid.out_max = PID_FULL_SCALE;
+    peak = 0;
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        out = pid_ctrl_step(&pid, 1228, y);
+        peak = out > peak ? out : peak;
+        y = out * 4 / 5;
+    }
+    snprintf(line, sizeof(line), "depois: setpoint 1228, medicao %ld, saida maxima %ld", (long)y, (long)peak);
+    expect(abs(y - 1228) <= 1 && peak <= 2048, line);
+}
+
+int main(void)
+{
+    char line[96];
+    // 0,706 V no sensor = 27 °C
+    int32_t t27 = derate_adc_to_mc((uint16_t)(706 * 4096 / 3300));
+    snprintf(line, sizeof(line), "sensor: 0,706 V -> %ld mC", (long)t27);
+    expect(abs(t27 - 27000) <= 500, line);
+
+    check_series();
+    check_apply();
+    check_pid();
+    printf("%s\n", failures ? "FALHOU" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+// Análise no host do dithering sigma-delta (lib/sigma_delta.c).
+// Para cada TOP e duty pedido mostra o duty médio obtido com e sem dithering e a ondulação
+// depois de um filtro passa-baixa de 1ª ordem (LED ou RC na saída), comparando a sequência
+// sigma-delta com a mesma quantidade de períodos altos agrupados no início da sequência.
+//
+// Compilar e rodar: gcc -O2 -Ilib -o dither_analysis tools/dither_analysis.c lib/sigma_delta.c && ./dither_analysis [len] [tau]
+//   len: períodos por sequência (padrão 256); tau: constante do filtro em períodos PWM (padrão 32)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "sigma_delta.h"
+
+#define MAX_LEN 4096
+#define REPEATS 16 // Repetições simuladas; só a última entra na medida da ondulação
+
+static uint16_t levels[MAX_LEN];
+static uint16_t grouped[MAX_LEN];
+
+// Ondulação pico a pico, em % do fundo de escala, na última repetição da sequência filtrada
+static double ripple(const uint16_t *seq, uint32_t len, uint16_t top, double tau)
+{
+    double a = 1.0 / tau;
+    double y = (double)seq[0] / (top + 1);
+    double lo = 1.0, hi = 0.0;
+    for (uint32_t r = 0; r < REPEATS; r++)
+    {
+        for (uint32_t i = 0; i < len; i++)
+        {
+            y += a * ((double)seq[i] / (top + 1) - y);
+            if (r == REPEATS - 1)
+            {
+                lo = y < lo ? y : lo;
+                hi = y > hi ? y : hi;
+            }
+        }
+    }
+    return (hi - lo) * 100.0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t len = argc > 1 ? strtoul(argv[1], NULL, 10) : 256;
+    double tau = argc > 2 ? atof(argv[2]) : 32.0;
+    static const uint16_t tops[] = {1, 3, 9, 99, 999};
+    static const double duties[] = {0.1, 1.0, 12.5, 33.333, 50.0, 66.667, 99.9};
+
+    if (len < 1 || len > MAX_LEN || tau < 1.0)
+    {
+        fprintf(stderr, "len 1-%u, tau >= 1\n", MAX_LEN);
+        return 1;
+    }
+
+    printf("sequencia de %u periodos, filtro com tau = %.0f periodos\n", len, tau);
+    printf("%5s %6s %9s %10s %10s %10s %10s %10s\n", "top", "bits", "pedido%", "sem_dith%", "com_dith%", "erro_ppm", "ond_sd%",
+           "ond_agr%");
+    for (size_t t = 0; t < sizeof(tops) / sizeof(tops[0]); t++)
+    {
+        uint16_t top = tops[t];
+        uint32_t bits = sigma_delta_bits_x100(top, len);
+        for (size_t d = 0; d < sizeof(duties) / sizeof(duties[0]); d++)
+        {
+            uint32_t q16 = (uint32_t)(duties[d] / 100.0 * SIGMA_DELTA_ONE + 0.5);
+            uint32_t sum = sigma_delta_fill(top, q16, levels, len);
+            double avg = 100.0 * sum / ((double)len * (top + 1));
+
+            // Sem dithering: o mesmo nível em todos os períodos (o arredondamento de set_pwm_duty)
+            uint32_t plain = (uint32_t)((uint64_t)q16 * (top + 1) / SIGMA_DELTA_ONE);
+            double plain_avg = 100.0 * plain / (top + 1);
+
+            // Mesmos períodos com nível + 1, mas agrupados: mesma média, ondulação de baixa frequência
+            uint32_t extra = sum - plain * len;
+            for (uint32_t i = 0; i < len; i++)
+            {
+                grouped[i] = (uint16_t)(plain + (i < extra ? 1 : 0));
+            }
+
+            printf("%5u %3u.%02u %9.3f %10.3f %10.4f %10.0f %10.4f %10.4f\n", top, bits / 100, bits % 100, duties[d], plain_avg,
+                   avg, (avg - duties[d]) * 1e4, ripple(levels, len, top, tau), ripple(grouped, len, top, tau));
+        }
+    }
+    return 0;
+}
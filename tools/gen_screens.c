@@ -0,0 +1,340 @@
+// Gerador das telas estáticas do display (lib/ssd1306_templates.h).
+// Desenha bordas, linhas e textos fixos de cada tela com as mesmas rotinas de lib/ssd1306.c e a
+// fonte de lib/font.h, e grava o buffer resultante (formato de páginas do SSD1306, coluna a
+// coluna, como em ssd1306_pixel) como tabela constante. No aparelho a tela vira um memcpy e só
+// os campos dinâmicos são desenhados por cima.
+//
+// Gerar:  gcc -O2 -Ilib -o gen_screens tools/gen_screens.c && ./gen_screens > lib/ssd1306_templates.h
+// Conferir e medir: ./gen_screens --bench (compara pixel a pixel com o desenho completo e mostra o
+// custo de cada tela antes e depois; no host, o RP2040 é bem mais lento nos dois casos)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "font.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+#define BUF_SIZE (WIDTH * HEIGHT / 8)
+
+static uint8_t buf[BUF_SIZE];
+
+// Rotinas de desenho de lib/ssd1306.c, sobre um buffer sem o byte de controle ===============================
+static void pixel(uint8_t x, uint8_t y, bool value)
+{
+    uint16_t index = (y >> 3) + (x << 3);
+    uint8_t bit = y & 0b111;
+    if (value)
+        buf[index] |= (1 << bit);
+    else
+        buf[index] &= ~(1 << bit);
+}
+
+static void fill(bool value)
+{
+    for (uint8_t y = 0; y < HEIGHT; ++y)
+        for (uint8_t x = 0; x < WIDTH; ++x)
+            pixel(x, y, value);
+}
+
+static void rect(uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool filled)
+{
+    for (uint8_t x = left; x < left + width; ++x)
+    {
+        pixel(x, top, value);
+        pixel(x, top + height - 1, value);
+    }
+    for (uint8_t y = top; y < top + height; ++y)
+    {
+        pixel(left, y, value);
+        pixel(left + width - 1, y, value);
+    }
+    if (filled)
+        for (uint8_t x = left + 1; x < left + width - 1; ++x)
+            for (uint8_t y = top + 1; y < top + height - 1; ++y)
+                pixel(x, y, value);
+}
+
+static void line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value)
+{
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+    int err = dx - dy;
+    while (true)
+    {
+        pixel(x0, y0, value);
+        if (x0 == x1 && y0 == y1)
+            break;
+        int e2 = err * 2;
+        if (e2 > -dy)
+        {
+            err -= dy;
+            x0 += sx;
+        }
+        if (e2 < dx)
+        {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+static void draw_char(char c, uint8_t x, uint8_t y)
+{
+    uint16_t index = (c >= ' ' && c <= '~') ? (c - ' ') * 8 : 0;
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        uint8_t l = font[index + i];
+        for (uint8_t j = 0; j < 8; ++j)
+            pixel(x + i, y + j, l & (1 << j));
+    }
+}
+
+static void draw_string(const char *str, uint8_t x, uint8_t y)
+{
+    while (*str)
+    {
+        draw_char(*str++, x, y);
+        x += 8;
+        if (x + 8 >= WIDTH)
+        {
+            x = 0;
+            y += 8;
+        }
+        if (y + 8 >= HEIGHT)
+            break;
+    }
+}
+
+// Moldura com a linha do título, comum a todas as telas
+static void frame(void)
+{
+    fill(0);
+    rect(0, 0, WIDTH, HEIGHT, 1, 0);
+    line(1, 14, 126, 14, 1);
+}
+
+// Partes fixas de cada tela (o mesmo que as funções draw_* desenhavam) ===============================
+static void tpl_opening(void)
+{
+    frame();
+    draw_string("Conf. PWM", 26, 3);
+    draw_string("Ajuste div", 13, 18);
+    draw_string("e wrap", 60, 28);
+    draw_string("Formato", 11, 38);
+    draw_string("(div,wrap)", 22, 48);
+}
+
+static void tpl_usb(void)
+{
+    frame();
+    draw_string("Conf. Usb", 26, 3);
+    draw_string("Entre no", 13, 30);
+    draw_string("Terminal", 45, 40);
+}
+
+static void tpl_success(void)
+{
+    frame();
+    draw_string("Pwm ", 41, 3);
+    draw_string("Iniciado com", 13, 28);
+    draw_string("Sucesso", 35, 38);
+}
+
+static void tpl_pwm_config(void)
+{
+    frame();
+    line(1, 32, 126, 32, 1);
+    draw_string("Motor ", 27, 3);
+    draw_string("Fpwm: ", 5, 19);
+    draw_string("Duty Cycle:", 12, 35);
+    line(12, 45, 114, 45, 1);
+    line(12, 51, 114, 51, 1);
+    line(11, 46, 11, 50, 1);
+    line(115, 46, 115, 50, 1);
+}
+
+typedef struct
+{
+    const char *name;
+    void (*draw)(void);
+} tpl_t;
+
+static const tpl_t templates[] = {
+    {"opening", tpl_opening},
+    {"usb", tpl_usb},
+    {"success", tpl_success},
+    {"pwm_config", tpl_pwm_config},
+};
+#define TPL_COUNT (sizeof(templates) / sizeof(templates[0]))
+
+static void emit(void)
+{
+    printf("// Gerado por tools/gen_screens.c a partir de lib/font.h; não editar à mão.\n");
+    printf("// Buffers das partes fixas de cada tela, no formato de ssd1306_pixel (8 páginas por coluna).\n\n");
+    printf("#ifndef SSD1306_TEMPLATES_H\n#define SSD1306_TEMPLATES_H\n\n#include <stdint.h>\n\n");
+    printf("#define SSD1306_TEMPLATE_SIZE %d\n", BUF_SIZE);
+    for (size_t t = 0; t < TPL_COUNT; t++)
+    {
+        templates[t].draw();
+        printf("\nstatic const uint8_t ssd1306_tpl_%s[SSD1306_TEMPLATE_SIZE] = {", templates[t].name);
+        for (int i = 0; i < BUF_SIZE; i++)
+        {
+            printf("%s0x%02X,", i % 16 ? " " : "\n    ", buf[i]);
+        }
+        printf("\n};\n");
+    }
+    printf("\n#endif\n");
+}
+
+// Comparação com o desenho completo e medida de custo ===============================
+static uint8_t tpl_buf[TPL_COUNT][BUF_SIZE];
+
+// Barra do duty escrita por máscara de página, como em lib/ssd1306.c
+static void bar(uint8_t x0, uint8_t width, uint8_t y0, uint8_t height)
+{
+    for (uint8_t y = y0; y < y0 + height;)
+    {
+        uint8_t page = y >> 3;
+        uint8_t last = (y | 7) < y0 + height - 1 ? (y | 7) : y0 + height - 1;
+        uint8_t mask = (uint8_t)((0xFF << (y & 7)) & (0xFF >> (7 - (last & 7))));
+        for (uint8_t x = x0; x < x0 + width; x++)
+            buf[page + (x << 3)] |= mask;
+        y = last + 1;
+    }
+}
+
+static void full_pwm_config(uint32_t fpwm, uint8_t duty, uint8_t motor)
+{
+    char s[24];
+    tpl_pwm_config();
+    snprintf(s, sizeof(s), "%u", motor);
+    draw_string(s, 75, 3);
+    snprintf(s, sizeof(s), "%u", fpwm);
+    draw_string(s, 53, 19);
+    rect(47, 13, duty, 3, 1, 1);
+    snprintf(s, sizeof(s), "%u%%", duty);
+    draw_string(s, 45, 54);
+}
+
+static void fast_pwm_config(uint32_t fpwm, uint8_t duty, uint8_t motor)
+{
+    char s[24];
+    memcpy(buf, tpl_buf[3], BUF_SIZE);
+    snprintf(s, sizeof(s), "%u", motor);
+    draw_string(s, 75, 3);
+    snprintf(s, sizeof(s), "%u", fpwm);
+    draw_string(s, 53, 19);
+    bar(13, duty, 47, 3);
+    snprintf(s, sizeof(s), "%u%%", duty);
+    draw_string(s, 45, 54);
+}
+
+static void full_success(uint8_t pwm)
+{
+    char s[8];
+    tpl_success();
+    snprintf(s, sizeof(s), "%u", pwm);
+    draw_string(s, 73, 3);
+}
+
+static void fast_success(uint8_t pwm)
+{
+    char s[8];
+    memcpy(buf, tpl_buf[2], BUF_SIZE);
+    snprintf(s, sizeof(s), "%u", pwm);
+    draw_string(s, 73, 3);
+}
+
+static void fast_static(size_t t)
+{
+    memcpy(buf, tpl_buf[t], BUF_SIZE);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define ROUNDS 20000
+
+static int bench(void)
+{
+    static uint8_t ref[BUF_SIZE];
+    volatile uint8_t sink = 0;
+    int diffs = 0;
+
+    for (size_t t = 0; t < TPL_COUNT; t++)
+    {
+        templates[t].draw();
+        memcpy(tpl_buf[t], buf, BUF_SIZE);
+    }
+
+    // Pixel a pixel: duty de 1 a 100 (com 0 o desenho antigo deixava um traço de 2 pixels), vários fpwm
+    static const uint32_t freqs[] = {1, 9999, 1000000, 62500000, 4294967295u};
+    for (uint32_t d = 1; d <= 100; d++)
+    {
+        for (size_t f = 0; f < sizeof(freqs) / sizeof(freqs[0]); f++)
+        {
+            full_pwm_config(freqs[f], d, 1 + d % 3);
+            memcpy(ref, buf, BUF_SIZE);
+            fast_pwm_config(freqs[f], d, 1 + d % 3);
+            diffs += memcmp(ref, buf, BUF_SIZE) != 0;
+        }
+    }
+    for (uint8_t p = 1; p <= 3; p++)
+    {
+        full_success(p);
+        memcpy(ref, buf, BUF_SIZE);
+        fast_success(p);
+        diffs += memcmp(ref, buf, BUF_SIZE) != 0;
+    }
+    printf("telas diferentes do desenho completo: %d\n", diffs);
+
+    printf("%-12s %14s %14s %8s\n", "tela", "antes (ns)", "depois (ns)", "ganho");
+    for (size_t t = 0; t < TPL_COUNT; t++)
+    {
+        double t0 = now_ns();
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            if (t == 3)
+                full_pwm_config(1000000 + r, r % 101, 1);
+            else if (t == 2)
+                full_success(1 + r % 3);
+            else
+                templates[t].draw();
+            sink += buf[r % BUF_SIZE];
+        }
+        double t1 = now_ns();
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            if (t == 3)
+                fast_pwm_config(1000000 + r, r % 101, 1);
+            else if (t == 2)
+                fast_success(1 + r % 3);
+            else
+                fast_static(t);
+            sink += buf[r % BUF_SIZE];
+        }
+        double t2 = now_ns();
+        printf("%-12s %14.0f %14.0f %7.1fx\n", templates[t].name, (t1 - t0) / ROUNDS, (t2 - t1) / ROUNDS, (t1 - t0) / (t2 - t1));
+    }
+    return diffs ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+    {
+        return bench();
+    }
+    emit();
+    return 0;
+}
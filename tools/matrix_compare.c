@@ -0,0 +1,162 @@
+// Comparação no host do framebuffer da matriz (lib/led_matrix.c) com o caminho antigo de
+// lib/ws2812.h (desenhaMatriz com float e convert com a matriz intermediária de int).
+// Confere pixel a pixel quadros aleatórios e mede o custo de cada caminho por quadro.
+//
+// Compilar e rodar: gcc -O2 -Ilib -o matrix_compare tools/matrix_compare.c lib/led_matrix.c -lm && ./matrix_compare
+// O host tem FPU; no RP2040 (Cortex-M0+, float por software) a diferença é bem maior.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+#include "led_matrix.h"
+
+#define FRAMES 2000
+#define BENCH_ROUNDS 200000
+
+static pixel_t leds[LED_MATRIX_COUNT];
+
+// Caminho antigo, copiado de lib/ws2812.h (sem o envio para a PIO) ===============================
+static void npSetLED(const unsigned index, const uint8_t r, const uint8_t g, const uint8_t b)
+{
+    leds[index].R = r;
+    leds[index].G = g;
+    leds[index].B = b;
+}
+
+static int getIndex(int x, int y)
+{
+    if (y % 2 == 0)
+    {
+        return 24 - (y * 5 + x);
+    }
+    else
+    {
+        return 24 - (y * 5 + (4 - x));
+    }
+}
+
+static void desenhaMatriz(int matriz[5][5][3])
+{
+    float intensidade = 0.01;
+    for (int linha = 0; linha < 5; linha++)
+    {
+        for (int coluna = 0; coluna < 5; coluna++)
+        {
+            int posicao = getIndex(linha, coluna);
+            npSetLED(posicao, ((float)matriz[coluna][linha][0] * intensidade), ((float)matriz[coluna][linha][1] * intensidade), ((float)matriz[coluna][linha][2] * intensidade));
+        }
+    }
+}
+
+static void convertToRGB(int argb, int *rgb)
+{
+    rgb[0] = argb & 0xFF;
+    rgb[1] = (argb >> 16) & 0xFF;
+    rgb[2] = (argb >> 8) & 0xFF;
+}
+
+static void convert(uint32_t matrix[25])
+{
+    int rgb_matrix[5][5][3];
+    int rgb[3];
+    for (int i = 0; i < 25; i++)
+    {
+        convertToRGB(matrix[i], rgb);
+        rgb_matrix[i / 5][i % 5][0] = rgb[0];
+        rgb_matrix[i / 5][i % 5][1] = rgb[1];
+        rgb_matrix[i / 5][i % 5][2] = rgb[2];
+    }
+    desenhaMatriz(rgb_matrix);
+}
+// Fim do caminho antigo ===============================
+
+static uint64_t now_ticks(void)
+{
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+int main(void)
+{
+    static uint32_t frames[FRAMES][LED_MATRIX_COUNT];
+    static int rgb_frames[FRAMES][5][5][3];
+    pixel_t ref[LED_MATRIX_COUNT];
+    uint32_t mismatch_rgb = 0, mismatch_argb = 0;
+
+    srand(1234);
+    for (int f = 0; f < FRAMES; f++)
+    {
+        for (int i = 0; i < LED_MATRIX_COUNT; i++)
+        {
+            frames[f][i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+            for (int k = 0; k < 3; k++)
+            {
+                rgb_frames[f][i / 5][i % 5][k] = rand() & 0xFF;
+            }
+        }
+    }
+    // Todos os valores de componente pelo menos uma vez
+    for (int v = 0; v < 256; v++)
+    {
+        frames[0][v % LED_MATRIX_COUNT] = v * 0x010101u;
+    }
+
+    led_matrix_set_brightness(LED_MATRIX_DEFAULT_BRIGHTNESS, 1000);
+    for (int f = 0; f < FRAMES; f++)
+    {
+        desenhaMatriz(rgb_frames[f]);
+        memcpy(ref, leds, sizeof(ref));
+        led_matrix_draw_rgb(leds, (const int (*)[5][3])rgb_frames[f]);
+        mismatch_rgb += memcmp(ref, leds, sizeof(ref)) != 0;
+
+        // O convertToRGB antigo troca os componentes (R do LED recebe o azul, G o vermelho e B o verde);
+        // a nova API usa R, G e B do ARGB. A comparação desfaz a troca para conferir posição e brilho.
+        convert(frames[f]);
+        memcpy(ref, leds, sizeof(ref));
+        led_matrix_draw_argb(leds, frames[f]);
+        for (int i = 0; i < LED_MATRIX_COUNT; i++)
+        {
+            if (ref[i].R != leds[i].B || ref[i].G != leds[i].R || ref[i].B != leds[i].G)
+            {
+                mismatch_argb++;
+                break;
+            }
+        }
+    }
+    printf("quadros: %d; diferentes rgb: %u; diferentes argb (com a troca antiga desfeita): %u\n", FRAMES, mismatch_rgb,
+           mismatch_argb);
+
+    volatile uint32_t sink = 0;
+    uint64_t t0 = now_ticks();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        convert(frames[r % FRAMES]);
+        sink += leds[r % LED_MATRIX_COUNT].R;
+    }
+    uint64_t t1 = now_ticks();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        led_matrix_draw_argb(leds, frames[r % FRAMES]);
+        sink += leds[r % LED_MATRIX_COUNT].R;
+    }
+    uint64_t t2 = now_ticks();
+#ifdef HAVE_TSC
+    const char *unit = "ciclos TSC";
+#else
+    const char *unit = "ns";
+#endif
+    printf("convert antigo: %.1f %s/quadro; led_matrix_draw_argb: %.1f %s/quadro (%.1fx)\n", (double)(t1 - t0) / BENCH_ROUNDS,
+           unit, (double)(t2 - t1) / BENCH_ROUNDS, unit, (double)(t1 - t0) / (double)(t2 - t1));
+    return (mismatch_rgb || mismatch_argb) ? 1 : 0;
+}
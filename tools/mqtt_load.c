@@ -0,0 +1,657 @@
+// Gerador de carga MQTT e repetição de traces contra a placa ou um firmware simulado no host.
+// Publica comandos nos tópicos /pwm* e /spwm* na taxa e com o número de conexões pedidos e
+// casa cada comando com o eco publicado pela placa em /applied (ligado com /trace on), medindo
+// a latência de ponta a ponta (p50/p99/p999) e a taxa de perda.
+//
+// Compilar: gcc -O2 -o mqtt_load tools/mqtt_load.c
+//
+//   ./mqtt_load run [-h broker] [-p porta] [-u usuario] [-k senha] [-P prefixo] [-r cmds/s]
+//                   [-c conexoes] [-n comandos] [-f trace] [-s velocidade] [-w espera_ms] [-S]
+//   ./mqtt_load sim [-h broker] [-p porta] [-u usuario] [-k senha] [-P prefixo] [-d us_por_comando]
+//   ./mqtt_load record [-h broker] [-p porta] [-u usuario] [-k senha] [-P prefixo] > trace.txt
+//
+// -u e -k: usuário e senha do CONNECT, para o mesmo broker com autenticação em que a placa
+//          entra com MQTT_USERNAME e MQTT_PASSWORD.
+// run:    sem -f gera um trace sintético (duty de 0 a 100 em rodízio pelos três canais e, com -S,
+//         um /spwm a cada 16 comandos); com -f repete o arquivo nos instantes gravados, com
+//         -s multiplicando a velocidade. Os comandos são distribuídos em rodízio entre as
+//         conexões, como vários painéis abertos ao mesmo tempo.
+// sim:    firmware simulado: assina os comandos, confere o formato como a placa, espera o tempo
+//         de tratamento pedido e publica o mesmo eco em /applied.
+// record: grava os comandos /pwm* e /spwm* vistos no broker (por exemplo durante o uso real de
+//         um painel) no formato de trace: "ms tópico mensagem" por linha, tópico sem o prefixo.
+//
+// O prefixo é o "/<client_id>" da placa quando compilada com MQTT_UNIQUE_TOPIC (vazio por padrão).
+// O casamento é pelo par tópico e mensagem, do comando pendente mais antigo para o mais novo:
+// com uma conexão a ordem é preservada pelo broker e o casamento é exato; com várias, comandos
+// idênticos em conexões diferentes podem trocar de lugar, o que só embaralha latências parecidas.
+// Comando sem eco dentro da espera (-w) conta como perda e deixa de ser candidato antes de cada
+// casamento, para que o seu eco atrasado não seja atribuído a um comando mais novo; um eco que
+// não encontra comando pendente conta como atrasado.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define MAX_CONNS 64
+#define MAX_TOPIC 64
+#define MAX_PAYLOAD 64
+#define RX_BUF 8192
+
+typedef struct
+{
+    int fd;
+    uint8_t rx[RX_BUF];
+    size_t rx_len;
+} conn_t;
+
+typedef struct
+{
+    uint32_t t_ms;  // Instante relativo ao início do trace
+    char topic[MAX_TOPIC];
+    char payload[MAX_PAYLOAD];
+    uint64_t sent_us;
+    bool done;
+} cmd_t;
+
+static const char *host = "127.0.0.1";
+static const char *port = "1883";
+static const char *prefix = "";
+static const char *username; // Sem -u/-k o CONNECT vai sem usuário e senha
+static const char *password;
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Protocolo MQTT 3.1.1, só o necessário: CONNECT, SUBSCRIBE e PUBLISH com QoS 0 ===============================
+static size_t put_len(uint8_t *p, size_t len)
+{
+    size_t n = 0;
+    do
+    {
+        uint8_t b = len % 128;
+        len /= 128;
+        p[n++] = b | (len ? 0x80 : 0);
+    } while (len);
+    return n;
+}
+
+static size_t put_str(uint8_t *p, const char *s, size_t len)
+{
+    p[0] = len >> 8;
+    p[1] = len & 0xFF;
+    memcpy(&p[2], s, len);
+    return len + 2;
+}
+
+static bool send_all(int fd, const uint8_t *p, size_t len)
+{
+    while (len)
+    {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n <= 0)
+        {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+static bool send_packet(int fd, uint8_t type, const uint8_t *body, size_t len)
+{
+    uint8_t pkt[5 + 2 * MAX_TOPIC + MAX_PAYLOAD + 16];
+    pkt[0] = type;
+    size_t h = 1 + put_len(&pkt[1], len);
+    memcpy(&pkt[h], body, len);
+    return send_all(fd, pkt, h + len);
+}
+
+static bool mqtt_publish(conn_t *c, const char *topic, const char *payload, size_t len)
+{
+    uint8_t body[2 + 2 * MAX_TOPIC + MAX_PAYLOAD];
+    size_t n = put_str(body, topic, strlen(topic));
+    memcpy(&body[n], payload, len);
+    return send_packet(c->fd, 0x30, body, n + len);
+}
+
+static bool mqtt_subscribe(conn_t *c, const char *filter)
+{
+    static uint16_t id;
+    uint8_t body[5 + 2 * MAX_TOPIC];
+    id++;
+    body[0] = id >> 8;
+    body[1] = id & 0xFF;
+    size_t n = 2 + put_str(&body[2], filter, strlen(filter));
+    body[n++] = 0; // QoS 0
+    return send_packet(c->fd, 0x82, body, n);
+}
+
+static bool mqtt_connect(conn_t *c, const char *client_id)
+{
+    // No MQTT 3.1.1 a senha só vai junto com um usuário
+    if ((password && !username) || (username && strlen(username) >= MAX_TOPIC) || (password && strlen(password) >= MAX_TOPIC))
+    {
+        fprintf(stderr, "Usuario e senha: -k exige -u, ate %d caracteres cada\n", MAX_TOPIC - 1);
+        return false;
+    }
+    struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM};
+    struct addrinfo *res;
+    if (getaddrinfo(host, port, &hints, &res) != 0)
+    {
+        fprintf(stderr, "Broker %s nao encontrado\n", host);
+        return false;
+    }
+    c->fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (c->fd < 0 || connect(c->fd, res->ai_addr, res->ai_addrlen) != 0)
+    {
+        fprintf(stderr, "Falha ao conectar em %s:%s: %s\n", host, port, strerror(errno));
+        freeaddrinfo(res);
+        return false;
+    }
+    freeaddrinfo(res);
+    int one = 1;
+    setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Sem Nagle: a latência é o que se mede
+    c->rx_len = 0;
+
+    uint8_t body[16 + 3 * MAX_TOPIC];
+    size_t n = put_str(body, "MQTT", 4);
+    body[n++] = 4;                                                    // Versão 3.1.1
+    body[n++] = 0x02 | (username ? 0x80 : 0) | (password ? 0x40 : 0); // Sessão limpa, usuário e senha
+    body[n++] = 0; // Sem keep-alive: o broker não derruba uma conexão só de escuta
+    body[n++] = 0;
+    n += put_str(&body[n], client_id, strlen(client_id));
+    if (username)
+    {
+        n += put_str(&body[n], username, strlen(username));
+    }
+    if (password)
+    {
+        n += put_str(&body[n], password, strlen(password));
+    }
+    if (!send_packet(c->fd, 0x10, body, n))
+    {
+        return false;
+    }
+
+    uint8_t ack[4];
+    if (recv(c->fd, ack, sizeof(ack), MSG_WAITALL) != sizeof(ack) || ack[0] != 0x20 || ack[3] != 0)
+    {
+        fprintf(stderr, "Broker recusou a conexao\n");
+        return false;
+    }
+    return true;
+}
+
+// Lê o que houver no socket e chama on_publish para cada PUBLISH completo. Retorna false se fechou.
+static bool mqtt_poll(conn_t *c, void (*on_publish)(const char *topic, const char *payload, size_t len))
+{
+    ssize_t n = recv(c->fd, &c->rx[c->rx_len], sizeof(c->rx) - c->rx_len, MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+    {
+        return false;
+    }
+    c->rx_len += n > 0 ? n : 0;
+
+    size_t pos = 0;
+    for (;;)
+    {
+        size_t len = 0, mul = 1, h = 1;
+        while (pos + h < c->rx_len && h < 5)
+        {
+            uint8_t b = c->rx[pos + h++];
+            len += (b & 0x7F) * mul;
+            mul *= 128;
+            if (!(b & 0x80))
+            {
+                mul = 0;
+                break;
+            }
+        }
+        if (mul != 0 || pos + h + len > c->rx_len)
+        {
+            break; // Pacote incompleto
+        }
+        const uint8_t *p = &c->rx[pos + h];
+        if ((c->rx[pos] & 0xF0) == 0x30 && len >= 2)
+        {
+            size_t tlen = (p[0] << 8) | p[1];
+            size_t skip = 2 + tlen + ((c->rx[pos] & 0x06) ? 2 : 0); // Identificador só com QoS > 0
+            if (tlen < MAX_TOPIC && skip <= len)
+            {
+                char topic[MAX_TOPIC];
+                char payload[MAX_PAYLOAD];
+                size_t plen = len - skip < MAX_PAYLOAD - 1 ? len - skip : MAX_PAYLOAD - 1;
+                memcpy(topic, &p[2], tlen);
+                topic[tlen] = '\0';
+                memcpy(payload, &p[skip], plen);
+                payload[plen] = '\0';
+                on_publish(topic, payload, plen);
+            }
+        }
+        pos += h + len;
+    }
+    memmove(c->rx, &c->rx[pos], c->rx_len - pos);
+    c->rx_len -= pos;
+    if (c->rx_len == sizeof(c->rx))
+    {
+        c->rx_len = 0; // Pacote maior que o buffer: descarta
+    }
+    return true;
+}
+
+// Tópico sem o prefixo do dispositivo, ou NULL se for de outro
+static const char *strip_prefix(const char *topic)
+{
+    size_t n = strlen(prefix);
+    return strncmp(topic, prefix, n) == 0 ? topic + n : NULL;
+}
+
+static bool is_command(const char *t)
+{
+    return strncmp(t, "/pwm", 4) == 0 || strncmp(t, "/spwm", 5) == 0;
+}
+
+// run ===============================
+static cmd_t *cmds;
+static size_t n_cmds;
+static size_t oldest;           // Primeiro comando ainda pendente
+static uint32_t *lat_us;        // Latências de ponta a ponta dos comandos ecoados
+static uint32_t *handler_us;    // Tempo de tratamento informado pela placa
+static size_t n_lat;
+static size_t late;              // Ecos sem comando pendente (chegaram depois da espera)
+static uint32_t wait_us;
+
+// Marca como perdidos os comandos pendentes há mais que a espera; enviados em ordem, então
+// basta avançar a partir do mais antigo
+static void expire_pending(uint64_t t)
+{
+    for (size_t i = oldest; i < n_cmds && cmds[i].sent_us && t - cmds[i].sent_us > wait_us; i++)
+    {
+        cmds[i].done = true;
+    }
+    while (oldest < n_cmds && cmds[oldest].done)
+    {
+        oldest++;
+    }
+}
+
+static void on_applied(const char *topic, const char *payload, size_t len)
+{
+    (void)len;
+    uint64_t t = now_us();
+    const char *t_basic = strip_prefix(topic);
+    char cmd_topic[MAX_TOPIC];
+    char cmd_payload[MAX_PAYLOAD];
+    unsigned long us;
+    if (!t_basic || strcmp(t_basic, "/applied") != 0 ||
+        sscanf(payload, "%63s %63s %lu", cmd_topic, cmd_payload, &us) != 3)
+    {
+        return;
+    }
+    expire_pending(t);
+    size_t i = oldest;
+    for (; i < n_cmds && cmds[i].sent_us; i++)
+    {
+        cmd_t *c = &cmds[i];
+        if (!c->done && strcmp(c->topic, cmd_topic) == 0 && strcmp(c->payload, cmd_payload) == 0)
+        {
+            c->done = true;
+            lat_us[n_lat] = (uint32_t)(t - c->sent_us);
+            handler_us[n_lat++] = (uint32_t)us;
+            break;
+        }
+    }
+    if (i == n_cmds || !cmds[i].sent_us)
+    {
+        late++;
+    }
+    while (oldest < n_cmds && cmds[oldest].done)
+    {
+        oldest++;
+    }
+}
+
+static bool load_trace(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        fprintf(stderr, "Nao abriu %s\n", path);
+        return false;
+    }
+    char line[256];
+    size_t cap = 0;
+    while (fgets(line, sizeof(line), f))
+    {
+        unsigned long t;
+        char topic[MAX_TOPIC], payload[MAX_PAYLOAD];
+        if (line[0] == '#' || sscanf(line, "%lu %63s %63s", &t, topic, payload) != 3)
+        {
+            continue;
+        }
+        if (n_cmds == cap)
+        {
+            cap = cap ? cap * 2 : 1024;
+            cmds = realloc(cmds, cap * sizeof(cmd_t));
+        }
+        cmds[n_cmds] = (cmd_t){.t_ms = t};
+        strcpy(cmds[n_cmds].topic, topic);
+        strcpy(cmds[n_cmds].payload, payload);
+        n_cmds++;
+    }
+    fclose(f);
+    return n_cmds > 0;
+}
+
+// Duty em rodízio pelos canais; o mesmo par tópico/mensagem só se repete a cada 303 comandos
+static void synth_trace(size_t n, double rate, bool spwm)
+{
+    static const char ch[] = {'g', 'b', 'r'};
+    cmds = calloc(n, sizeof(cmd_t));
+    n_cmds = n;
+    for (size_t i = 0; i < n; i++)
+    {
+        cmd_t *c = &cmds[i];
+        c->t_ms = (uint32_t)(i * 1000.0 / rate);
+        if (spwm && i % 16 == 15)
+        {
+            // Mesma frequência de sempre (div 10, wrap 1000 a 125 MHz), alternando o wrap em 1
+            snprintf(c->topic, sizeof(c->topic), "/spwm%c", ch[i % 3]);
+            snprintf(c->payload, sizeof(c->payload), "10,%u", 1000 + (unsigned)(i / 16 % 2));
+        }
+        else
+        {
+            snprintf(c->topic, sizeof(c->topic), "/pwm%c", ch[i % 3]);
+            snprintf(c->payload, sizeof(c->payload), "%u", (unsigned)(i / 3 % 101));
+        }
+    }
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t percentile(const uint32_t *v, size_t n, uint32_t permille)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+    size_t i = ((uint64_t)n * permille + 999) / 1000;
+    return v[i ? i - 1 : 0];
+}
+
+static void report(const char *name, uint32_t *v, size_t n)
+{
+    qsort(v, n, sizeof(uint32_t), cmp_u32);
+    printf("%-12s p50 %8.3f ms  p99 %8.3f ms  p999 %8.3f ms  max %8.3f ms\n", name, percentile(v, n, 500) / 1000.0,
+           percentile(v, n, 990) / 1000.0, percentile(v, n, 999) / 1000.0, n ? v[n - 1] / 1000.0 : 0.0);
+}
+
+static int run(int argc, char **argv)
+{
+    double rate = 100, speed = 1;
+    size_t n = 1000;
+    int n_conns = 1;
+    const char *trace = NULL;
+    bool spwm = false;
+    wait_us = 2000000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:u:k:P:r:c:n:f:s:w:S")) != -1)
+    {
+        switch (opt)
+        {
+        case 'h': host = optarg; break;
+        case 'p': port = optarg; break;
+        case 'u': username = optarg; break;
+        case 'k': password = optarg; break;
+        case 'P': prefix = optarg; break;
+        case 'r': rate = atof(optarg); break;
+        case 'c': n_conns = atoi(optarg); break;
+        case 'n': n = strtoul(optarg, NULL, 10); break;
+        case 'f': trace = optarg; break;
+        case 's': speed = atof(optarg); break;
+        case 'w': wait_us = strtoul(optarg, NULL, 10) * 1000; break;
+        case 'S': spwm = true; break;
+        default: return 2;
+        }
+    }
+    if (rate <= 0 || speed <= 0 || n_conns < 1 || n_conns > MAX_CONNS || n == 0)
+    {
+        fprintf(stderr, "Parametros invalidos\n");
+        return 2;
+    }
+    if (trace ? !load_trace(trace) : (synth_trace(n, rate, spwm), false))
+    {
+        return 1;
+    }
+    lat_us = calloc(n_cmds, sizeof(uint32_t));
+    handler_us = calloc(n_cmds, sizeof(uint32_t));
+
+    // Uma conexão só escuta o eco; as demais publicam
+    static conn_t rx, tx[MAX_CONNS];
+    char id[32], topic[2 * MAX_TOPIC];
+    snprintf(id, sizeof(id), "mqtt_load_rx_%d", (int)getpid());
+    snprintf(topic, sizeof(topic), "%s/applied", prefix);
+    if (!mqtt_connect(&rx, id) || !mqtt_subscribe(&rx, topic))
+    {
+        return 1;
+    }
+    for (int i = 0; i < n_conns; i++)
+    {
+        snprintf(id, sizeof(id), "mqtt_load_tx%d_%d", i, (int)getpid());
+        if (!mqtt_connect(&tx[i], id))
+        {
+            return 1;
+        }
+    }
+    snprintf(topic, sizeof(topic), "%s/trace", prefix);
+    mqtt_publish(&tx[0], topic, "on", 2);
+    usleep(200000); // SUBACK e /trace on chegam antes do primeiro comando
+
+    uint64_t start = now_us();
+    uint64_t last_sent = start;
+    size_t next = 0;
+    while (next < n_cmds || (oldest < n_cmds && now_us() - last_sent < wait_us))
+    {
+        uint64_t t = now_us();
+        while (next < n_cmds && t >= start + (uint64_t)(cmds[next].t_ms * 1000.0 / speed))
+        {
+            cmd_t *c = &cmds[next];
+            snprintf(topic, sizeof(topic), "%s%s", prefix, c->topic);
+            c->sent_us = now_us();
+            if (!mqtt_publish(&tx[next % n_conns], topic, c->payload, strlen(c->payload)))
+            {
+                fprintf(stderr, "Conexao %zu caiu\n", next % n_conns);
+                return 1;
+            }
+            last_sent = c->sent_us;
+            next++;
+        }
+
+        int timeout_ms = 1;
+        if (next < n_cmds)
+        {
+            int64_t due = (int64_t)(start + (uint64_t)(cmds[next].t_ms * 1000.0 / speed)) - (int64_t)now_us();
+            timeout_ms = due > 1000 ? (int)(due / 1000) : 0;
+        }
+        struct pollfd pfd = {.fd = rx.fd, .events = POLLIN};
+        if (poll(&pfd, 1, timeout_ms) > 0 && !mqtt_poll(&rx, on_applied))
+        {
+            fprintf(stderr, "Conexao de escuta caiu\n");
+            return 1;
+        }
+    }
+    double elapsed = (last_sent - start) / 1e6;
+
+    snprintf(topic, sizeof(topic), "%s/trace", prefix);
+    mqtt_publish(&tx[0], topic, "off", 3);
+
+    size_t dropped = n_cmds - n_lat;
+    printf("comandos %zu em %.2f s (%.1f/s, %d conexoes), ecoados %zu, perdidos %zu (%.2f%%), ecos atrasados %zu\n", n_cmds,
+           elapsed, elapsed > 0 ? n_cmds / elapsed : 0.0, n_conns, n_lat, dropped, 100.0 * dropped / n_cmds, late);
+    report("ponta a ponta", lat_us, n_lat);
+    report("tratamento", handler_us, n_lat);
+    return 0;
+}
+
+// sim ===============================
+static conn_t sim_conn;
+static uint32_t sim_delay_us;
+static unsigned long sim_count;
+
+static void on_sim_command(const char *topic, const char *payload, size_t len)
+{
+    (void)len;
+    uint64_t rx = now_us();
+    const char *t = strip_prefix(topic);
+    unsigned a, b;
+    if (!t)
+    {
+        return;
+    }
+    if (strcmp(t, "/trace") != 0 && !is_command(t))
+    {
+        return; // Inclui o próprio /applied
+    }
+    // Mesmas validações da placa; mensagens inválidas também são ecoadas, como lá
+    if (is_command(t) &&
+        (strncmp(t, "/spwm", 5) == 0 ? sscanf(payload, "%u,%u", &a, &b) != 2 : sscanf(payload, "%u", &a) != 1))
+    {
+        fprintf(stderr, "Formato invalido em %s: %s\n", t, payload);
+    }
+    while (now_us() - rx < sim_delay_us)
+    {
+    }
+
+    char echo[2 * MAX_PAYLOAD + 32], applied[2 * MAX_TOPIC];
+    int n = snprintf(echo, sizeof(echo), "%s %s %lu", t, payload, (unsigned long)(now_us() - rx));
+    snprintf(applied, sizeof(applied), "%s/applied", prefix);
+    mqtt_publish(&sim_conn, applied, echo, n);
+    sim_count++;
+}
+
+static int sim(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:u:k:P:d:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'h': host = optarg; break;
+        case 'p': port = optarg; break;
+        case 'u': username = optarg; break;
+        case 'k': password = optarg; break;
+        case 'P': prefix = optarg; break;
+        case 'd': sim_delay_us = strtoul(optarg, NULL, 10); break;
+        default: return 2;
+        }
+    }
+    char filter[2 * MAX_TOPIC];
+    snprintf(filter, sizeof(filter), "%s/#", prefix);
+    if (!mqtt_connect(&sim_conn, "mqtt_load_sim") || !mqtt_subscribe(&sim_conn, filter))
+    {
+        return 1;
+    }
+    fprintf(stderr, "Firmware simulado em %s:%s, prefixo \"%s\", %u us por comando\n", host, port, prefix, sim_delay_us);
+    for (;;)
+    {
+        struct pollfd pfd = {.fd = sim_conn.fd, .events = POLLIN};
+        if (poll(&pfd, 1, 1000) > 0 && !mqtt_poll(&sim_conn, on_sim_command))
+        {
+            fprintf(stderr, "Conexao caiu depois de %lu comandos\n", sim_count);
+            return 1;
+        }
+    }
+}
+
+// record ===============================
+static uint64_t rec_start;
+
+static void on_record(const char *topic, const char *payload, size_t len)
+{
+    const char *t = strip_prefix(topic);
+    if (!t || !is_command(t) || strchr(payload, ' ') || len == 0)
+    {
+        return;
+    }
+    uint64_t now = now_us();
+    rec_start = rec_start ? rec_start : now;
+    printf("%lu %s %s\n", (unsigned long)((now - rec_start) / 1000), t, payload);
+    fflush(stdout);
+}
+
+static int record(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:u:k:P:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'h': host = optarg; break;
+        case 'p': port = optarg; break;
+        case 'u': username = optarg; break;
+        case 'k': password = optarg; break;
+        case 'P': prefix = optarg; break;
+        default: return 2;
+        }
+    }
+    static conn_t c;
+    char filter[2 * MAX_TOPIC];
+    snprintf(filter, sizeof(filter), "%s/#", prefix);
+    if (!mqtt_connect(&c, "mqtt_load_record") || !mqtt_subscribe(&c, filter))
+    {
+        return 1;
+    }
+    printf("# ms topico mensagem\n");
+    for (;;)
+    {
+        struct pollfd pfd = {.fd = c.fd, .events = POLLIN};
+        if (poll(&pfd, 1, 1000) > 0 && !mqtt_poll(&c, on_record))
+        {
+            return 1;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Uso: %s run|sim|record [opcoes]\n", argv[0]);
+        return 2;
+    }
+    if (strcmp(argv[1], "run") == 0)
+    {
+        return run(argc - 1, argv + 1);
+    }
+    if (strcmp(argv[1], "sim") == 0)
+    {
+        return sim(argc - 1, argv + 1);
+    }
+    if (strcmp(argv[1], "record") == 0)
+    {
+        return record(argc - 1, argv + 1);
+    }
+    fprintf(stderr, "Modo desconhecido: %s\n", argv[1]);
+    return 2;
+}
@@ -0,0 +1,148 @@
+// Simulação no host do núcleo do PID (lib/pid_ctrl.c) contra um modelo da planta.
+// A planta é de primeira ordem (LED e fotodiodo com filtro RC, por exemplo): a medição tende a
+// ganho*saída + offset com constante de tempo tau, e chega ao PID quantizada em 12 bits como
+// no ADC. Confere:
+//   - integração exata: com Kp = Kd = 0 e erro constante, a saída é a integral exata de Ki*erro,
+//     sem perder a fração de cada passo a 10 kHz;
+//   - regime: com ganhos normais e com um Ki muito pequeno, o erro final fica em 1 LSB;
+//   - anti-windup: depois de um setpoint inalcançável, um setpoint alcançável é atingido logo;
+//   - troca de frequência: pid_ctrl_set_rate não muda a saída.
+// Para comparação, mostra o erro final do integrador antigo, que dividia Ki*erro pela
+// frequência a cada passo e descartava o resto.
+//
+// Compilar e rodar: gcc -O2 -Ilib -o pid_sim tools/pid_sim.c lib/pid_ctrl.c -lm && ./pid_sim
+// Retorna 1 se alguma verificação falhar.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "pid_ctrl.h"
+
+#define RATE_HZ 10000
+
+typedef struct
+{
+    double gain;   // Medição em regime por unidade da saída
+    double offset; // Medição com a saída zerada (luz ambiente)
+    double tau_s;
+    double y;
+} plant_t;
+
+static uint32_t failures;
+
+static int32_t plant_measure(const plant_t *pl)
+{
+    long y = lround(pl->y);
+    return y < 0 ? 0 : y > PID_FULL_SCALE ? PID_FULL_SCALE : (int32_t)y;
+}
+
+static void plant_step(plant_t *pl, int32_t out, uint32_t rate_hz)
+{
+    pl->y += (pl->gain * out + pl->offset - pl->y) / (pl->tau_s * rate_hz);
+}
+
+// Roda o laço por seconds; retorna o erro na última medição
+static int32_t run(pid_ctrl_t *pid, plant_t *pl, int32_t setpoint, double seconds, int32_t *peak)
+{
+    uint32_t steps = (uint32_t)(seconds * pid->rate_hz);
+    int32_t y = plant_measure(pl);
+    for (uint32_t i = 0; i < steps; i++)
+    {
+        plant_step(pl, pid_ctrl_step(pid, setpoint, y), pid->rate_hz);
+        y = plant_measure(pl);
+        if (peak && y > *peak)
+        {
+            *peak = y;
+        }
+    }
+    return setpoint - y;
+}
+
+// Integrador antigo, só com Ki: a fração de Ki*erro/frequência se perdia em cada passo
+static int32_t run_old(int32_t ki, plant_t *pl, int32_t setpoint, double seconds)
+{
+    int64_t integ = 0, max_q = (int64_t)PID_FULL_SCALE << PID_Q;
+    uint32_t steps = (uint32_t)(seconds * RATE_HZ);
+    int32_t y = plant_measure(pl);
+    for (uint32_t i = 0; i < steps; i++)
+    {
+        integ += ((int64_t)ki * (setpoint - y)) / RATE_HZ;
+        integ = integ < 0 ? 0 : integ > max_q ? max_q : integ;
+        plant_step(pl, (int32_t)(integ >> PID_Q), RATE_HZ);
+        y = plant_measure(pl);
+    }
+    return setpoint - y;
+}
+
+static void expect(bool ok, const char *what)
+{
+    printf("  %-60s %s\n", what, ok ? "ok" : "FALHA");
+    failures += !ok;
+}
+
+int main(void)
+{
+    pid_ctrl_t pid;
+    char line[96];
+
+    // Integração exata: erro 3 por 10 s com Ki = 0,1/s; o integrador antigo somava 1 por passo
+    // em vez de 1,97, perdendo quase metade
+    printf("integracao (Ki 0,1/s, erro 3, %u Hz):\n", RATE_HZ);
+    pid_ctrl_init(&pid, 0, PID_GAIN(0.1), 0, 0, PID_FULL_SCALE, RATE_HZ);
+    int32_t out = 0;
+    uint32_t steps = 10 * RATE_HZ;
+    for (uint32_t i = 0; i < steps; i++)
+    {
+        out = pid_ctrl_step(&pid, 3, 0);
+    }
+    int32_t exact = (int32_t)(((int64_t)PID_GAIN(0.1) * 3 * steps / RATE_HZ) >> PID_Q);
+    int32_t old = (int32_t)((((int64_t)PID_GAIN(0.1) * 3 / RATE_HZ) * steps) >> PID_Q);
+    snprintf(line, sizeof(line), "saida %ld, exata %ld (antigo: %ld)", (long)out, (long)exact, (long)old);
+    expect(out == exact, line);
+
+    // Ganhos normais: resposta ao degrau
+    printf("degrau (Kp 0,5, Ki 20/s, planta 0,8 + 100, tau 20 ms):\n");
+    plant_t pl = {.gain = 0.8, .offset = 100, .tau_s = 0.02, .y = 100};
+    int32_t peak = 0;
+    pid_ctrl_init(&pid, PID_GAIN(0.5), PID_GAIN(20), 0, 0, PID_FULL_SCALE, RATE_HZ);
+    int32_t err = run(&pid, &pl, 2000, 2.0, &peak);
+    snprintf(line, sizeof(line), "erro final %ld LSB, pico %ld", (long)err, (long)peak);
+    expect(labs(err) <= 1, line);
+
+    // Troca de frequência com o laço em regime
+    int32_t before = pid_ctrl_step(&pid, 2000, plant_measure(&pl));
+    pid.primed = 0;
+    pid_ctrl_set_rate(&pid, 1000);
+    int32_t after = pid_ctrl_step(&pid, 2000, plant_measure(&pl));
+    snprintf(line, sizeof(line), "saida antes e depois de 10 kHz -> 1 kHz: %ld, %ld", (long)before, (long)after);
+    expect(labs(before - after) <= 1, line);
+    pid_ctrl_set_rate(&pid, RATE_HZ);
+
+    // Anti-windup: 3 s pedindo mais do que a planta alcança (0,8*4095 + 100 = 3376), depois 1000.
+    // Sem ele o integrador acumularia mais de 9 vezes a escala e levaria segundos para voltar.
+    printf("anti-windup (setpoint 4000 por 3 s, depois 1000):\n");
+    run(&pid, &pl, 4000, 3.0, NULL);
+    double t = 0;
+    for (; t < 1.0 && labs(1000 - plant_measure(&pl)) > 20; t += 0.001)
+    {
+        run(&pid, &pl, 1000, 0.001, NULL);
+    }
+    snprintf(line, sizeof(line), "chegou a 20 LSB de 1000 em %.0f ms", t * 1000);
+    expect(t < 0.5 && pid.integ <= ((int64_t)PID_FULL_SCALE << PID_Q) * RATE_HZ, line);
+
+    // Ki muito pequeno (constante de tempo do laço de cerca de um minuto): o integrador antigo
+    // parava de acumular com erro abaixo de frequência/Ki (Ki em Q16) = 7,6 LSB
+    printf("Ki 0,02/s sem Kp, 600 s:\n");
+    plant_t slow = {.gain = 0.8, .offset = 100, .tau_s = 0.02, .y = 100};
+    plant_t slow_old = slow;
+    pid_ctrl_init(&pid, 0, PID_GAIN(0.02), 0, 0, PID_FULL_SCALE, RATE_HZ);
+    err = run(&pid, &slow, 2000, 600.0, NULL);
+    int32_t err_old = run_old(PID_GAIN(0.02), &slow_old, 2000, 600.0);
+    snprintf(line, sizeof(line), "erro final %ld LSB (antigo: %ld LSB)", (long)err, (long)err_old);
+    expect(labs(err) <= 1, line);
+
+    printf("%s\n", failures ? "FALHOU" : "OK");
+    return failures ? 1 : 0;
+}
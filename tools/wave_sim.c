@@ -0,0 +1,153 @@
+// Simulação no host da reprodução de formas de onda (lib/pwm_wave.c).
+// Gera as tabelas com lib/wave_table.c, monta as palavras do registrador CC como o aparelho
+// (pwm_wave_cc_word e pwm_wave_sample_level) e simula o tempo em 1/16 de ciclo de clk_sys:
+// cada pedido do temporizador de amostras (ou o fim de período do próprio slice, na taxa 0)
+// escreve uma palavra no CC, que só vale a partir do próximo fim de período do PWM. Confere:
+//   - formato: nível dentro do TOP, 1000 = TOP, metade do outro canal preservada;
+//   - ritmo: nenhuma amostra perdida (duas escritas no mesmo período PWM) nas configurações
+//     aceitas por pwm_calc_pacer_fits, e erro da taxa real em relação à pedida.
+// Por fim varre frequências de PWM e conta quantas vezes a regra antiga (taxa em Hz <= frequência
+// em Hz) aceitaria um temporizador mais rápido que o PWM, que perde amostras.
+//
+// Compilar e rodar: gcc -O2 -Ilib -o wave_sim tools/wave_sim.c lib/wave_table.c lib/pwm_calc.c -lm && ./wave_sim [clk_hz]
+// Retorna 1 se alguma verificação falhar.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "pwm_calc.h"
+#include "pwm_wave.h"
+#include "wave_table.h"
+
+// Escritas simuladas em cada caso: com taxas a poucos ppm do PWM, a perda só aparece depois de
+// centenas de milhares de períodos
+#define WRITES (1u << 20)
+
+static uint32_t failures;
+
+// Palavras CC da tabela, como em pwm_wave_start, e conferência do formato
+static bool build_words(const uint16_t *table, uint32_t n, uint16_t top, uint32_t chan, uint32_t *words)
+{
+    const uint16_t sibling = 0x1234;
+    uint32_t cc = chan ? sibling : (uint32_t)sibling << 16;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint16_t level = pwm_wave_sample_level(table[i], top);
+        words[i] = pwm_wave_cc_word(cc, chan, level);
+        uint16_t mine = chan ? words[i] >> 16 : words[i] & 0xFFFF;
+        uint16_t other = chan ? words[i] & 0xFFFF : words[i] >> 16;
+        if (table[i] > PWM_WAVE_FULL_SCALE || mine != level || level > top || other != sibling ||
+            (table[i] == PWM_WAVE_FULL_SCALE && level != top))
+        {
+            printf("  formato: amostra %u -> palavra 0x%08x com TOP %u\n", table[i], words[i], top);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Escritas espaçadas de pacer16 a partir de phase16; cada uma vale no próximo fim de período.
+// Retorna as amostras perdidas (sobrescritas antes de aparecer na saída).
+static uint32_t simulate(uint64_t pwm16, uint64_t pacer16, uint64_t phase16, uint32_t writes)
+{
+    uint32_t lost = 0;
+    uint64_t last_wrap = UINT64_MAX;
+    for (uint32_t j = 0; j < writes; j++)
+    {
+        uint64_t t = phase16 + j * pacer16;
+        uint64_t wrap = t / pwm16 + 1;
+        lost += wrap == last_wrap;
+        last_wrap = wrap;
+    }
+    return lost;
+}
+
+static void check(uint32_t clk, uint32_t pwm_hz, uint32_t rate_hz, const uint16_t *table, uint32_t n)
+{
+    pwm_timing_t pwm, pacer;
+    uint32_t words[PWM_WAVE_MAX_SAMPLES];
+    if (!pwm_calc_solve(clk, pwm_hz, &pwm))
+    {
+        return;
+    }
+    for (uint32_t chan = 0; chan < 2; chan++)
+    {
+        if (!build_words(table, n, pwm.top, chan, words))
+        {
+            failures++;
+        }
+    }
+
+    uint64_t pwm16 = pwm_calc_period16(&pwm);
+    if (rate_hz == 0)
+    {
+        return; // Uma escrita por período, pedida pelo próprio fim de período: nada a perder
+    }
+    bool solved = pwm_calc_solve(clk, rate_hz, &pacer);
+    bool accepted = solved && pwm_calc_pacer_fits(&pacer, &pwm);
+
+    // Fases diferentes entre o temporizador e o PWM, que não são sincronizados
+    uint32_t lost = 0;
+    for (uint32_t k = 0; k < 8 && solved; k++)
+    {
+        lost += simulate(pwm16, pwm_calc_period16(&pacer), pwm16 * k / 8, WRITES);
+    }
+    if (accepted && lost)
+    {
+        printf("  FALHA: pwm %lu Hz, taxa %lu Hz aceita com %lu amostras perdidas\n", (unsigned long)pwm_hz,
+               (unsigned long)rate_hz, (unsigned long)lost);
+        failures++;
+    }
+    if (accepted)
+    {
+        double real = (double)clk * 16 / pwm_calc_period16(&pacer);
+        printf("  pwm %7lu Hz  taxa %7lu Hz -> %12.3f Hz (%+8.1f ppm)\n", (unsigned long)pwm_hz, (unsigned long)rate_hz, real,
+               (real - rate_hz) / rate_hz * 1e6);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t clk = argc > 1 ? strtoul(argv[1], NULL, 10) : 125000000;
+    static const uint32_t pwm_freqs[] = {50, 1000, 9999, 20000, 61035};
+    uint16_t sine[PWM_WAVE_MAX_SAMPLES], trap[PWM_WAVE_MAX_SAMPLES];
+    uint32_t old_lossy = 0;
+
+    // Extremos da tabela e tamanhos máximo e mínimo
+    if (!wave_table_sine(sine, PWM_WAVE_MAX_SAMPLES, 0, PWM_WAVE_FULL_SCALE) ||
+        !wave_table_trapezoid(trap, 4, 0, PWM_WAVE_FULL_SCALE) || sine[0] != 500 ||
+        sine[PWM_WAVE_MAX_SAMPLES / 4] != PWM_WAVE_FULL_SCALE || trap[1] != PWM_WAVE_FULL_SCALE || trap[3] != 0)
+    {
+        printf("FALHA: tabelas geradas\n");
+        failures++;
+    }
+
+    printf("clk_sys %lu Hz\n", (unsigned long)clk);
+    for (uint32_t i = 0; i < sizeof(pwm_freqs) / sizeof(pwm_freqs[0]); i++)
+    {
+        uint32_t f = pwm_freqs[i];
+        const uint32_t rates[] = {0, 1, f / 10, f / 2, f - 1, f, f + 1};
+        for (uint32_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+        {
+            check(clk, f, rates[r], r % 2 ? trap : sine, r % 2 ? 4 : PWM_WAVE_MAX_SAMPLES);
+        }
+    }
+
+    // Taxa igual à frequência em Hz do PWM: a regra antiga sempre aceitava
+    uint32_t swept = 0;
+    for (uint32_t f = 10; f <= 200000; f += 7)
+    {
+        pwm_timing_t pwm, pacer;
+        uint32_t rate = pwm_calc_solve(clk, f, &pwm) ? pwm_calc_freq(clk, &pwm) : 0;
+        if (rate && pwm_calc_solve(clk, rate, &pacer))
+        {
+            swept++;
+            old_lossy += !pwm_calc_pacer_fits(&pacer, &pwm);
+        }
+    }
+    printf("regra antiga: %lu de %lu frequencias de PWM aceitariam um temporizador mais rapido (com perdas)\n",
+           (unsigned long)old_lossy, (unsigned long)swept);
+    printf("%s\n", failures ? "FALHOU" : "OK");
+    return failures ? 1 : 0;
+}